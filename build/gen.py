@@ -755,6 +755,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
               'src/gn/bundle_data_target_generator.cc',
               'src/gn/bundle_file_rule.cc',
               'src/gn/builtin_tool.cc',
+              'src/gn/bytecode.cc',
               'src/gn/c_include_iterator.cc',
               'src/gn/c_substitution_type.cc',
               'src/gn/c_tool.cc',
@@ -771,12 +772,14 @@ def WriteGNNinja(path, platform, host, options, args_list):
               'src/gn/command_meta.cc',
               'src/gn/command_outputs.cc',
               'src/gn/command_path.cc',
+              'src/gn/command_query.cc',
               'src/gn/command_refs.cc',
               'src/gn/command_suggest.cc',
               'src/gn/commands.cc',
               'src/gn/compile_commands_writer.cc',
               'src/gn/rust_project_writer.cc',
               'src/gn/config.cc',
+              'src/gn/config_flags_cache.cc',
               'src/gn/config_values.cc',
               'src/gn/config_values_extractors.cc',
               'src/gn/config_values_generator.cc',
@@ -795,6 +798,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
               'src/gn/ffi/value.cc',
               'src/gn/ffi/session.cc',
               'src/gn/filesystem_utils.cc',
+              'src/gn/file_write_batch.cc',
               'src/gn/file_writer.cc',
               'src/gn/frameworks_utils.cc',
               'src/gn/function_exec_script.cc',
@@ -819,19 +823,24 @@ def WriteGNNinja(path, platform, host, options, args_list):
               'src/gn/function_write_file.cc',
               'src/gn/functions.cc',
               'src/gn/functions_target.cc',
+              'src/gn/gen_fingerprint.cc',
               'src/gn/general_tool.cc',
               'src/gn/generated_file_target_generator.cc',
+              'src/gn/graph_snapshot.cc',
               'src/gn/group_target_generator.cc',
               'src/gn/header_checker.cc',
               'src/gn/import_manager.cc',
               'src/gn/input_conversion.cc',
               'src/gn/input_file.cc',
               'src/gn/input_file_manager.cc',
+              'src/gn/input_summary.cc',
               'src/gn/invoke_python.cc',
               'src/gn/item.cc',
               'src/gn/json_project_writer.cc',
               'src/gn/label.cc',
               'src/gn/label_pattern.cc',
+              'src/gn/label_pattern_set.cc',
+              'src/gn/lazy_import.cc',
               'src/gn/lib_file.cc',
               'src/gn/loader.cc',
               'src/gn/location.cc',
@@ -854,10 +863,14 @@ def WriteGNNinja(path, platform, host, options, args_list):
               'src/gn/ninja_toolchain_writer.cc',
               'src/gn/ninja_tools.cc',
               'src/gn/ninja_utils.cc',
+              'src/gn/ninja_variable_bundles.cc',
               'src/gn/ninja_writer.cc',
               'src/gn/operators.cc',
               'src/gn/output_conversion.cc',
               'src/gn/output_file.cc',
+              'src/gn/output_hash_manifest.cc',
+              'src/gn/output_manifest.cc',
+              'src/gn/parallel_for.cc',
               'src/gn/parse_node_value_adapter.cc',
               'src/gn/parse_tree.cc',
               'src/gn/parser.cc',
@@ -892,6 +905,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
               'src/gn/switches.cc',
               'src/gn/target.cc',
               'src/gn/target_generator.cc',
+              'src/gn/target_graph_index.cc',
               'src/gn/template.cc',
               'src/gn/token.cc',
               'src/gn/tokenizer.cc',
@@ -932,11 +946,15 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/builder_unittest.cc',
         'src/gn/binary_target_generator_unittest.cc',
         'src/gn/bundle_data_unittest.cc',
+        'src/gn/bytecode_unittest.cc',
         'src/gn/c_include_iterator_unittest.cc',
+        'src/gn/command_gen_unittest.cc',
         'src/gn/command_format_unittest.cc',
+        'src/gn/command_query_unittest.cc',
         'src/gn/command_suggest_unittest.cc',
         'src/gn/commands_unittest.cc',
         'src/gn/compile_commands_writer_unittest.cc',
+        'src/gn/config_flags_cache_unittest.cc',
         'src/gn/config_unittest.cc',
         'src/gn/config_values_extractors_unittest.cc',
         'src/gn/desc_builder_unittest.cc',
@@ -944,6 +962,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/escape_unittest.cc',
         'src/gn/exec_process_unittest.cc',
         'src/gn/filesystem_utils_unittest.cc',
+        'src/gn/file_write_batch_unittest.cc',
         'src/gn/file_writer_unittest.cc',
         'src/gn/frameworks_utils_unittest.cc',
         'src/gn/function_expand_directory_unittest.cc',
@@ -965,14 +984,19 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/functions_target_rust_unittest.cc',
         'src/gn/functions_target_unittest.cc',
         'src/gn/functions_unittest.cc',
+        'src/gn/gen_fingerprint_unittest.cc',
+        'src/gn/graph_snapshot_unittest.cc',
         'src/gn/hash_table_base_unittest.cc',
         'src/gn/header_checker_unittest.cc',
         'src/gn/input_conversion_unittest.cc',
+        'src/gn/input_summary_unittest.cc',
         'src/gn/json_project_writer_unittest.cc',
         'src/gn/rust_project_writer_unittest.cc',
         'src/gn/rust_project_writer_helpers_unittest.cc',
         'src/gn/label_pattern_unittest.cc',
+        'src/gn/label_pattern_set_unittest.cc',
         'src/gn/label_unittest.cc',
+        'src/gn/lazy_import_unittest.cc',
         'src/gn/loader_unittest.cc',
         'src/gn/metadata_unittest.cc',
         'src/gn/metadata_walk_unittest.cc',
@@ -990,8 +1014,14 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/ninja_target_command_util_unittest.cc',
         'src/gn/ninja_target_writer_unittest.cc',
         'src/gn/ninja_toolchain_writer_unittest.cc',
+        'src/gn/ninja_variable_bundles_unittest.cc',
         'src/gn/operators_unittest.cc',
         'src/gn/output_conversion_unittest.cc',
+        'src/gn/output_file_unittest.cc',
+        'src/gn/output_hash_manifest_unittest.cc',
+        'src/gn/output_manifest_unittest.cc',
+        'src/gn/output_sink_unittest.cc',
+        'src/gn/parallel_for_unittest.cc',
         'src/gn/parse_tree_unittest.cc',
         'src/gn/parser_unittest.cc',
         'src/gn/path_output_unittest.cc',
@@ -1012,6 +1042,7 @@ def WriteGNNinja(path, platform, host, options, args_list):
         'src/gn/substitution_pattern_unittest.cc',
         'src/gn/substitution_type_unittest.cc',
         'src/gn/substitution_writer_unittest.cc',
+        'src/gn/target_graph_index_unittest.cc',
         'src/gn/target_public_pair_unittest.cc',
         'src/gn/target_unittest.cc',
         'src/gn/template_unittest.cc',
@@ -7,9 +7,13 @@
 #include <utility>
 
 #include "base/files/file_util.h"
+#include "gn/config_flags_cache.h"
 #include "gn/filesystem_utils.h"
+#include "gn/ninja_variable_bundles.h"
 
-BuildSettings::BuildSettings() = default;
+BuildSettings::BuildSettings()
+    : config_flags_cache_(std::make_unique<ConfigFlagsCache>()),
+      ninja_variable_bundles_(std::make_unique<NinjaVariableBundles>()) {}
 
 BuildSettings::BuildSettings(const BuildSettings& other)
     : dotfile_name_(other.dotfile_name_),
@@ -23,7 +27,13 @@ BuildSettings::BuildSettings(const BuildSettings& other)
       build_config_file_(other.build_config_file_),
       arg_file_template_path_(other.arg_file_template_path_),
       build_dir_(other.build_dir_),
-      build_args_(other.build_args_) {}
+      build_args_(other.build_args_),
+      config_flags_cache_(std::make_unique<ConfigFlagsCache>()),
+      hoist_compiler_vars_(other.hoist_compiler_vars_),
+      ninja_variable_bundles_(std::make_unique<NinjaVariableBundles>()),
+      write_input_summary_(other.write_input_summary_) {}
+
+BuildSettings::~BuildSettings() = default;
 
 void BuildSettings::SetRootTargetLabel(const Label& r) {
   root_target_label_ = r;
@@ -31,6 +41,7 @@ void BuildSettings::SetRootTargetLabel(const Label& r) {
 
 void BuildSettings::SetRootPatterns(std::vector<LabelPattern>&& patterns) {
   root_patterns_ = std::move(patterns);
+  root_pattern_set_ = std::make_shared<LabelPatternSet>(root_patterns_);
 }
 
 void BuildSettings::SetRootPath(const base::FilePath& r) {
@@ -15,12 +15,15 @@
 #include "gn/args.h"
 #include "gn/label.h"
 #include "gn/label_pattern.h"
+#include "gn/label_pattern_set.h"
 #include "gn/scope.h"
 #include "gn/source_dir.h"
 #include "gn/source_file.h"
 #include "gn/version.h"
 
+class ConfigFlagsCache;
 class Item;
+class NinjaVariableBundles;
 
 // Settings for one build, which is one toplevel output directory. There
 // may be multiple Settings objects that refer to this, one for each toolchain.
@@ -31,6 +34,7 @@ class BuildSettings {
 
   BuildSettings();
   BuildSettings(const BuildSettings& other);
+  ~BuildSettings();
 
   // Root target label.
   const Label& root_target_label() const { return root_target_label_; }
@@ -42,6 +46,9 @@ class BuildSettings {
   }
   void SetRootPatterns(std::vector<LabelPattern>&& root_patterns);
 
+  // The root patterns compiled for matching all the targets against them.
+  const LabelPatternSet& root_pattern_set() const { return *root_pattern_set_; }
+
   // Absolute path of the source root on the local system. Everything is
   // relative to this. Does not end in a [back]slash.
   const base::FilePath& root_path() const { return root_path_; }
@@ -153,9 +160,32 @@ class BuildSettings {
     expand_directory_allowlist_ = std::move(list);
   }
 
+  // Flags rendered from configs by the ninja writers (see
+  // config_flags_cache.h). Thread-safe, and not copied with the settings.
+  ConfigFlagsCache* config_flags_cache() const {
+    return config_flags_cache_.get();
+  }
+
+  // When set, the ninja files of binary targets refer to long compiler
+  // variables defined once in the toolchain's ninja file rather than
+  // repeating them (see ninja_variable_bundles.h and --hoist-compiler-vars).
+  bool hoist_compiler_vars() const { return hoist_compiler_vars_; }
+  void set_hoist_compiler_vars(bool hoist) { hoist_compiler_vars_ = hoist; }
+  NinjaVariableBundles* ninja_variable_bundles() const {
+    return ninja_variable_bundles_.get();
+  }
+
+  // When set, the files read to generate the build are listed in an input
+  // summary that gn checks itself rather than in build.ninja.d (see
+  // input_summary.h and --input-summary).
+  bool write_input_summary() const { return write_input_summary_; }
+  void set_write_input_summary(bool write) { write_input_summary_ = write; }
+
  private:
   Label root_target_label_;
   std::vector<LabelPattern> root_patterns_;
+  std::shared_ptr<const LabelPatternSet> root_pattern_set_ =
+      std::make_shared<LabelPatternSet>();
   base::FilePath dotfile_name_;
   base::FilePath root_path_;
   std::string root_path_utf8_;
@@ -179,6 +209,13 @@ class BuildSettings {
   std::unique_ptr<SourceFileSet> expand_directory_allowlist_ =
       std::make_unique<SourceFileSet>();
 
+  std::unique_ptr<ConfigFlagsCache> config_flags_cache_;
+
+  bool hoist_compiler_vars_ = false;
+  std::unique_ptr<NinjaVariableBundles> ninja_variable_bundles_;
+
+  bool write_input_summary_ = false;
+
   BuildSettings& operator=(const BuildSettings&) = delete;
 };
 
@@ -0,0 +1,417 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/bytecode.h"
+
+#include <memory>
+#include <utility>
+
+#include "base/logging.h"
+#include "gn/err.h"
+#include "gn/functions.h"
+#include "gn/operators.h"
+#include "gn/parse_tree.h"
+#include "gn/scope.h"
+#include "gn/token.h"
+
+// BytecodeCompiler ------------------------------------------------------------
+
+class BytecodeCompiler {
+ public:
+  explicit BytecodeCompiler(BytecodeChunk* chunk) : chunk_(chunk) {}
+
+  // Compiles |block| into a new chunk and attaches it to the block.
+  static void CompileBlock(const BlockNode* block);
+
+  // Compiles all blocks contained in |node| (which may be null) that are
+  // executed through BlockNode::Execute.
+  static void CompileNestedBlocks(const ParseNode* node);
+
+  // Appends the statements of |block| to the chunk. The statements execute in
+  // the chunk's scope, as for BlockNode::DISCARDS_RESULT blocks.
+  void CompileStatements(const BlockNode* block);
+
+ private:
+  using Opcode = BytecodeChunk::Opcode;
+
+  void CompileStatement(const ParseNode* node);
+  void CompileCondition(const ConditionNode* node);
+  void CompileExpression(const ParseNode* node);
+  void CompileLiteral(const LiteralNode* node);
+  void CompileFunctionCall(const FunctionCallNode* node);
+
+  // Executes |node| with the tree walker.
+  void CompileFallback(const ParseNode* node);
+
+  // Appends an instruction and returns its index.
+  size_t Emit(Opcode opcode, const ParseNode* node, uint32_t operand = 0);
+
+  // Makes the jump at |index| target the next instruction to be emitted.
+  void PatchJumpToHere(size_t index);
+
+  BytecodeChunk* chunk_;
+};
+
+// static
+void BytecodeCompiler::CompileBlock(const BlockNode* block) {
+  auto chunk = std::make_unique<BytecodeChunk>();
+  BytecodeCompiler compiler(chunk.get());
+  compiler.CompileStatements(block);
+
+  // Attaching is the only mutation done to the tree and it happens before the
+  // tree is shared with other threads.
+  const_cast<BlockNode*>(block)->set_bytecode(std::move(chunk));
+}
+
+// static
+void BytecodeCompiler::CompileNestedBlocks(const ParseNode* node) {
+  if (!node)
+    return;
+  if (const BlockNode* block = node->AsBlock()) {
+    CompileBlock(block);
+  } else if (const AccessorNode* accessor = node->AsAccessor()) {
+    CompileNestedBlocks(accessor->subscript());
+  } else if (const BinaryOpNode* binary = node->AsBinaryOp()) {
+    CompileNestedBlocks(binary->left());
+    CompileNestedBlocks(binary->right());
+  } else if (const ConditionNode* condition = node->AsCondition()) {
+    CompileNestedBlocks(condition->condition());
+    CompileNestedBlocks(condition->if_true());
+    CompileNestedBlocks(condition->if_false());
+  } else if (const FunctionCallNode* call = node->AsFunctionCall()) {
+    CompileNestedBlocks(call->args());
+    CompileNestedBlocks(call->block());
+  } else if (const ListNode* list = node->AsList()) {
+    for (const auto& item : list->contents())
+      CompileNestedBlocks(item.get());
+  } else if (const UnaryOpNode* unary = node->AsUnaryOp()) {
+    CompileNestedBlocks(unary->operand());
+  }
+}
+
+void BytecodeCompiler::CompileStatements(const BlockNode* block) {
+  for (const auto& statement : block->statements())
+    CompileStatement(statement.get());
+}
+
+void BytecodeCompiler::CompileStatement(const ParseNode* node) {
+  // Must match the check in BlockNode::Execute.
+  if (node->AsList() || node->AsLiteral() || node->AsUnaryOp() ||
+      node->AsIdentifier() || node->AsBlock()) {
+    Emit(BytecodeChunk::kNoEffectError, node);
+    return;
+  }
+
+  if (node->AsBlockComment())
+    return;
+
+  if (const ConditionNode* condition = node->AsCondition()) {
+    CompileCondition(condition);
+    return;
+  }
+
+  if (const BinaryOpNode* binary = node->AsBinaryOp()) {
+    Token::Type op = binary->op().type();
+    if ((op == Token::EQUAL || op == Token::PLUS_EQUALS ||
+         op == Token::MINUS_EQUALS) &&
+        binary->left()->AsIdentifier()) {
+      // Assigning to an identifier can't fail before the right-hand side is
+      // evaluated so the right side can be computed first.
+      CompileExpression(binary->right());
+      Emit(BytecodeChunk::kAssign, binary);
+      return;
+    }
+  }
+
+  CompileExpression(node);
+  Emit(BytecodeChunk::kPop, node);
+}
+
+void BytecodeCompiler::CompileCondition(const ConditionNode* node) {
+  CompileExpression(node->condition());
+  size_t condition_jump = Emit(BytecodeChunk::kCondition, node);
+  CompileStatements(node->if_true());
+
+  if (!node->if_false()) {
+    PatchJumpToHere(condition_jump);
+    return;
+  }
+
+  size_t end_jump = Emit(BytecodeChunk::kJump, node);
+  PatchJumpToHere(condition_jump);
+  if (const BlockNode* else_block = node->if_false()->AsBlock())
+    CompileStatements(else_block);
+  else
+    CompileStatement(node->if_false());  // "else if".
+  PatchJumpToHere(end_jump);
+}
+
+void BytecodeCompiler::CompileExpression(const ParseNode* node) {
+  if (const LiteralNode* literal = node->AsLiteral()) {
+    CompileLiteral(literal);
+  } else if (node->AsIdentifier()) {
+    Emit(BytecodeChunk::kLoadIdentifier, node);
+  } else if (const ListNode* list = node->AsList()) {
+    uint32_t count = 0;
+    for (const auto& item : list->contents()) {
+      if (item->AsBlockComment())
+        continue;
+      CompileExpression(item.get());
+      Emit(BytecodeChunk::kCheckListItem, item.get());
+      count++;
+    }
+    Emit(BytecodeChunk::kMakeList, list, count);
+  } else if (const BinaryOpNode* binary = node->AsBinaryOp()) {
+    Token::Type op = binary->op().type();
+    if (op == Token::EQUAL || op == Token::PLUS_EQUALS ||
+        op == Token::MINUS_EQUALS) {
+      CompileFallback(node);
+    } else if (op == Token::BOOLEAN_OR || op == Token::BOOLEAN_AND) {
+      CompileExpression(binary->left());
+      Emit(BytecodeChunk::kCheckOperand, binary, 0);
+      size_t short_circuit = Emit(BytecodeChunk::kShortCircuitLeft, binary);
+      CompileExpression(binary->right());
+      Emit(BytecodeChunk::kCheckOperand, binary, 1);
+      Emit(BytecodeChunk::kShortCircuitRight, binary);
+      PatchJumpToHere(short_circuit);
+    } else {
+      CompileExpression(binary->left());
+      Emit(BytecodeChunk::kCheckOperand, binary, 0);
+      CompileExpression(binary->right());
+      Emit(BytecodeChunk::kCheckOperand, binary, 1);
+      Emit(BytecodeChunk::kBinaryOp, binary);
+    }
+  } else if (const UnaryOpNode* unary = node->AsUnaryOp()) {
+    CompileExpression(unary->operand());
+    Emit(BytecodeChunk::kUnaryOp, unary);
+  } else if (const FunctionCallNode* call = node->AsFunctionCall()) {
+    CompileFunctionCall(call);
+  } else {
+    // Accessors and scope-returning blocks.
+    CompileFallback(node);
+  }
+}
+
+void BytecodeCompiler::CompileLiteral(const LiteralNode* node) {
+  // Strings with "$" need a scope for expansion. Everything else doesn't
+  // depend on the scope and can be computed once. Literals that fail to
+  // evaluate must report the error only when they're executed.
+  if (node->value().type() == Token::STRING &&
+      node->value().value().find('$') != std::string_view::npos) {
+    CompileFallback(node);
+    return;
+  }
+
+  Err err;
+  Value value = node->Execute(nullptr, &err);
+  if (err.has_error()) {
+    CompileFallback(node);
+    return;
+  }
+  chunk_->constants_.push_back(std::move(value));
+  Emit(BytecodeChunk::kPushConstant, node,
+       static_cast<uint32_t>(chunk_->constants_.size() - 1));
+}
+
+void BytecodeCompiler::CompileFunctionCall(const FunctionCallNode* node) {
+  const functions::FunctionInfoMap& function_map = functions::GetFunctions();
+  auto found = function_map.find(node->function().value());
+  chunk_->functions_.push_back(found == function_map.end() ? nullptr
+                                                           : &found->second);
+  Emit(BytecodeChunk::kCallFunction, node,
+       static_cast<uint32_t>(chunk_->functions_.size() - 1));
+
+  // The arguments and block are executed by the function itself.
+  CompileNestedBlocks(node->args());
+  CompileNestedBlocks(node->block());
+}
+
+void BytecodeCompiler::CompileFallback(const ParseNode* node) {
+  Emit(BytecodeChunk::kEvaluateNode, node);
+  CompileNestedBlocks(node);
+}
+
+size_t BytecodeCompiler::Emit(Opcode opcode,
+                              const ParseNode* node,
+                              uint32_t operand) {
+  chunk_->instructions_.push_back({opcode, operand, node});
+  return chunk_->instructions_.size() - 1;
+}
+
+void BytecodeCompiler::PatchJumpToHere(size_t index) {
+  chunk_->instructions_[index].operand =
+      static_cast<uint32_t>(chunk_->instructions_.size());
+}
+
+// BytecodeChunk ---------------------------------------------------------------
+
+BytecodeChunk::BytecodeChunk() = default;
+
+BytecodeChunk::~BytecodeChunk() = default;
+
+// static
+void BytecodeChunk::CompileTree(const ParseNode* root) {
+  DCHECK(root->AsBlock());
+  BytecodeCompiler::CompileBlock(root->AsBlock());
+}
+
+void BytecodeChunk::Execute(Scope* scope, Err* err) const {
+  // The compiler guarantees the node types of each opcode, so static casts
+  // are used below rather than the virtual As*() accessors.
+  std::vector<Value> stack;
+  size_t pc = 0;
+  while (pc < instructions_.size() && !err->has_error()) {
+    const Instruction& inst = instructions_[pc++];
+    switch (inst.opcode) {
+      case kPushConstant:
+        stack.push_back(constants_[inst.operand]);
+        break;
+
+      case kLoadIdentifier: {
+        // Must match IdentifierNode::Execute.
+        const IdentifierNode* identifier =
+            static_cast<const IdentifierNode*>(inst.node);
+        const Scope* found_in_scope = nullptr;
+        const Value* value = scope->GetValueWithScope(
+            identifier->value().value(), true, &found_in_scope);
+        if (!value) {
+          *err = identifier->MakeErrorDescribing("Undefined identifier");
+          break;
+        }
+        if (!EnsureNotReadingFromSameDeclareArgs(identifier, scope,
+                                                 found_in_scope, err))
+          break;
+        stack.push_back(*value);
+        stack.back().set_origin(identifier);
+        break;
+      }
+
+      case kEvaluateNode:
+        stack.push_back(inst.node->Execute(scope, err));
+        break;
+
+      case kCheckListItem:
+        // Must match ListNode::Execute.
+        if (stack.back().type() == Value::NONE) {
+          *err = inst.node->MakeErrorDescribing(
+              "This does not evaluate to a value.",
+              "I can't do something with nothing.");
+        }
+        break;
+
+      case kMakeList: {
+        Value list(inst.node, Value::LIST);
+        std::vector<Value>& items = list.list_value();
+        auto first = stack.end() - inst.operand;
+        items.reserve(inst.operand);
+        items.insert(items.end(), std::make_move_iterator(first),
+                     std::make_move_iterator(stack.end()));
+        stack.erase(first, stack.end());
+        stack.push_back(std::move(list));
+        break;
+      }
+
+      case kCheckOperand: {
+        const BinaryOpNode* binary =
+            static_cast<const BinaryOpNode*>(inst.node);
+        bool is_left = inst.operand == 0;
+        VerifyBinaryOperand(binary, is_left ? binary->left() : binary->right(),
+                            stack.back(), is_left ? "left" : "right", err);
+        break;
+      }
+
+      case kBinaryOp: {
+        Value right = std::move(stack.back());
+        stack.pop_back();
+        stack.back() = ExecuteBinaryOperatorOnValues(
+            scope, static_cast<const BinaryOpNode*>(inst.node),
+            std::move(stack.back()), std::move(right), err);
+        break;
+      }
+
+      case kUnaryOp:
+        stack.back() = ExecuteUnaryOperator(
+            scope, static_cast<const UnaryOpNode*>(inst.node), stack.back(),
+            err);
+        break;
+
+      case kShortCircuitLeft: {
+        const BinaryOpNode* binary =
+            static_cast<const BinaryOpNode*>(inst.node);
+        Value& left = stack.back();
+        if (!VerifyBooleanOperand(binary, left, true, err))
+          break;
+        bool is_or = binary->op().type() == Token::BOOLEAN_OR;
+        if (left.boolean_value() == is_or) {
+          left = Value(binary, is_or);
+          pc = inst.operand;
+        } else {
+          stack.pop_back();
+        }
+        break;
+      }
+
+      case kShortCircuitRight: {
+        const BinaryOpNode* binary =
+            static_cast<const BinaryOpNode*>(inst.node);
+        Value& right = stack.back();
+        if (VerifyBooleanOperand(binary, right, false, err))
+          right = Value(binary, right.boolean_value());
+        break;
+      }
+
+      case kCondition: {
+        // Must match ConditionNode::Execute.
+        const ConditionNode* condition =
+            static_cast<const ConditionNode*>(inst.node);
+        Value result = std::move(stack.back());
+        stack.pop_back();
+        if (result.type() != Value::BOOLEAN) {
+          *err = condition->condition()->MakeErrorDescribing(
+              "Condition does not evaluate to a boolean value.",
+              std::string("This is a value of type \"") +
+                  Value::DescribeType(result.type()) + "\" instead.");
+          err->AppendRange(condition->if_token().range());
+          break;
+        }
+        if (!result.boolean_value())
+          pc = inst.operand;
+        break;
+      }
+
+      case kJump:
+        pc = inst.operand;
+        break;
+
+      case kAssign: {
+        Value right = std::move(stack.back());
+        stack.pop_back();
+        ExecuteIdentifierAssignment(
+            scope, static_cast<const BinaryOpNode*>(inst.node),
+            std::move(right), err);
+        break;
+      }
+
+      case kCallFunction: {
+        // As in FunctionCallNode::Execute, the block is passed mutably.
+        const FunctionCallNode* call =
+            static_cast<const FunctionCallNode*>(inst.node);
+        stack.push_back(functions::RunResolvedFunction(
+            scope, call, call->args(), const_cast<BlockNode*>(call->block()),
+            functions_[inst.operand], err));
+        break;
+      }
+
+      case kPop:
+        stack.pop_back();
+        break;
+
+      case kNoEffectError:
+        *err = inst.node->MakeErrorDescribing(
+            "This statement has no effect.",
+            "Either delete it or do something with the result.");
+        break;
+    }
+  }
+}
@@ -0,0 +1,136 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_BYTECODE_H_
+#define TOOLS_GN_BYTECODE_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "gn/value.h"
+
+class Err;
+class ParseNode;
+class Scope;
+
+namespace functions {
+struct FunctionInfo;
+}
+
+// A compiled form of the statements of a BlockNode.
+//
+// The tree walker (ParseNode::Execute) re-dispatches virtual calls for every
+// node and looks up each function name in the function map on every call. A
+// BytecodeChunk flattens a block into a linear instruction stream where
+// literals are folded into constants and built-in functions are resolved
+// ahead of time. Conditions are inlined as jumps so the statements of an
+// "if" run in the same loop as the enclosing block.
+//
+// The VM is required to have exactly the same semantics as the tree walker,
+// including the order in which errors are detected and the locations that
+// they blame. Constructs that don't benefit from being compiled (accessors,
+// assignments to accessors, scope-returning blocks) are executed by the tree
+// walker through kEvaluateNode.
+//
+// Chunks are attached to their BlockNode (see BlockNode::set_bytecode) so any
+// code that executes a block, such as a template invocation or a foreach
+// loop, transparently runs the compiled form. Once compiled, a chunk is
+// immutable and can be executed from several threads at once.
+class BytecodeChunk {
+ public:
+  enum Opcode : uint8_t {
+    // Pushes constants_[operand].
+    kPushConstant,
+
+    // Pushes the value of the IdentifierNode |node|.
+    kLoadIdentifier,
+
+    // Pushes the result of executing |node| with the tree walker.
+    kEvaluateNode,
+
+    // Fails if the top of the stack (the value of the list item |node|)
+    // is none.
+    kCheckListItem,
+
+    // Pops |operand| items into a list owned by the ListNode |node|.
+    kMakeList,
+
+    // Fails if the top of the stack (an operand of the BinaryOpNode |node|)
+    // is none. |operand| is 0 for the left side and 1 for the right.
+    kCheckOperand,
+
+    // Pops two operands and pushes the result of the BinaryOpNode |node|.
+    kBinaryOp,
+
+    // Pops one operand and pushes the result of the UnaryOpNode |node|.
+    kUnaryOp,
+
+    // Checks the left operand of the || or && BinaryOpNode |node|. If it
+    // decides the result, replaces it with the result and jumps to
+    // |operand|. Otherwise pops it.
+    kShortCircuitLeft,
+
+    // Checks the right operand of the || or && BinaryOpNode |node| and
+    // replaces it with the result of the operator.
+    kShortCircuitRight,
+
+    // Pops the condition of the ConditionNode |node| and jumps to |operand|
+    // if it is false.
+    kCondition,
+
+    // Jumps to |operand|.
+    kJump,
+
+    // Pops the right-hand side of the assignment BinaryOpNode |node|, whose
+    // destination is an identifier, and assigns it.
+    kAssign,
+
+    // Pushes the result of the FunctionCallNode |node|, whose built-in
+    // function is functions_[operand] (null if there is none).
+    kCallFunction,
+
+    // Discards the top of the stack.
+    kPop,
+
+    // Fails with "This statement has no effect." blaming |node|.
+    kNoEffectError,
+  };
+
+  struct Instruction {
+    Opcode opcode;
+    uint32_t operand;
+    const ParseNode* node;
+  };
+
+  BytecodeChunk();
+  ~BytecodeChunk();
+
+  // Compiles |root| and every block nested in it that can be executed by
+  // BlockNode::Execute, and attaches the result to the blocks. |root| must be
+  // a BlockNode. This must be called before the tree is shared with other
+  // threads.
+  static void CompileTree(const ParseNode* root);
+
+  // Executes the instructions in |scope|, which is the scope the statements
+  // of the block execute in (the nested scope for scope-returning blocks).
+  void Execute(Scope* scope, Err* err) const;
+
+  const std::vector<Instruction>& instructions() const {
+    return instructions_;
+  }
+  const std::vector<Value>& constants() const { return constants_; }
+
+ private:
+  friend class BytecodeCompiler;
+
+  std::vector<Instruction> instructions_;
+  std::vector<Value> constants_;
+  std::vector<const functions::FunctionInfo*> functions_;
+
+  BytecodeChunk(const BytecodeChunk&) = delete;
+  BytecodeChunk& operator=(const BytecodeChunk&) = delete;
+};
+
+#endif  // TOOLS_GN_BYTECODE_H_
@@ -0,0 +1,178 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/bytecode.h"
+
+#include "gn/parse_tree.h"
+#include "gn/test_with_scope.h"
+#include "util/test/test.h"
+
+namespace {
+
+struct RunResult {
+  std::string output;
+  Err err;
+};
+
+// Runs |program| with either the tree walker or the bytecode VM.
+RunResult Run(const std::string& program, bool use_bytecode) {
+  TestWithScope setup;
+  TestParseInput input(program);
+  EXPECT_FALSE(input.has_error());
+
+  if (use_bytecode)
+    BytecodeChunk::CompileTree(input.parsed());
+
+  RunResult result;
+  input.parsed()->Execute(setup.scope(), &result.err);
+  result.output = setup.print_output();
+  return result;
+}
+
+// Runs |program| with both engines and checks that they agree on the output
+// and on the error, if any. Returns the result of the VM.
+RunResult RunBoth(const std::string& program) {
+  RunResult tree = Run(program, false);
+  RunResult vm = Run(program, true);
+  EXPECT_EQ(tree.output, vm.output) << program;
+  EXPECT_EQ(tree.err.has_error(), vm.err.has_error()) << program;
+  if (tree.err.has_error() && vm.err.has_error()) {
+    EXPECT_EQ(tree.err.message(), vm.err.message()) << program;
+    EXPECT_EQ(tree.err.help_text(), vm.err.help_text()) << program;
+    EXPECT_EQ(tree.err.location().line_number(),
+              vm.err.location().line_number())
+        << program;
+    EXPECT_EQ(tree.err.location().column_number(),
+              vm.err.location().column_number())
+        << program;
+  }
+  return vm;
+}
+
+}  // namespace
+
+TEST(Bytecode, FoldsLiterals) {
+  TestParseInput input("a = 5\nb = \"foo\"\nc = \"$b\"\n");
+  ASSERT_FALSE(input.has_error());
+  BytecodeChunk::CompileTree(input.parsed());
+
+  const BytecodeChunk* chunk = input.parsed()->AsBlock()->bytecode();
+  ASSERT_TRUE(chunk);
+  ASSERT_EQ(6u, chunk->instructions().size());
+  EXPECT_EQ(BytecodeChunk::kPushConstant, chunk->instructions()[0].opcode);
+  EXPECT_EQ(BytecodeChunk::kAssign, chunk->instructions()[1].opcode);
+  EXPECT_EQ(BytecodeChunk::kPushConstant, chunk->instructions()[2].opcode);
+  EXPECT_EQ(BytecodeChunk::kAssign, chunk->instructions()[3].opcode);
+  // Strings that need expansion are left to the tree walker.
+  EXPECT_EQ(BytecodeChunk::kEvaluateNode, chunk->instructions()[4].opcode);
+  EXPECT_EQ(BytecodeChunk::kAssign, chunk->instructions()[5].opcode);
+
+  ASSERT_EQ(2u, chunk->constants().size());
+  EXPECT_EQ(5, chunk->constants()[0].int_value());
+  EXPECT_EQ("foo", chunk->constants()[1].string_value());
+}
+
+TEST(Bytecode, CompilesFunctionBlocks) {
+  TestParseInput input("foreach(i, [1]) {\n  print(i)\n}\n");
+  ASSERT_FALSE(input.has_error());
+  BytecodeChunk::CompileTree(input.parsed());
+
+  const FunctionCallNode* call =
+      input.parsed()->AsBlock()->statements()[0]->AsFunctionCall();
+  ASSERT_TRUE(call);
+  EXPECT_TRUE(call->block()->bytecode());
+}
+
+TEST(Bytecode, Expressions) {
+  RunResult result = RunBoth(
+      "a = 1 + 2\n"
+      "b = [ a, \"x\" ] + [ 3 ]\n"
+      "b -= [ \"x\" ]\n"
+      "c = \"s\"\n"
+      "c += \"t$a\"\n"
+      "print(a, b, c)\n"
+      "print(a == 3, a != 3, a < 4, a <= 2, a > 2, a >= 4, !(a == 3))\n"
+      "s = { x = 1 }\n"
+      "print(s.x, b[1])\n");
+  EXPECT_FALSE(result.err.has_error());
+  EXPECT_EQ("3 [3, 3] st3\ntrue false true false true false false\n1 3\n",
+            result.output);
+}
+
+TEST(Bytecode, Conditions) {
+  RunResult result = RunBoth(
+      "foreach(i, [ 1, 2, 3, 4 ]) {\n"
+      "  if (i == 1) {\n"
+      "    print(\"one\")\n"
+      "  } else if (i == 2) {\n"
+      "    print(\"two\")\n"
+      "  } else {\n"
+      "    print(\"many\")\n"
+      "  }\n"
+      "  if (i > 3) {\n"
+      "    print(\"last\")\n"
+      "  }\n"
+      "}\n");
+  EXPECT_FALSE(result.err.has_error());
+  EXPECT_EQ("one\ntwo\nmany\nmany\nlast\n", result.output);
+}
+
+TEST(Bytecode, ShortCircuit) {
+  // The right-hand sides are never evaluated so the undefined identifiers
+  // don't throw errors.
+  RunResult result = RunBoth(
+      "print(true || undefined)\n"
+      "print(false && undefined)\n"
+      "print(false || true, true && false)\n");
+  EXPECT_FALSE(result.err.has_error());
+  EXPECT_EQ("true\nfalse\ntrue false\n", result.output);
+}
+
+TEST(Bytecode, Templates) {
+  RunResult result = RunBoth(
+      "template(\"t\") {\n"
+      "  print(\"$target_name \" + invoker.v)\n"
+      "}\n"
+      "t(\"foo\") {\n"
+      "  v = \"bar\"\n"
+      "}\n");
+  EXPECT_FALSE(result.err.has_error());
+  EXPECT_EQ("foo bar\n", result.output);
+}
+
+TEST(Bytecode, Errors) {
+  const char* kPrograms[] = {
+      "a = undefined\n",
+      "print(1)\na = [ 1, print(2) ]\n",
+      "if (1) {\n}\n",
+      "a = 1 + true\n",
+      "a = print(1) + 1\n",
+      "a = 1 || true\n",
+      "a = false || 1\n",
+      "a = !1\n",
+      "a = 1 < \"b\"\n",
+      "a = [ 1 ]\na = [ 2 ]\n",
+      "a = [ 1 ]\na -= [ 2 ]\n",
+      "a += 1\n",
+      "a = 01\n",
+      "a = [ 1 ]\na[1] = 2\n",
+      "unknown_function()\n",
+      "foreach(i, [ 1 ]) {\n  b = undefined\n}\n",
+  };
+  for (const char* program : kPrograms) {
+    RunResult result = RunBoth(program);
+    EXPECT_TRUE(result.err.has_error()) << program;
+  }
+}
+
+TEST(Bytecode, ErrorsOnlyWhenExecuted) {
+  // An invalid literal in an untaken branch is not an error.
+  RunResult result = RunBoth(
+      "if (false) {\n"
+      "  a = 01\n"
+      "}\n"
+      "print(\"ok\")\n");
+  EXPECT_FALSE(result.err.has_error());
+  EXPECT_EQ("ok\n", result.output);
+}
@@ -15,7 +15,6 @@
 #include "gn/location.h"
 #include "gn/setup.h"
 #include "gn/standard_out.h"
-#include "gn/string_utils.h"
 
 namespace commands {
 
@@ -109,7 +108,7 @@ int RunAnalyze(const std::vector<std::string>& args) {
 
   std::string input;
   if (args[1] == "-") {
-    input = ReadStdin();
+    input = ReadQueryStdin();
   } else {
     bool ret = base::ReadFileToString(UTF8ToFilePath(args[1]), &input);
     if (!ret) {
@@ -118,9 +117,8 @@ int RunAnalyze(const std::vector<std::string>& args) {
     }
   }
 
-  // Deliberately leaked to avoid expensive process teardown.
-  Setup* setup = new Setup;
-  if (!setup->DoSetup(args[0], false) || !setup->Run())
+  Setup* setup = LoadSetupForQuery(args[0]);
+  if (!setup)
     return 1;
 
   Err err;
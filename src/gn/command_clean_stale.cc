@@ -9,6 +9,7 @@
 #include "gn/commands.h"
 #include "gn/err.h"
 #include "gn/ninja_tools.h"
+#include "gn/output_manifest.h"
 #include "gn/setup.h"
 #include "gn/source_dir.h"
 #include "gn/switches.h"
@@ -28,14 +29,36 @@ bool CleanStaleOneDir(const base::FilePath& ninja_executable,
   base::FilePath build_dir(setup->build_settings().GetFullPath(
       SourceDir(setup->build_settings().build_dir().value())));
 
+  // With an output manifest, the outputs that the latest "gn gen" didn't
+  // declare are deleted without ninja.
+  OutputManifest manifest(build_dir);
+  bool has_output_manifest = manifest.Load();
+  Err err;
+  if (has_output_manifest) {
+    manifest.DeleteStaleOutputs(manifest.latest_outputs());
+    if (!manifest.Save(manifest.latest_outputs(), false, &err)) {
+      err.PrintToStdout();
+      return false;
+    }
+    if (ninja_executable.empty())
+      return true;
+  } else if (ninja_executable.empty()) {
+    Err(Location(), "No --ninja-executable provided.",
+        "clean_stale requires a ninja executable to run on a build directory "
+        "without an output manifest. You can provide one on the command line "
+        "via --ninja-executable.")
+        .PrintToStdout();
+    return false;
+  }
+
   // The order of operations for these tools is:
   // 1. cleandead - This eliminates old files from the build directory.
   // 2. recompact - This prunes old entries from the ninja log and deps files.
   //
   // This order is ideal because the files removed by cleandead will no longer
   // be found during the recompact, so ninja can prune their entries.
-  Err err;
-  if (!InvokeNinjaCleanDeadTool(ninja_executable, build_dir, &err)) {
+  if (!has_output_manifest &&
+      !InvokeNinjaCleanDeadTool(ninja_executable, build_dir, &err)) {
     err.PrintToStdout();
     return false;
   }
@@ -63,6 +86,11 @@ const char kCleanStale_Help[] =
   This command requires a ninja executable of at least version 1.10.0. The
   executable must be provided by the --ninja-executable switch.
 
+  If the build directory has an output manifest (see "gn help gen" about
+  --clean-stale), the output files it lists that the latest "gn gen" didn't
+  declare are deleted directly rather than by ninja. The ninja executable is
+  then optional, and only used to prune the records.
+
 Options
 
   --ninja-executable=<string>
@@ -80,13 +108,6 @@ int RunCleanStale(const std::vector<std::string>& args) {
   const base::CommandLine* cmdline = base::CommandLine::ForCurrentProcess();
   base::FilePath ninja_executable =
       cmdline->GetSwitchValuePath(switches::kNinjaExecutable);
-  if (ninja_executable.empty()) {
-    Err(Location(), "No --ninja-executable provided.",
-        "--clean-stale requires a ninja executable to run. You can "
-        "provide one on the command line via --ninja-executable.")
-        .PrintToStdout();
-    return 1;
-  }
 
   for (const std::string& dir : args) {
     if (!CleanStaleOneDir(ninja_executable, dir))
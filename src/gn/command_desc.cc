@@ -660,22 +660,25 @@ int RunDesc(const std::vector<std::string>& args) {
   }
   const base::CommandLine* cmdline = base::CommandLine::ForCurrentProcess();
 
-  // Deliberately leaked to avoid expensive process teardown.
-  Setup* setup = new Setup;
-
   bool json = cmdline->GetSwitchValueString("format") == "json";
   PrintCallbackHolder print_callback_holder;
-  if (json) {
-    // Silence all output while running desc if outputting to json.
-    BuildSettings* settings = &setup->build_settings();
-    print_callback_holder.SwapCallbacks(settings,
-                                        [](const std::string& str) {});
-  }
+  Setup* setup = GetQueryBatchSetup();
+  if (!setup) {
+    // Deliberately leaked to avoid expensive process teardown.
+    setup = new Setup;
+
+    if (json) {
+      // Silence all output while running desc if outputting to json.
+      BuildSettings* settings = &setup->build_settings();
+      print_callback_holder.SwapCallbacks(settings,
+                                          [](const std::string& str) {});
+    }
 
-  if (!setup->DoSetup(args[0], false))
-    return 1;
-  if (!setup->Run())
-    return 1;
+    if (!setup->DoSetup(args[0], false))
+      return 1;
+    if (!setup->Run())
+      return 1;
+  }
 
   // Resolve target(s) and config from inputs.
   UniqueVector<const Target*> target_matches;
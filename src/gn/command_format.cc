@@ -6,9 +6,14 @@
 
 #include <stddef.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <sstream>
 
 #include "base/command_line.h"
+#include "base/files/file_enumerator.h"
 #include "base/files/file_util.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
@@ -26,6 +31,7 @@
 #include "gn/switches.h"
 #include "gn/tokenizer.h"
 #include "util/build_config.h"
+#include "util/worker_pool.h"
 
 #if defined(OS_WIN)
 #include <fcntl.h>
@@ -38,6 +44,7 @@ const size_t kDefaultFormatWidth = 80;
 
 const char kSwitchDryRun[] = "dry-run";
 const char kSwitchDumpTree[] = "dump-tree";
+const char kSwitchFilesFrom[] = "files-from";
 const char kSwitchReadTree[] = "read-tree";
 const char kSwitchStdin[] = "stdin";
 const char kSwitchTreeTypeJSON[] = "json";
@@ -46,10 +53,16 @@ const char kSwitchTreeTypeText[] = "text";
 const char kFormat[] = "format";
 const char kFormat_HelpShort[] = "format: Format .gn files.";
 const char kFormat_Help[] =
-    R"(gn format [--dump-tree] [--format-width=WIDTH] (--stdin | <list of build_files...>)
+    R"(gn format [--dump-tree] [--format-width=WIDTH] (--stdin | [--files-from=<file>] <list of build_files or directories...>)
 
   Formats .gn file to a standard format.
 
+  The files are formatted in parallel. A directory is replaced with all the
+  .gn and .gni files it contains, recursively, except in hidden directories, in
+  build directories (the ones with a build.ninja file) and in symbolic links to
+  directories. These files are named as the directory was given followed by
+  their path in it.
+
   The contents of some lists ('sources', 'deps', etc.) will be sorted to a
   canonical order. To suppress this, you can add a comment of the form "#
   NOSORT" immediately preceding the assignment. e.g.
@@ -77,6 +90,10 @@ Arguments
       Dumps the parse tree to stdout and does not update the file or print
       formatted output. If no format is specified, text format will be used.
 
+  --files-from=<file>
+      Also formats the files listed in the given file, one per line. They are
+      resolved like the arguments.
+
   --stdin
       Read input from stdin and write to stdout rather than update a file
       in-place.
@@ -91,6 +108,7 @@ Examples
   gn format //some/BUILD.gn //some/other/BUILD.gn //and/another/BUILD.gn
   gn format some\\BUILD.gn
   gn format /abspath/some/BUILD.gn
+  gn format --dry-run //some/directory
   gn format --stdin
   gn format --read-tree=json //rewritten/BUILD.gn
 )";
@@ -1428,6 +1446,29 @@ void DoFormat(const ParseNode* root,
   *output = pr.String();
 }
 
+// Formats |file|, which must have its contents. On error, |err| refers to
+// |file|.
+bool FormatInputFile(InputFile* file,
+                     TreeDumpMode dump_tree,
+                     size_t maximum_width,
+                     std::string* output,
+                     std::string* dump_output,
+                     Err* err) {
+  // Tokenize.
+  std::vector<Token> tokens =
+      Tokenizer::Tokenize(file, err, WhitespaceTransform::kInvalidToSpace);
+  if (err->has_error())
+    return false;
+
+  // Parse.
+  std::unique_ptr<ParseNode> parse_node = Parser::Parse(tokens, err);
+  if (err->has_error())
+    return false;
+
+  DoFormat(parse_node.get(), dump_tree, maximum_width, output, dump_output);
+  return true;
+}
+
 }  // namespace
 
 bool FormatJsonToString(const std::string& json,
@@ -1449,22 +1490,11 @@ bool FormatStringToString(const std::string& input,
   InputFile file(source_file);
   file.SetContents(input);
   Err err;
-  // Tokenize.
-  std::vector<Token> tokens =
-      Tokenizer::Tokenize(&file, &err, WhitespaceTransform::kInvalidToSpace);
-  if (err.has_error()) {
-    err.PrintToStdout();
-    return false;
-  }
-
-  // Parse.
-  std::unique_ptr<ParseNode> parse_node = Parser::Parse(tokens, &err);
-  if (err.has_error()) {
+  if (!FormatInputFile(&file, dump_tree, maximum_width, output, dump_output,
+                       &err)) {
     err.PrintToStdout();
     return false;
   }
-
-  DoFormat(parse_node.get(), dump_tree, maximum_width, output, dump_output);
   return true;
 }
 
@@ -1475,6 +1505,105 @@ Result<std::string> FormatNodeToString(const ParseNode* root) {
   return output;
 }
 
+namespace {
+
+// A file to format, and how to refer to it in the output.
+struct FileToFormat {
+  base::FilePath path;
+  std::string name;
+};
+
+// The outcome of formatting one file. Files are formatted from several
+// threads, but their results are printed in the order of the files so that
+// the output doesn't depend on the scheduling.
+struct FormatResult {
+  bool done = false;
+  int exit_code = 0;
+
+  // The file is kept for the error, which refers to it.
+  std::unique_ptr<InputFile> input_file;
+  Err err;
+
+  std::string dump_output;
+  std::string message;
+};
+
+void FormatFile(const FileToFormat& file,
+                TreeDumpMode dump_tree,
+                size_t format_width,
+                bool dry_run,
+                bool quiet,
+                FormatResult* result) {
+  std::string original_contents;
+  if (!base::ReadFileToString(file.path, &original_contents)) {
+    result->err = Err(Location(), std::string("Couldn't read \"") +
+                                      FilePathToUTF8(file.path));
+    result->exit_code = 1;
+    return;
+  }
+
+  result->input_file = std::make_unique<InputFile>(SourceFile());
+  result->input_file->SetContents(original_contents);
+  std::string output_string;
+  if (!FormatInputFile(result->input_file.get(), dump_tree, format_width,
+                       &output_string, &result->dump_output, &result->err)) {
+    result->exit_code = 1;
+    return;
+  }
+  if (dump_tree != TreeDumpMode::kInactive ||
+      original_contents == output_string) {
+    return;
+  }
+
+  if (dry_run) {
+    result->message = file.name + "\n";
+    result->exit_code = 2;
+    return;
+  }
+  // Update the file in-place.
+  if (base::WriteFile(file.path, output_string.data(),
+                      static_cast<int>(output_string.size())) == -1) {
+    result->err =
+        Err(Location(), "Failed to write formatted output back to \"" +
+                            FilePathToUTF8(file.path) + "\".");
+    result->exit_code = 1;
+    return;
+  }
+  if (!quiet) {
+    result->message =
+        "Wrote formatted to '" + FilePathToUTF8(file.path) + "'.\n";
+  }
+}
+
+}  // namespace
+
+void FindFilesToFormat(const base::FilePath& dir,
+                       std::vector<base::FilePath>* files) {
+  std::vector<base::FilePath> entries;
+  base::FileEnumerator traversal(
+      dir, false,
+      base::FileEnumerator::FILES | base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath entry = traversal.Next(); !entry.empty();
+       entry = traversal.Next()) {
+    entries.push_back(entry);
+  }
+  std::sort(entries.begin(), entries.end());
+
+  for (const base::FilePath& entry : entries) {
+    std::string name = FilePathToUTF8(entry.BaseName());
+    if (base::DirectoryExists(entry)) {
+      // A symbolic link may point to one of the directories above, and
+      // following it would never end.
+      if (!name.starts_with('.') && !base::IsLink(entry) &&
+          !base::PathExists(entry.AppendASCII("build.ninja"))) {
+        FindFilesToFormat(entry, files);
+      }
+    } else if (name.ends_with(".gn") || name.ends_with(".gni")) {
+      files->push_back(entry);
+    }
+  }
+}
+
 int RunFormat(const std::vector<std::string>& args) {
 #if defined(OS_WIN)
   // Set to binary mode to prevent converting newlines to \r\n.
@@ -1545,7 +1674,7 @@ int RunFormat(const std::vector<std::string>& args) {
     return 0;
   }
 
-  if (args.size() == 0) {
+  if (args.size() == 0 && !cmdline->HasSwitch(kSwitchFilesFrom)) {
     Err(Location(), "Expecting one or more arguments, see `gn help format`.\n")
         .PrintToStdout();
     return 1;
@@ -1592,10 +1721,27 @@ int RunFormat(const std::vector<std::string>& args) {
     return 0;
   }
 
-  // TODO(scottmg): Eventually, this list of files should be processed in
-  // parallel.
+  // The files are the arguments, the files listed in --files-from, and the
+  // build files found in directories given as either.
+  std::vector<std::string> inputs = args;
+  if (cmdline->HasSwitch(kSwitchFilesFrom)) {
+    base::FilePath list_path = cmdline->GetSwitchValuePath(kSwitchFilesFrom);
+    std::string list;
+    if (!base::ReadFileToString(list_path, &list)) {
+      Err(Location(), std::string("Couldn't read \"") +
+                          FilePathToUTF8(list_path) + "\".")
+          .PrintToStdout();
+      return 1;
+    }
+    for (const std::string& line : base::SplitString(
+             list, "\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+      inputs.push_back(line);
+    }
+  }
+
   int exit_code = 0;
-  for (const auto& arg : args) {
+  std::vector<FileToFormat> files;
+  for (const auto& arg : inputs) {
     Err err;
     SourceFile file = source_dir.ResolveRelativeFile(Value(nullptr, arg), &err);
     if (err.has_error()) {
@@ -1605,48 +1751,54 @@ int RunFormat(const std::vector<std::string>& args) {
     }
 
     base::FilePath to_format = setup.build_settings().GetFullPath(file);
-    std::string original_contents;
-    if (!base::ReadFileToString(to_format, &original_contents)) {
-      Err(Location(),
-          std::string("Couldn't read \"") + FilePathToUTF8(to_format))
-          .PrintToStdout();
-      exit_code = 1;
-      continue;
+    if (base::DirectoryExists(to_format)) {
+      // Like the files given directly, the ones found in a directory are
+      // named as given, followed by their path in the directory.
+      std::vector<base::FilePath> found;
+      FindFilesToFormat(to_format, &found);
+      std::string prefix = arg;
+      if (!prefix.ends_with('/'))
+        prefix.push_back('/');
+      for (base::FilePath& path : found) {
+        base::FilePath relative;
+        to_format.AppendRelativePath(path, &relative);
+        std::string name =
+            prefix + FilePathToUTF8(relative.NormalizePathSeparatorsTo('/'));
+        files.push_back({std::move(path), std::move(name)});
+      }
+    } else {
+      files.push_back({to_format, arg});
     }
+  }
 
-    std::string output_string;
-    std::string dump_output_string;
-    if (!FormatStringToString(original_contents, dump_tree, format_width,
-                              &output_string, &dump_output_string)) {
-      exit_code = 1;
-      continue;
-    }
-    printf("%s", dump_output_string.c_str());
-    if (dump_tree == TreeDumpMode::kInactive) {
-      if (dry_run) {
-        if (original_contents != output_string) {
-          printf("%s\n", arg.c_str());
-          exit_code = 2;
-        }
-        continue;
-      }
-      // Update the file in-place.
-      if (original_contents != output_string) {
-        if (base::WriteFile(to_format, output_string.data(),
-                            static_cast<int>(output_string.size())) == -1) {
-          Err(Location(),
-              std::string("Failed to write formatted output back to \"") +
-                  FilePathToUTF8(to_format) + std::string("\"."))
-              .PrintToStdout();
-          exit_code = 1;
-          continue;
-        }
-        if (!quiet) {
-          printf("Wrote formatted to '%s'.\n",
-                 FilePathToUTF8(to_format).c_str());
-        }
-      }
+  std::vector<FormatResult> results(files.size());
+  std::mutex results_lock;
+  std::condition_variable result_done;
+  // Declared after the results so that its threads stop before they go away.
+  WorkerPool pool;
+  for (size_t i = 0; i < files.size(); ++i) {
+    pool.PostTask([&, i]() {
+      FormatResult result;
+      FormatFile(files[i], dump_tree, format_width, dry_run, quiet, &result);
+      std::lock_guard<std::mutex> lock(results_lock);
+      results[i] = std::move(result);
+      results[i].done = true;
+      result_done.notify_all();
+    });
+  }
+
+  for (FormatResult& result : results) {
+    {
+      std::unique_lock<std::mutex> lock(results_lock);
+      result_done.wait(lock, [&result]() { return result.done; });
     }
+    if (result.err.has_error())
+      result.err.PrintToStdout();
+    printf("%s", result.dump_output.c_str());
+    printf("%s", result.message.c_str());
+    if (result.exit_code != 0)
+      exit_code = result.exit_code;
+    result = FormatResult();
   }
 
   return exit_code;
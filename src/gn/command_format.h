@@ -6,7 +6,9 @@
 #define TOOLS_GN_COMAND_FORMAT_H_
 
 #include <string>
+#include <vector>
 
+#include "base/files/file_path.h"
 #include "gn/err.h"
 
 class ParseNode;
@@ -42,6 +44,12 @@ bool FormatStringToString(const std::string& input,
 
 Result<std::string> FormatNodeToString(const ParseNode* root);
 
+// Appends the .gn and .gni files in |dir| and its subdirectories to |files|,
+// sorted by path. Hidden directories, build directories (the ones with a
+// build.ninja file) and symbolic links to directories are skipped.
+void FindFilesToFormat(const base::FilePath& dir,
+                       std::vector<base::FilePath>* files);
+
 }  // namespace commands
 
 #endif  // TOOLS_GN_COMAND_FORMAT_H_
@@ -5,6 +5,7 @@
 #include "gn/command_format.h"
 
 #include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "gn/commands.h"
 #include "gn/filesystem_utils.h"
 #include "gn/setup.h"
@@ -189,3 +190,29 @@ FORMAT_TEST(103)
 FORMAT_TEST(104)
 FORMAT_TEST(105)
 FORMAT_TEST_WITH_WIDTH(106, 20)
+
+TEST(FormatTest, FindFilesToFormat) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath root = temp_dir.GetPath();
+  for (const char* dir : {"a", "a/b", ".git", "out", "out/Debug"})
+    ASSERT_TRUE(base::CreateDirectory(root.AppendASCII(dir)));
+  for (const char* file :
+       {"BUILD.gn", "a/BUILD.gn", "a/b/rules.gni", "a/b/file.cc", ".git/x.gn",
+        "out/Debug/build.ninja", "out/Debug/args.gn", "z.gn"}) {
+    ASSERT_TRUE(WriteFile(root.AppendASCII(file), "", nullptr));
+  }
+#if defined(OS_POSIX)
+  // A link to a parent directory would be followed forever.
+  ASSERT_TRUE(base::CreateSymbolicLink(root, root.AppendASCII("a/loop")));
+#endif
+
+  std::vector<base::FilePath> files;
+  commands::FindFilesToFormat(root, &files);
+  std::vector<base::FilePath> expected = {
+      root.AppendASCII("BUILD.gn"),
+      root.AppendASCII("a").AppendASCII("BUILD.gn"),
+      root.AppendASCII("a").AppendASCII("b").AppendASCII("rules.gni"),
+      root.AppendASCII("z.gn")};
+  EXPECT_EQ(expected, files);
+}
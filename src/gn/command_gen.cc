@@ -4,9 +4,15 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <queue>
 #include <thread>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "base/command_line.h"
 #include "base/files/file_util.h"
@@ -17,23 +23,34 @@
 #include "gn/commands.h"
 #include "gn/compile_commands_writer.h"
 #include "gn/eclipse_writer.h"
+#include "gn/file_write_batch.h"
 #include "gn/filesystem_utils.h"
+#include "gn/gen_fingerprint.h"
+#include "gn/graph_snapshot.h"
+#include "gn/input_summary.h"
 #include "gn/json_project_writer.h"
 #include "gn/label_pattern.h"
+#include "gn/metadata_walk.h"
 #include "gn/ninja_outputs_writer.h"
+#include "gn/ninja_utils.h"
 #include "gn/ninja_target_writer.h"
 #include "gn/ninja_tools.h"
 #include "gn/ninja_writer.h"
+#include "gn/output_hash_manifest.h"
+#include "gn/output_manifest.h"
+#include "gn/parallel_for.h"
 #include "gn/qt_creator_writer.h"
 #include "gn/runtime_deps.h"
 #include "gn/rust_project_writer.h"
 #include "gn/scheduler.h"
 #include "gn/setup.h"
 #include "gn/standard_out.h"
+#include "gn/string_output_buffer.h"
 #include "gn/switches.h"
 #include "gn/target.h"
 #include "gn/visual_studio_writer.h"
 #include "gn/xcode_writer.h"
+#include "util/exe_path.h"
 
 namespace commands {
 
@@ -42,6 +59,10 @@ namespace {
 const char kSwitchCheck[] = "check";
 const char kSwitchCleanStale[] = "clean-stale";
 const char kSwitchFilters[] = "filters";
+const char kSwitchFingerprint[] = "fingerprint";
+const char kSwitchGraphSnapshot[] = "graph-snapshot";
+const char kSwitchHashManifest[] = "hash-manifest";
+const char kSwitchHoistCompilerVars[] = "hoist-compiler-vars";
 const char kSwitchIde[] = "ide";
 const char kSwitchIdeValueEclipse[] = "eclipse";
 const char kSwitchIdeValueQtCreator[] = "qtcreator";
@@ -55,6 +76,7 @@ const char kSwitchIdeValueWinSdk[] = "winsdk";
 const char kSwitchIdeValueXcode[] = "xcode";
 const char kSwitchIdeValueJson[] = "json";
 const char kSwitchIdeRootTarget[] = "ide-root-target";
+const char kSwitchInputSummary[] = "input-summary";
 const char kSwitchNinjaExecutable[] = "ninja-executable";
 const char kSwitchNinjaExtraArgs[] = "ninja-extra-args";
 const char kSwitchNinjaOutputsFile[] = "ninja-outputs-file";
@@ -78,19 +100,106 @@ const char kSwitchExportCompileCommands[] = "export-compile-commands";
 const char kSwitchExportRustProject[] = "export-rust-project";
 const char kSwitchFilterWithData[] = "filter-with-data";
 
+// Number of threads writing the target ninja files. Writing a file mostly
+// waits for the kernel, so a few of them are enough to keep it busy.
+const size_t kFileWriteThreads = 4;
+
 // A map type used to implement --ide=ninja_outputs
 using NinjaOutputsMap = NinjaOutputsWriter::MapType;
 
-// Collects Ninja rules for each toolchain. The lock protects the rules
+// Collects Ninja rules for each toolchain. Each worker thread adds the rules
+// of the targets it writes to its own shard, so that they don't contend on a
+// lock, and MergeShards() combines them once all the targets are written.
 struct TargetWriteInfo {
   // Set this to true to populate |ninja_outputs_map| below.
   bool want_ninja_outputs = false;
 
-  std::mutex lock;
+  // The rules and outputs of the targets written by one worker thread.
+  struct Shard {
+    std::vector<NinjaWriter::TargetRulePair> rules;
+    std::vector<std::pair<const Target*, std::vector<OutputFile>>>
+        ninja_outputs;
+  };
+
+  // Returns the shard of the calling thread. The cache of each thread is keyed
+  // on |generation| rather than on the address of this object, which a later
+  // TargetWriteInfo may reuse.
+  Shard* GetShard() {
+    thread_local std::pair<uint64_t, Shard*> cached;
+    if (cached.first != generation) {
+      std::lock_guard<std::mutex> lock(shards_lock);
+      shards.push_back(std::make_unique<Shard>());
+      cached = {generation, shards.back().get()};
+    }
+    return cached.second;
+  }
+
+  // Moves the rules of the shards to |rules| and their outputs to
+  // |ninja_outputs_map|. The ninja files must have deterministic content, so
+  // the rules of each toolchain are sorted by label: the shards are sorted in
+  // parallel, then merged.
+  void MergeShards() {
+    auto label_less = [](const NinjaWriter::TargetRulePair& a,
+                         const NinjaWriter::TargetRulePair& b) {
+      return a.first->label() < b.first->label();
+    };
+    ParallelFor(shards.size(), 1,
+                [this, &label_less](size_t begin, size_t end) {
+                  for (size_t i = begin; i < end; ++i) {
+                    std::sort(shards[i]->rules.begin(), shards[i]->rules.end(),
+                              label_less);
+                  }
+                });
+
+    // Merge the sorted shards, picking the lowest label among their heads.
+    using Cursor = std::pair<NinjaWriter::TargetRulePair*,
+                             NinjaWriter::TargetRulePair*>;  // Next, end.
+    auto cursor_greater = [&label_less](const Cursor& a, const Cursor& b) {
+      return label_less(*b.first, *a.first);
+    };
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype(cursor_greater)>
+        heads(cursor_greater);
+    for (const auto& shard : shards) {
+      if (!shard->rules.empty()) {
+        heads.emplace(shard->rules.data(),
+                      shard->rules.data() + shard->rules.size());
+      }
+    }
+    while (!heads.empty()) {
+      Cursor cursor = heads.top();
+      heads.pop();
+      rules[cursor.first->first->toolchain()].push_back(
+          std::move(*cursor.first));
+      if (++cursor.first != cursor.second)
+        heads.push(cursor);
+    }
+
+    for (const auto& shard : shards) {
+      for (auto& pair : shard->ninja_outputs)
+        ninja_outputs_map.emplace(pair.first, std::move(pair.second));
+    }
+    shards.clear();
+    generation = NewGeneration();
+  }
+
+  // Never 0, the value of the caches of new threads.
+  static uint64_t NewGeneration() {
+    static std::atomic<uint64_t> last_generation = 0;
+    return ++last_generation;
+  }
+
   NinjaWriter::PerToolchainRules rules;
 
   NinjaOutputsMap ninja_outputs_map;
 
+  // Only locked when a thread adds its shard.
+  std::mutex shards_lock;
+  std::vector<std::unique_ptr<Shard>> shards;
+
+  // Identifies |shards| in the caches of the threads. Changes when they are
+  // merged.
+  uint64_t generation = NewGeneration();
+
   std::unique_ptr<ResolvedTargetData> resolved =
       std::make_unique<ResolvedTargetData>();
 
@@ -107,20 +216,15 @@ void BackgroundDoWrite(TargetWriteInfo* write_info, const Target* target) {
   std::string rule =
       NinjaTargetWriter::RunAndWriteFile(target, resolved, ninja_outputs);
 
-  {
-    std::lock_guard<std::mutex> lock(write_info->lock);
-    // Even if rule is empty, add it to the map to ensure a corresponding
-    // .toolchain file will be generated, otherwise Ninja will complain
-    // when the build.ninja file tries to load a non-existent .toolchain
-    // file.
-    write_info->rules[target->toolchain()].emplace_back(target,
-                                                        std::move(rule));
+  TargetWriteInfo::Shard* shard = write_info->GetShard();
+  // Even if rule is empty, add it to the map to ensure a corresponding
+  // .toolchain file will be generated, otherwise Ninja will complain
+  // when the build.ninja file tries to load a non-existent .toolchain
+  // file.
+  shard->rules.emplace_back(target, std::move(rule));
 
-    if (write_info->want_ninja_outputs) {
-      write_info->ninja_outputs_map.emplace(target,
-                                            std::move(target_ninja_outputs));
-    }
-  }
+  if (write_info->want_ninja_outputs)
+    shard->ninja_outputs.emplace_back(target, std::move(target_ninja_outputs));
 }
 
 // Called on the main thread.
@@ -447,16 +551,21 @@ bool RunNinjaPostProcessTools(const BuildSettings* build_settings,
                               base::FilePath ninja_executable,
                               bool is_regeneration,
                               bool clean_stale,
+                              bool has_output_manifest,
                               Err* err) {
   // If the user did not specify an executable, skip running the post processing
   // tools. Since these tools can re-write ninja build log and dep logs, it is
   // really important that ninja executable used for tools matches the
   // executable that is used for builds.
+  // With an output manifest, --clean-stale deletes the stale outputs without
+  // ninja, which is then only needed to prune their records.
   if (ninja_executable.empty()) {
-    if (clean_stale) {
+    if (clean_stale && !has_output_manifest) {
       *err = Err(Location(), "No --ninja-executable provided.",
-                 "--clean-stale requires a ninja executable to run. You can "
-                 "provide one on the command line via --ninja-executable.");
+                 "--clean-stale requires a ninja executable to run until the "
+                 "build directory has an output manifest, which this run "
+                 "created. You can provide one on the command line via "
+                 "--ninja-executable.");
       return false;
     }
 
@@ -474,7 +583,8 @@ bool RunNinjaPostProcessTools(const BuildSettings* build_settings,
       return false;
     }
 
-    if (!InvokeNinjaCleanDeadTool(ninja_executable, build_dir, err)) {
+    if (!has_output_manifest &&
+        !InvokeNinjaCleanDeadTool(ninja_executable, build_dir, err)) {
       return false;
     }
 
@@ -502,6 +612,46 @@ bool RunNinjaPostProcessTools(const BuildSettings* build_settings,
   return true;
 }
 
+// Returns true if the fingerprint of --fingerprint is used for a run with the
+// switches of |cmdline|. It isn't when the run reads more than the recorded
+// inputs, like the includes of the sources for --check, or writes files that
+// aren't recorded as outputs, like IDE files.
+bool UsesGenFingerprint(const base::CommandLine& cmdline) {
+  if (!cmdline.HasSwitch(kSwitchFingerprint))
+    return false;
+  for (const char* name :
+       {kSwitchCheck, kSwitchCleanStale, kSwitchExportCompileCommands,
+        kSwitchExportRustProject, kSwitchIde, kSwitchJsonFileName,
+        kSwitchJsonIdeScript, kSwitchNinjaOutputsFile,
+        switches::kRuntimeDepsListFile}) {
+    if (cmdline.HasSwitch(name))
+      return false;
+  }
+  return true;
+}
+
+// Deletes the outputs of |manifest| that are not in |outputs_map| if
+// |clean_stale|, and then updates the manifest.
+bool UpdateOutputManifest(const OutputManifest& manifest,
+                          const NinjaOutputsMap& outputs_map,
+                          bool clean_stale,
+                          Err* err) {
+  std::vector<std::string> outputs;
+  for (const auto& [target, target_outputs] : outputs_map) {
+    for (const OutputFile& output : target_outputs)
+      outputs.emplace_back(output.value());
+  }
+  std::sort(outputs.begin(), outputs.end());
+
+  if (clean_stale) {
+    size_t deleted = manifest.DeleteStaleOutputs(outputs);
+    if (base::CommandLine::ForCurrentProcess()->HasSwitch(switches::kVerbose))
+      OutputString("Deleted " + base::NumberToString(deleted) +
+                   " stale output files.\n");
+  }
+  return manifest.Save(outputs, !clean_stale, err);
+}
+
 bool WriteIgnoreFile(Setup& setup, Err* err) {
   // Write a .gitignore file that causes the build directory to be ignored.
   base::FilePath output_path =
@@ -551,6 +701,56 @@ General options
       option requires a ninja executable of at least version 1.10.0. It can be
       provided by the --ninja-executable switch. Also see "gn help clean_stale".
 
+      GN lists the outputs of the build in the ".gn_outputs" file of the build
+      directory, and keeps adding the outputs of the next runs to it once it
+      exists. This option creates the list if needed. Once the build directory
+      has one, the output files it lists that the build no longer has are
+      deleted directly rather than by ninja, and the list is reset to the
+      current outputs. The ninja executable is then optional: without it, the
+      records of the deleted files stay until a run with one prunes them.
+
+  --hash-manifest
+      Keeps the hashes of the contents of the generated files in the
+      ".gn_hashes" file of the build directory. A file that was not modified
+      since the previous run is then known to be up to date by hashing its new
+      contents, instead of reading it back to compare them. This makes a
+      regeneration that changes few files faster for large builds.
+
+  --hoist-compiler-vars
+      Defines the long compiler variables of binary targets (cflags, defines,
+      include_dirs, etc.) once per toolchain, in the toolchain's .ninja file,
+      and makes the .ninja files of the targets refer to them instead of
+      repeating the values. This makes the generated files much smaller and
+      faster for ninja to load. The commands that ninja runs are unchanged.
+
+  --input-summary
+      Lists the files read to generate the build (build files, imports,
+      exec_script() inputs, etc.) in "build.ninja.inputs" rather than in
+      "build.ninja.d", which ninja checks one by one every time it runs. Ninja
+      then always runs GN, which checks the listed files from several threads
+      and returns right away if none of them changed. This makes starting a
+      build faster when there are many build files.
+
+  --graph-snapshot
+      Also saves the resolved targets with their types and dependencies in
+      "build.ninja.graph". Until a file read to generate the build changes,
+      "gn ls" and "gn refs" then load the targets from it instead of running
+      the build files again.
+
+  --fingerprint
+      Records the version of GN, the switches, the files read to generate the
+      build and the files written in "build.ninja.fingerprint". The next
+      "gn gen --fingerprint" with the same switches checks these files from
+      several threads, and returns right away without running the build files
+      if none of them changed or was deleted. This makes regenerating a build
+      that is already up to date nearly free.
+
+      The fingerprint isn't used with the switches that make "gn gen" do more
+      than generating the build from these files: --check, --clean-stale,
+      --export-compile-commands, --export-rust-project, --ide,
+      --json-file-name, --json-ide-script, --ninja-outputs-file and
+      --runtime-deps-list-file.
+
 IDE support
 
   QtCreator (version 20 and newer) has built-in support for GN-based projects.
@@ -779,6 +979,62 @@ int RunGen(const std::vector<std::string>& args) {
     return 1;
   }
 
+  // When ninja runs gn to check the input summary, there is nothing else to
+  // do if no input changed.
+  if (base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kRegeneration) &&
+      base::CommandLine::ForCurrentProcess()->HasSwitch(kSwitchInputSummary) &&
+      IsInputSummaryUpToDate(UTF8ToFilePath(args[0]))) {
+    return 0;
+  }
+
+  // With a fingerprint, nothing needs to be done if no input changed since
+  // the previous run with the same switches.
+  bool uses_fingerprint =
+      UsesGenFingerprint(*base::CommandLine::ForCurrentProcess());
+  base::FilePath fingerprint_dir;
+  Ticks fingerprint_start_time = 0;
+  if (uses_fingerprint) {
+    // The setup reports the errors.
+    fingerprint_dir = Setup::ResolveBuildDir(
+        args[0], *base::CommandLine::ForCurrentProcess());
+    uses_fingerprint = !fingerprint_dir.empty();
+  }
+  if (uses_fingerprint) {
+    if (IsGenFingerprintUpToDate(fingerprint_dir,
+                                 *base::CommandLine::ForCurrentProcess())) {
+      if (!base::CommandLine::ForCurrentProcess()->HasSwitch(
+              switches::kQuiet)) {
+        OutputString("Done. ", DECORATION_GREEN);
+        OutputString("Nothing changed since the previous run.\n");
+      }
+      return 0;
+    }
+    // The fingerprint is invalid until this run succeeds. This is done before
+    // the setup reads .gn and args.gn, so that their changes from now on are
+    // noticed too.
+    fingerprint_start_time = InvalidateGenFingerprint(fingerprint_dir);
+  }
+  // Likewise, the snapshot of this run is only up to date while its inputs
+  // are older than the start of the run.
+  Ticks graph_snapshot_start_time = 0;
+  if (base::CommandLine::ForCurrentProcess()->HasSwitch(
+          kSwitchGraphSnapshot)) {
+    base::FilePath graph_snapshot_dir = fingerprint_dir;
+    if (!uses_fingerprint) {
+      graph_snapshot_dir = Setup::ResolveBuildDir(
+          args[0], *base::CommandLine::ForCurrentProcess());
+    }
+    if (!graph_snapshot_dir.empty())
+      graph_snapshot_start_time = InvalidateGraphSnapshot(graph_snapshot_dir);
+  }
+  // Unless args.gn exists and --args isn't given, the setup writes args.gn
+  // after the invalidation, which makes it an output of the run.
+  bool has_args_file =
+      uses_fingerprint && !base::CommandLine::ForCurrentProcess()->HasSwitch(
+                              switches::kArgs) &&
+      base::PathExists(fingerprint_dir.AppendASCII(Setup::kBuildArgFileName));
+
   // Deliberately leaked to avoid expensive process teardown.
   Setup* setup = new Setup();
   // Generate an empty args.gn file if it does not exists
@@ -790,6 +1046,25 @@ int RunGen(const std::vector<std::string>& args) {
 
   const base::CommandLine* command_line =
       base::CommandLine::ForCurrentProcess();
+  const base::FilePath build_dir = setup->build_settings().GetFullPath(
+      setup->build_settings().build_dir());
+
+  setup->build_settings().set_hoist_compiler_vars(
+      command_line->HasSwitch(kSwitchHoistCompilerVars));
+  setup->build_settings().set_write_input_summary(
+      command_line->HasSwitch(kSwitchInputSummary));
+
+  // Deliberately leaked along with the setup.
+  OutputHashManifest* hash_manifest = nullptr;
+  if (command_line->HasSwitch(kSwitchHashManifest)) {
+    hash_manifest = new OutputHashManifest(
+        setup->build_settings()
+            .GetFullPath(setup->build_settings().build_dir())
+            .AppendASCII(OutputHashManifest::kFileName));
+    hash_manifest->Load();
+    OutputHashManifest::set_active(hash_manifest);
+  }
+
   if (command_line->HasSwitch(kSwitchCheck)) {
     setup->set_check_public_headers(true);
     if (command_line->GetSwitchValueString(kSwitchCheck) == "system")
@@ -806,36 +1081,62 @@ int RunGen(const std::vector<std::string>& args) {
     }
   }
 
+  // Once the build directory has an output manifest, the outputs of each run
+  // are added to it, so that --clean-stale knows the ones removed since.
+  bool clean_stale = command_line->HasSwitch(kSwitchCleanStale);
+  OutputManifest output_manifest(setup->build_settings().GetFullPath(
+      setup->build_settings().build_dir()));
+  bool has_output_manifest = output_manifest.Load();
+
   // Cause the load to also generate the ninja files for each target.
   TargetWriteInfo write_info;
   write_info.want_ninja_outputs =
-      command_line->HasSwitch(kSwitchNinjaOutputsFile);
+      command_line->HasSwitch(kSwitchNinjaOutputsFile) || clean_stale ||
+      has_output_manifest;
 
   setup->builder().set_resolved_and_generated_callback(
       [&write_info](const BuilderRecord* record) {
         ItemResolvedAndGeneratedCallback(&write_info, record);
       });
 
+  // The target ninja files are written from their own threads while the
+  // build graph is loaded. Deliberately leaked along with the setup.
+  FileWriteBatch* write_batch = new FileWriteBatch(kFileWriteThreads);
+  FileWriteBatch::set_active(write_batch);
+
+  // The generated_file targets share the metadata of their common deps while
+  // they are written. Deliberately leaked too.
+  MetadataWalkCache::set_active(new MetadataWalkCache);
+
+  // The fingerprint lists the files written by the run, including the ones of
+  // write_file(), so that the next run notices if one was deleted.
+  // Deliberately leaked too.
+  StringOutputBuffer::WrittenFiles* written_files = nullptr;
+  if (uses_fingerprint) {
+    written_files = new StringOutputBuffer::WrittenFiles;
+    StringOutputBuffer::WrittenFiles::set_active(written_files);
+  }
+
   // Do the actual load. This will also write out the target ninja files.
   if (!setup->Run())
     return 1;
 
+  Err err;
+  FileWriteBatch::set_active(nullptr);
+  MetadataWalkCache::set_active(nullptr);
+  if (!write_batch->Finish(&err)) {
+    err.PrintToStdout();
+    return 1;
+  }
+
   if (command_line->HasSwitch(switches::kVerbose))
     OutputString("Build graph constructed in " +
                  base::Int64ToString(timer.Elapsed().InMilliseconds()) +
                  "ms\n");
 
-  // Sort the targets in each toolchain according to their label. This makes
-  // the ninja files have deterministic content.
-  for (auto& cur_toolchain : write_info.rules) {
-    std::sort(cur_toolchain.second.begin(), cur_toolchain.second.end(),
-              [](const NinjaWriter::TargetRulePair& a,
-                 const NinjaWriter::TargetRulePair& b) {
-                return a.first->label() < b.first->label();
-              });
-  }
+  // Combine the rules of the targets, sorted by label.
+  write_info.MergeShards();
 
-  Err err;
   // Write the root ninja files.
   if (!NinjaWriter::RunAndWriteFiles(&setup->build_settings(), setup->builder(),
                                      write_info.rules, &err)) {
@@ -843,16 +1144,27 @@ int RunGen(const std::vector<std::string>& args) {
     return 1;
   }
 
+  // The stale outputs are deleted before ninja prunes their records.
+  if (clean_stale || has_output_manifest) {
+    if (!UpdateOutputManifest(output_manifest, write_info.ninja_outputs_map,
+                              clean_stale && has_output_manifest, &err)) {
+      err.PrintToStdout();
+      return 1;
+    }
+  }
+
+  // Without a manifest of the outputs of the previous runs, --clean-stale
+  // asks ninja to find the stale outputs instead.
   if (!RunNinjaPostProcessTools(
           &setup->build_settings(),
           command_line->GetSwitchValuePath(switches::kNinjaExecutable),
-          command_line->HasSwitch(switches::kRegeneration),
-          command_line->HasSwitch(kSwitchCleanStale), &err)) {
+          command_line->HasSwitch(switches::kRegeneration), clean_stale,
+          has_output_manifest, &err)) {
     err.PrintToStdout();
     return 1;
   }
 
-  if (write_info.want_ninja_outputs) {
+  if (command_line->HasSwitch(kSwitchNinjaOutputsFile)) {
     ElapsedTimer outputs_timer;
     std::string file_name =
         command_line->GetSwitchValueString(kSwitchNinjaOutputsFile);
@@ -915,6 +1227,83 @@ int RunGen(const std::vector<std::string>& args) {
     return 1;
   }
 
+  if (hash_manifest) {
+    OutputHashManifest::set_active(nullptr);
+    if (!hash_manifest->Save(&err)) {
+      err.PrintToStdout();
+      return 1;
+    }
+  }
+
+  // Never leave the snapshot of a previous run behind, since it may not
+  // match the arguments of this one.
+  base::FilePath graph_snapshot_path =
+      setup->build_settings()
+          .GetFullPath(setup->build_settings().build_dir())
+          .AppendASCII(kGraphSnapshotFileName);
+  if (command_line->HasSwitch(kSwitchGraphSnapshot)) {
+    if (!WriteGraphSnapshot(&setup->build_settings(),
+                            setup->loader()->default_toolchain_label(),
+                            setup->builder().GetAllResolvedTargets(),
+                            graph_snapshot_start_time, &err)) {
+      err.PrintToStdout();
+      return 1;
+    }
+  } else if (base::PathExists(graph_snapshot_path)) {
+    base::DeleteFile(graph_snapshot_path, false);
+  }
+
+  // Like the snapshot, a fingerprint left by a previous run would not match
+  // this one.
+  base::FilePath fingerprint_path =
+      build_dir.AppendASCII(kGenFingerprintFileName);
+  if (uses_fingerprint) {
+    StringOutputBuffer::WrittenFiles::set_active(nullptr);
+    std::vector<std::string> inputs =
+        GetGenInputs(&setup->build_settings());
+    // A new version of GN may generate different files.
+    inputs.push_back(FilePathToUTF8(GetExePath()));
+    // The files written by this run. Deleting one of them makes the next run
+    // regenerate it.
+    std::vector<std::string> outputs = {"build.ninja", "build.ninja.d",
+                                        "build.ninja.stamp"};
+    for (const base::FilePath& path : written_files->TakePaths())
+      outputs.push_back(GetGenInputPath(&setup->build_settings(), path));
+    for (const auto& [toolchain, rules] : write_info.rules) {
+      outputs.push_back(GetGenInputPath(
+          &setup->build_settings(),
+          setup->build_settings().GetFullPath(GetNinjaFileForToolchain(
+              setup->loader()->GetToolchainSettings(toolchain->label())))));
+    }
+    if (command_line->HasSwitch(kSwitchGraphSnapshot))
+      outputs.push_back(kGraphSnapshotFileName);
+    if (command_line->HasSwitch(kSwitchInputSummary))
+      outputs.push_back(kInputSummaryFileName);
+    if (hash_manifest)
+      outputs.push_back(OutputHashManifest::kFileName);
+    if (has_output_manifest)
+      outputs.push_back(OutputManifest::kFileName);
+    // With --args, args.gn was written from the switch, which the fingerprint
+    // already has.
+    if (!has_args_file) {
+      std::string args_file = GetGenInputPath(
+          &setup->build_settings(),
+          setup->build_settings().GetFullPath(setup->GetBuildArgFile()));
+      if (std::erase(inputs, args_file))
+        outputs.push_back(std::move(args_file));
+    }
+    // The files are written from several threads, and some more than once.
+    std::sort(outputs.begin(), outputs.end());
+    outputs.erase(std::unique(outputs.begin(), outputs.end()), outputs.end());
+    if (!WriteGenFingerprint(fingerprint_dir, *command_line, inputs, outputs,
+                             fingerprint_start_time, &err)) {
+      err.PrintToStdout();
+      return 1;
+    }
+  } else if (base::PathExists(fingerprint_path)) {
+    base::DeleteFile(fingerprint_path, false);
+  }
+
   TickDelta elapsed_time = timer.Elapsed();
 
   if (!command_line->HasSwitch(switches::kQuiet)) {
@@ -0,0 +1,152 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "gn/commands.h"
+#include "gn/filesystem_utils.h"
+#include "gn/gen_fingerprint.h"
+#include "gn/standard_out.h"
+#include "gn/switches.h"
+#include "gn/test_with_scheduler.h"
+#include "util/test/test.h"
+
+namespace {
+
+const char kDotfile[] = "buildconfig = \"//BUILDCONFIG.gn\"\n";
+
+const char kBuildConfig[] = "set_default_toolchain(\"//:tc\")\n";
+
+const char kBuildFile[] = R"(
+toolchain("tc") {
+  tool("cxx") {
+    command = "c++ {{source}} -o {{output}}"
+    outputs = [ "{{source_out_dir}}/{{label_name}}.{{source_name_part}}.o" ]
+  }
+  tool("stamp") {
+    command = "touch {{output}}"
+  }
+}
+
+source_set("a") {
+  public = [ "a.h" ]
+  sources = [ "a_priv.h" ]
+}
+
+source_set("b") {
+  sources = [ "b.cc" ]
+  deps = [ ":a" ]
+}
+)";
+
+class CommandGenTest : public TestWithScheduler {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    source_dir_ = base::MakeAbsoluteFilePath(temp_dir_.GetPath());
+    build_dir_ = source_dir_.AppendASCII("out");
+    WriteSourceFile(".gn", kDotfile);
+    WriteSourceFile("BUILDCONFIG.gn", kBuildConfig);
+    WriteSourceFile("BUILD.gn", kBuildFile);
+    WriteSourceFile("a.h", "");
+    WriteSourceFile("a_priv.h", "");
+    WriteSourceFile("b.cc", "#include \"a.h\"\n");
+  }
+
+  void WriteSourceFile(const char* name, const std::string& contents) {
+    ASSERT_TRUE(WriteFile(source_dir_.AppendASCII(name), contents, nullptr));
+  }
+
+  // Runs "gn gen" on the build directory with |switches|, and returns its
+  // exit code. What it prints goes to |output_|. The directory is given as
+  // |build_dir| if not empty.
+  int RunGen(const std::vector<std::string>& switches,
+             const std::string& build_dir = std::string()) {
+    std::string build_dir_arg =
+        build_dir.empty() ? FilePathToUTF8(build_dir_) : build_dir;
+    base::CommandLine cmdline(base::CommandLine::NO_PROGRAM);
+    cmdline.AppendArg("gen");
+    cmdline.AppendArg(build_dir_arg);
+    cmdline.AppendSwitchPath(switches::kRoot, source_dir_);
+    for (const std::string& name : switches)
+      cmdline.AppendSwitch(name);
+
+    // The command reads its switches from the command line of the process.
+    base::CommandLine* process_cmdline = base::CommandLine::ForCurrentProcess();
+    base::CommandLine saved_cmdline = *process_cmdline;
+    *process_cmdline = cmdline;
+    output_.clear();
+    SetOutputCapture(&output_);
+    int exit_code = commands::RunGen({build_dir_arg});
+    SetOutputCapture(nullptr);
+    *process_cmdline = saved_cmdline;
+    return exit_code;
+  }
+
+  // Whether the previous RunGen() found the fingerprint up to date.
+  bool WasSkipped() const {
+    return output_.find("Nothing changed") != std::string::npos;
+  }
+
+  base::ScopedTempDir temp_dir_;
+  base::FilePath source_dir_;
+  base::FilePath build_dir_;
+  std::string output_;
+};
+
+}  // namespace
+
+// The includes of the sources aren't inputs of the fingerprint, so --check
+// always runs.
+TEST_F(CommandGenTest, FingerprintNotUsedWithCheck) {
+  ASSERT_EQ(0, RunGen({"fingerprint"})) << output_;
+  EXPECT_TRUE(base::PathExists(
+      build_dir_.AppendASCII(kGenFingerprintFileName)));
+  ASSERT_EQ(0, RunGen({"fingerprint", "check"})) << output_;
+
+  WriteSourceFile("b.cc", "#include \"a.h\"\n#include \"a_priv.h\"\n");
+  EXPECT_EQ(1, RunGen({"fingerprint", "check"}));
+  EXPECT_NE(std::string::npos, output_.find("a_priv.h")) << output_;
+
+  // Without --check, the private include doesn't matter and the fingerprint
+  // is still used.
+  ASSERT_EQ(0, RunGen({"fingerprint"})) << output_;
+  EXPECT_EQ(0, RunGen({"fingerprint"})) << output_;
+  EXPECT_TRUE(base::PathExists(
+      build_dir_.AppendASCII(kGenFingerprintFileName)));
+}
+
+TEST_F(CommandGenTest, FingerprintSourceAbsoluteBuildDir) {
+  ASSERT_EQ(0, RunGen({"fingerprint"}, "//out")) << output_;
+  EXPECT_TRUE(base::PathExists(
+      build_dir_.AppendASCII(kGenFingerprintFileName)));
+
+  // Both forms of the directory find the same fingerprint.
+  ASSERT_EQ(0, RunGen({"fingerprint"}, "//out")) << output_;
+  EXPECT_TRUE(WasSkipped()) << output_;
+  ASSERT_EQ(0, RunGen({"fingerprint"})) << output_;
+  EXPECT_TRUE(WasSkipped()) << output_;
+}
+
+TEST_F(CommandGenTest, FingerprintDeletedOutput) {
+  ASSERT_EQ(0, RunGen({"fingerprint"})) << output_;
+  ASSERT_EQ(0, RunGen({"fingerprint"})) << output_;
+  EXPECT_TRUE(WasSkipped()) << output_;
+
+  // The ninja files of the toolchains and of the targets are outputs too.
+  for (const char* name : {"toolchain.ninja", "obj/b.ninja"}) {
+    base::FilePath path = build_dir_.Append(UTF8ToFilePath(name));
+    ASSERT_TRUE(base::DeleteFile(path, false)) << name;
+    ASSERT_EQ(0, RunGen({"fingerprint"})) << output_;
+    EXPECT_FALSE(WasSkipped()) << name;
+    EXPECT_TRUE(base::PathExists(path)) << name;
+    ASSERT_EQ(0, RunGen({"fingerprint"})) << output_;
+    EXPECT_TRUE(WasSkipped()) << name;
+  }
+}
@@ -3,10 +3,12 @@
 // found in the LICENSE file.
 
 #include <algorithm>
+#include <memory>
 #include <set>
 
 #include "base/command_line.h"
 #include "gn/commands.h"
+#include "gn/graph_snapshot.h"
 #include "gn/label_pattern.h"
 #include "gn/setup.h"
 #include "gn/standard_out.h"
@@ -15,6 +17,40 @@
 
 namespace commands {
 
+namespace {
+
+// Fills |matches| from the graph snapshot of the build directory, without
+// running the build files. Returns false if there is no usable snapshot or if
+// the inputs can't be resolved against it.
+bool GetMatchesFromGraphSnapshot(Setup* setup,
+                                 const std::vector<std::string>& inputs,
+                                 bool default_toolchain_only,
+                                 std::vector<const Target*>* matches) {
+  std::unique_ptr<GraphSnapshot> snapshot = LoadGraphSnapshotForQuery(setup);
+  if (!snapshot)
+    return false;
+
+  UniqueVector<const Target*> target_matches;
+  if (inputs.empty()) {
+    for (const Target* target : snapshot->targets()) {
+      if (!default_toolchain_only || target->settings()->is_default())
+        target_matches.push_back(target);
+    }
+  } else if (!ResolveTargetsFromGraphSnapshot(setup, *snapshot, inputs,
+                                              default_toolchain_only,
+                                              &target_matches)) {
+    return false;
+  }
+  matches->assign(target_matches.begin(), target_matches.end());
+
+  // The matches point into the snapshot, which is deliberately leaked like
+  // the setup.
+  snapshot.release();
+  return true;
+}
+
+}  // namespace
+
 const char kLs[] = "ls";
 const char kLs_HelpShort[] = "ls: List matching targets.";
 const char kLs_Help[] =
@@ -29,6 +65,11 @@ const char kLs_Help[] =
   not a general regular expression (see "gn help label_pattern"). If you need
   more complex expressions, pipe the result through grep.
 
+  If the build directory was generated with "gn gen --graph-snapshot", the
+  targets are loaded from the snapshot instead of running the build files,
+  unless a file read to generate the build changed since. This is only done
+  when printing labels and without --args.
+
 Options
 
 )" TARGET_PRINTING_MODE_COMMAND_LINE_HELP "\n" DEFAULT_TOOLCHAIN_SWITCH_HELP
@@ -66,17 +107,25 @@ int RunLs(const std::vector<std::string>& args) {
 
   // Deliberately leaked to avoid expensive process teardown.
   Setup* setup = new Setup;
-  if (!setup->DoSetup(args[0], false) || !setup->Run())
+  if (!setup->DoSetup(args[0], false))
     return 1;
 
   const base::CommandLine* cmdline = base::CommandLine::ForCurrentProcess();
   bool default_toolchain_only = cmdline->HasSwitch(switches::kDefaultToolchain);
+  std::vector<std::string> inputs(args.begin() + 1, args.end());
 
   std::vector<const Target*> matches;
-  if (args.size() > 1) {
-    // Some patterns or explicit labels were specified.
-    std::vector<std::string> inputs(args.begin() + 1, args.end());
+  if (GetMatchesFromGraphSnapshot(setup, inputs, default_toolchain_only,
+                                  &matches)) {
+    FilterAndPrintTargets(false, &matches);
+    return 0;
+  }
 
+  if (!setup->Run())
+    return 1;
+
+  if (!inputs.empty()) {
+    // Some patterns or explicit labels were specified.
     UniqueVector<const Target*> target_matches;
     UniqueVector<const Config*> config_matches;
     UniqueVector<const Toolchain*> toolchain_matches;
@@ -82,8 +82,8 @@ int RunMeta(const std::vector<std::string>& args) {
     return 1;
   }
 
-  Setup* setup = new Setup;
-  if (!setup->DoSetup(args[0], false) || !setup->Run())
+  Setup* setup = LoadSetupForQuery(args[0]);
+  if (!setup)
     return 1;
 
   const base::CommandLine* cmdline = base::CommandLine::ForCurrentProcess();
@@ -74,11 +74,8 @@ int RunOutputs(const std::vector<std::string>& args) {
     return 1;
   }
 
-  // Deliberately leaked to avoid expensive process teardown.
-  Setup* setup = new Setup;
-  if (!setup->DoSetup(args[0], false))
-    return 1;
-  if (!setup->Run())
+  Setup* setup = LoadSetupForQuery(args[0]);
+  if (!setup)
     return 1;
 
   std::vector<std::string> inputs(args.begin() + 1, args.end());
@@ -11,6 +11,8 @@
 #include "gn/commands.h"
 #include "gn/setup.h"
 #include "gn/standard_out.h"
+#include "gn/target.h"
+#include "gn/target_graph_index.h"
 
 namespace commands {
 
@@ -42,7 +44,15 @@ struct Options {
   bool with_data;
 };
 
-using WorkQueue = std::list<PathVector>;
+// A path of the search, as its last target and the index of the path it
+// extends in the list of paths searched. The paths are searched in the order
+// they are added, which makes the search breadth-first.
+struct SearchNode {
+  const Target* target;
+  DepType type;
+  size_t parent;
+};
+constexpr size_t kNoParent = static_cast<size_t>(-1);
 
 struct Stats {
   Stats() : public_paths(0), other_paths(0) {}
@@ -170,29 +180,76 @@ void InsertTargetsIntoFoundPaths(const PathVector& path,
   }
 }
 
-void BreadthFirstSearch(const Target* from,
+PathVector GetPath(const std::vector<SearchNode>& nodes, size_t index) {
+  PathVector path;
+  for (; index != kNoParent; index = nodes[index].parent)
+    path.emplace_back(nodes[index].target, nodes[index].type);
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+// Returns the targets with a path to |to| through the given kinds of deps,
+// including |to| itself. The search only needs to go through these.
+TargetSet GetTargetsReaching(const TargetGraphIndex& index,
+                             const Target* to,
+                             PrivateDeps private_deps,
+                             DataDeps data_deps,
+                             ValidationDeps validation_deps) {
+  TargetSet result;
+  result.add(to);
+  std::vector<const Target*> to_visit = {to};
+  while (!to_visit.empty()) {
+    const Target* current = to_visit.back();
+    to_visit.pop_back();
+    for (const TargetGraphIndex::Ref& ref : index.GetRefs(current)) {
+      switch (ref.kind) {
+        case TargetGraphIndex::DepKind::kPublic:
+          break;
+        case TargetGraphIndex::DepKind::kPrivate:
+          if (private_deps == PrivateDeps::EXCLUDE)
+            continue;
+          break;
+        case TargetGraphIndex::DepKind::kData:
+          if (data_deps == DataDeps::EXCLUDE)
+            continue;
+          break;
+        case TargetGraphIndex::DepKind::kValidation:
+          if (validation_deps == ValidationDeps::EXCLUDE)
+            continue;
+          break;
+      }
+      if (result.add(ref.target))
+        to_visit.push_back(ref.target);
+    }
+  }
+  return result;
+}
+
+void BreadthFirstSearch(const TargetGraphIndex& index,
+                        const Target* from,
                         const Target* to,
                         PrivateDeps private_deps,
                         DataDeps data_deps,
                         ValidationDeps validation_deps,
                         PrintWhat print_what,
                         Stats* stats) {
-  // Seed the initial stack with just the "from" target.
-  PathVector initial_stack;
-  initial_stack.emplace_back(from, DepType::NONE);
-  WorkQueue work_queue;
-  work_queue.push_back(initial_stack);
+  // Deps that can't lead to |to| are skipped, which doesn't change the order
+  // in which the other paths are found.
+  TargetSet reaching =
+      GetTargetsReaching(index, to, private_deps, data_deps, validation_deps);
+
+  // Seed the search with just the "from" target.
+  std::vector<SearchNode> nodes;
+  nodes.push_back(SearchNode{from, DepType::NONE, kNoParent});
 
   // Track checked targets to avoid checking the same once more than once.
   TargetSet visited;
 
-  while (!work_queue.empty()) {
-    PathVector current_path = work_queue.front();
-    work_queue.pop_front();
-
-    const Target* current_target = current_path.back().first;
+  for (size_t current = 0; current < nodes.size(); current++) {
+    const Target* current_target = nodes[current].target;
 
     if (current_target == to) {
+      PathVector current_path = GetPath(nodes, current);
       // Found a new path.
       if (stats->total_paths() == 0 || print_what == PrintWhat::ALL)
         PrintPath(current_path, DepType::NONE);
@@ -211,6 +268,7 @@ void BreadthFirstSearch(const Target* from,
       const auto& found_current_target =
           stats->found_paths.find(current_target);
       if (found_current_target != stats->found_paths.end()) {
+        PathVector current_path = GetPath(nodes, current);
         if (stats->total_paths() == 0 || print_what == PrintWhat::ALL)
           PrintPath(current_path, found_current_target->second);
 
@@ -228,52 +286,47 @@ void BreadthFirstSearch(const Target* from,
     if (!visited.add(current_target))
       continue;
 
+    auto add_deps = [&](const LabelTargetVector& deps, DepType type) {
+      for (const auto& pair : deps) {
+        if (reaching.contains(pair.ptr))
+          nodes.push_back(SearchNode{pair.ptr, type, current});
+      }
+    };
+
     // Add public deps for this target to the queue.
-    for (const auto& pair : current_target->public_deps()) {
-      work_queue.push_back(current_path);
-      work_queue.back().push_back(TargetDep(pair.ptr, DepType::PUBLIC));
-    }
+    add_deps(current_target->public_deps(), DepType::PUBLIC);
 
-    if (private_deps == PrivateDeps::INCLUDE) {
-      // Add private deps.
-      for (const auto& pair : current_target->private_deps()) {
-        work_queue.push_back(current_path);
-        work_queue.back().push_back(TargetDep(pair.ptr, DepType::PRIVATE));
-      }
-    }
+    // Add private deps.
+    if (private_deps == PrivateDeps::INCLUDE)
+      add_deps(current_target->private_deps(), DepType::PRIVATE);
 
-    if (data_deps == DataDeps::INCLUDE) {
-      // Add data deps.
-      for (const auto& pair : current_target->data_deps()) {
-        work_queue.push_back(current_path);
-        work_queue.back().push_back(TargetDep(pair.ptr, DepType::DATA));
-      }
-    }
+    // Add data deps.
+    if (data_deps == DataDeps::INCLUDE)
+      add_deps(current_target->data_deps(), DepType::DATA);
 
-    if (validation_deps == ValidationDeps::INCLUDE) {
-      // Add validations.
-      for (const auto& pair : current_target->validations()) {
-        work_queue.push_back(current_path);
-        work_queue.back().push_back(TargetDep(pair.ptr, DepType::VALIDATION));
-      }
-    }
+    // Add validations.
+    if (validation_deps == ValidationDeps::INCLUDE)
+      add_deps(current_target->validations(), DepType::VALIDATION);
   }
 }
 
-void DoSearch(const Target* from,
+void DoSearch(const TargetGraphIndex& index,
+              const Target* from,
               const Target* to,
               const Options& options,
               Stats* stats) {
-  BreadthFirstSearch(from, to, PrivateDeps::EXCLUDE, DataDeps::EXCLUDE,
+  BreadthFirstSearch(index, from, to, PrivateDeps::EXCLUDE, DataDeps::EXCLUDE,
                      ValidationDeps::EXCLUDE, options.print_what, stats);
   if (!options.public_only) {
     // Check private deps and validations.
-    BreadthFirstSearch(from, to, PrivateDeps::INCLUDE, DataDeps::EXCLUDE,
-                       ValidationDeps::INCLUDE, options.print_what, stats);
+    BreadthFirstSearch(index, from, to, PrivateDeps::INCLUDE,
+                       DataDeps::EXCLUDE, ValidationDeps::INCLUDE,
+                       options.print_what, stats);
     if (options.with_data) {
       // Check data deps.
-      BreadthFirstSearch(from, to, PrivateDeps::INCLUDE, DataDeps::INCLUDE,
-                         ValidationDeps::INCLUDE, options.print_what, stats);
+      BreadthFirstSearch(index, from, to, PrivateDeps::INCLUDE,
+                         DataDeps::INCLUDE, ValidationDeps::INCLUDE,
+                         options.print_what, stats);
     }
   }
 }
@@ -330,11 +383,8 @@ int RunPath(const std::vector<std::string>& args) {
     return 1;
   }
 
-  // Deliberately leaked to avoid expensive process teardown.
-  Setup* setup = new Setup;
-  if (!setup->DoSetup(args[0], false))
-    return 1;
-  if (!setup->Run())
+  Setup* setup = LoadSetupForQuery(args[0]);
+  if (!setup)
     return 1;
 
   const Target* target1 = ResolveTargetFromCommandLineString(setup, args[1]);
@@ -360,13 +410,15 @@ int RunPath(const std::vector<std::string>& args) {
     return 1;
   }
 
+  const TargetGraphIndex& index =
+      TargetGraphIndex::GetShared(setup->builder().GetAllResolvedTargets());
   Stats stats;
-  DoSearch(target1, target2, options, &stats);
+  DoSearch(index, target1, target2, options, &stats);
   if (stats.total_paths() == 0) {
     // If we don't find a path going "forwards", try the reverse direction.
     // Deps can only go in one direction without having a cycle, which will
     // have caused a run failure above.
-    DoSearch(target2, target1, options, &stats);
+    DoSearch(index, target2, target1, options, &stats);
   }
 
   // This string is inserted in the results to annotate whether the result
@@ -0,0 +1,294 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdio.h>
+
+#include <memory>
+#include <utility>
+
+#include "base/command_line.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/values.h"
+#include "gn/commands.h"
+#include "gn/setup.h"
+#include "gn/standard_out.h"
+#include "gn/string_utils.h"
+
+namespace commands {
+
+namespace {
+
+const char kSwitchBatch[] = "batch";
+
+// Non-null while "gn query --batch" answers requests.
+Setup* query_batch_setup = nullptr;
+
+// The "stdin" member of the request being answered, if any.
+const std::string* query_batch_stdin = nullptr;
+
+// Commands that can be sent to "gn query --batch".
+const char* const kQueryCommands[] = {kAnalyze, kDesc, kMeta,
+                                      kOutputs, kPath, kRefs};
+
+bool IsQueryCommand(const std::string& command) {
+  for (const char* cur : kQueryCommands) {
+    if (command == cur)
+      return true;
+  }
+  return false;
+}
+
+// Reads a line from |input|, without its terminating newline. Returns false
+// at the end of the input.
+bool ReadLine(FILE* input, std::string* line) {
+  line->clear();
+  char buffer[4 << 10];
+  bool read_any = false;
+  while (fgets(buffer, sizeof(buffer), input)) {
+    read_any = true;
+    line->append(buffer);
+    if (!line->empty() && line->back() == '\n') {
+      line->pop_back();
+      if (!line->empty() && line->back() == '\r')
+        line->pop_back();
+      return true;
+    }
+  }
+  return read_any;
+}
+
+// Writes the response to a request of the given |id|, which may be null, to
+// |file|.
+void WriteResponse(FILE* file,
+                   const base::Value* id,
+                   int exit_code,
+                   std::string output) {
+  base::DictionaryValue response;
+  response.SetKey("id", id ? id->Clone() : base::Value());
+  response.SetKey("exit_code", base::Value(exit_code));
+  response.SetKey("output", base::Value(std::move(output)));
+
+  std::string json;
+  base::JSONWriter::Write(response, &json);
+  json.push_back('\n');
+  fwrite(json.data(), 1, json.size(), file);
+  fflush(file);
+}
+
+// Builds the command line of |request| into |cmdline|: the command, the build
+// directory, the arguments and then the switches. Returns an error message on
+// failure.
+std::string GetRequestCommandLine(const std::string& build_dir,
+                                  const base::Value& request,
+                                  std::string* command,
+                                  base::CommandLine* cmdline) {
+  if (!request.is_dict())
+    return "The request is not a dictionary.";
+
+  const base::Value* command_value =
+      request.FindKeyOfType("command", base::Value::Type::STRING);
+  if (!command_value)
+    return "The request has no \"command\" string.";
+  *command = command_value->GetString();
+  if (!IsQueryCommand(*command))
+    return "\"" + *command + "\" can't be sent to \"gn query --batch\".";
+
+  cmdline->AppendArg(*command);
+  cmdline->AppendArg(build_dir);
+  if (const base::Value* args = request.FindKey("args")) {
+    if (!args->is_list())
+      return "\"args\" is not a list.";
+    for (const base::Value& arg : args->GetList()) {
+      if (!arg.is_string())
+        return "\"args\" contains a value that is not a string.";
+      cmdline->AppendArg(arg.GetString());
+    }
+  }
+  if (const base::Value* switches = request.FindKey("switches")) {
+    if (!switches->is_dict())
+      return "\"switches\" is not a dictionary.";
+    for (const auto& item : switches->DictItems()) {
+      if (item.second.is_string()) {
+        cmdline->AppendSwitch(item.first, item.second.GetString());
+      } else if (item.second.is_bool() && item.second.GetBool()) {
+        cmdline->AppendSwitch(item.first);
+      } else if (!item.second.is_bool()) {
+        return "The value of the switch \"" + item.first +
+               "\" is not a string or a boolean.";
+      }
+    }
+  }
+  return std::string();
+}
+
+// Runs |request| against the loaded setup and returns its exit code, with
+// what it printed in |output|.
+int RunRequest(const std::string& build_dir,
+               const base::Value& request,
+               std::string* output) {
+  std::string command;
+  base::CommandLine cmdline(base::CommandLine::NO_PROGRAM);
+  std::string error =
+      GetRequestCommandLine(build_dir, request, &command, &cmdline);
+  if (!error.empty()) {
+    *output = error + "\n";
+    return 1;
+  }
+
+  const base::Value* stdin_value =
+      request.FindKeyOfType("stdin", base::Value::Type::STRING);
+  query_batch_stdin = stdin_value ? &stdin_value->GetString() : nullptr;
+
+  // The commands read their switches from the command line of the process and
+  // from the global CommandSwitches, so both are swapped for the ones of the
+  // request while it runs.
+  base::CommandLine* process_cmdline = base::CommandLine::ForCurrentProcess();
+  base::CommandLine saved_cmdline = *process_cmdline;
+  *process_cmdline = cmdline;
+  CommandSwitches saved_switches = CommandSwitches::Set(CommandSwitches());
+
+  SetOutputCapture(output);
+  int exit_code = 1;
+  if (CommandSwitches::Init(cmdline)) {
+    std::vector<std::string> args = cmdline.GetArgs();
+    args.erase(args.begin());
+    exit_code = GetCommands().find(command)->second.runner(args);
+  } else {
+    // A failed Init() leaves the switches uninitialized, which Set() refuses
+    // to replace.
+    CommandSwitches::Init(base::CommandLine(base::CommandLine::NO_PROGRAM));
+  }
+  SetOutputCapture(nullptr);
+
+  CommandSwitches::Set(std::move(saved_switches));
+  *process_cmdline = saved_cmdline;
+  query_batch_stdin = nullptr;
+  return exit_code;
+}
+
+}  // namespace
+
+const char kQuery[] = "query";
+const char kQuery_HelpShort[] =
+    "query: Answer many queries after loading the build once.";
+const char kQuery_Help[] =
+    R"(gn query <out_dir> --batch
+
+  Loads the build once and then answers the queries read from the standard
+  input, so that scripts running many queries don't pay for loading the build
+  each time.
+
+  Each line of the input is a JSON dictionary describing a query:
+
+    {"id": 1, "command": "desc", "args": ["//base", "deps"],
+     "switches": {"format": "json", "all": true}}
+
+    id
+        Optional. Any JSON value, copied to the response to match it with the
+        query.
+
+    command
+        One of "analyze", "desc", "meta", "outputs", "path" and "refs".
+
+    args
+        Optional. The arguments of the command after <out_dir>.
+
+    switches
+        Optional. The command-line switches of the command, as strings for
+        switches with a value and as true for the others.
+
+    stdin
+        Optional. What the command reads when "-" is given for an input file,
+        like for "gn analyze".
+
+  Each query is answered with one line of JSON on the standard output, in
+  order, once it is done:
+
+    {"exit_code": 0, "id": 1, "output": "..."}
+
+    exit_code
+        What "gn <command>" would have returned.
+
+    output
+        What "gn <command>" would have printed.
+
+  The switches affecting how the build is loaded, like --args, --root or
+  --dotfile, are the ones given to "gn query". The print() calls of the build
+  files are silenced.
+
+Example
+
+  printf '%s\n' '{"id": 1, "command": "refs", "args": ["//base"]}' \
+      '{"id": 2, "command": "path", "args": ["//a", "//b"]}' |
+      gn query out/Default --batch
+)";
+
+int RunQuery(const std::vector<std::string>& args) {
+  const base::CommandLine* cmdline = base::CommandLine::ForCurrentProcess();
+  if (args.size() != 1 || !cmdline->HasSwitch(kSwitchBatch)) {
+    Err(Location(), "Unknown command format. See \"gn help query\"",
+        "Usage: \"gn query <out_dir> --batch\"")
+        .PrintToStdout();
+    return 1;
+  }
+  return RunQueryBatch(args[0], stdin, stdout);
+}
+
+int RunQueryBatch(const std::string& build_dir, FILE* input, FILE* output) {
+  // Deliberately leaked to avoid expensive process teardown.
+  Setup* setup = new Setup;
+  // The standard output is for the responses only.
+  setup->build_settings().set_print_callback([](const std::string&) {});
+  if (!setup->DoSetup(build_dir, false) || !setup->Run())
+    return 1;
+
+  query_batch_setup = setup;
+  std::string line;
+  while (ReadLine(input, &line)) {
+    if (line.find_first_not_of(" \t") == std::string::npos)
+      continue;
+
+    std::string error_message;
+    std::unique_ptr<base::Value> request = base::JSONReader::ReadAndReturnError(
+        line, base::JSONParserOptions::JSON_PARSE_RFC, nullptr,
+        &error_message);
+    if (!request) {
+      WriteResponse(output, nullptr, 1,
+                    "The request is not valid JSON: " + error_message + "\n");
+      continue;
+    }
+
+    const base::Value* id = request->is_dict() ? request->FindKey("id")
+                                               : nullptr;
+    std::string request_output;
+    int exit_code = RunRequest(build_dir, *request, &request_output);
+    WriteResponse(output, id, exit_code, std::move(request_output));
+  }
+  query_batch_setup = nullptr;
+  return 0;
+}
+
+Setup* GetQueryBatchSetup() {
+  return query_batch_setup;
+}
+
+Setup* LoadSetupForQuery(const std::string& build_dir) {
+  if (query_batch_setup)
+    return query_batch_setup;
+
+  // Deliberately leaked to avoid expensive process teardown.
+  Setup* setup = new Setup;
+  if (!setup->DoSetup(build_dir, false) || !setup->Run())
+    return nullptr;
+  return setup;
+}
+
+std::string ReadQueryStdin() {
+  if (query_batch_setup)
+    return query_batch_stdin ? *query_batch_stdin : std::string();
+  return ReadStdin();
+}
+
+}  // namespace commands
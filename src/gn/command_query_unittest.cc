@@ -0,0 +1,247 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/json/json_reader.h"
+#include "base/strings/string_split.h"
+#include "base/values.h"
+#include "gn/commands.h"
+#include "gn/filesystem_utils.h"
+#include "gn/switches.h"
+#include "gn/test_with_scheduler.h"
+#include "util/test/test.h"
+
+namespace {
+
+const char kDotfile[] = "buildconfig = \"//BUILDCONFIG.gn\"\n";
+
+const char kBuildConfig[] = "set_default_toolchain(\"//:tc\")\n";
+
+const char kBuildFile[] = R"(
+toolchain("tc") {
+  tool("cxx") {
+    command = "c++ {{source}} -o {{output}}"
+    outputs = [ "{{source_out_dir}}/{{label_name}}.{{source_name_part}}.o" ]
+  }
+  tool("stamp") {
+    command = "touch {{output}}"
+  }
+}
+
+source_set("a") {
+  sources = [ "a.cc" ]
+}
+
+group("b") {
+  deps = [ ":a" ]
+}
+
+group("c") {
+  deps = [ ":b" ]
+}
+)";
+
+class CommandQueryTest : public TestWithScheduler {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    base::FilePath source_dir =
+        base::MakeAbsoluteFilePath(temp_dir_.GetPath());
+    build_dir_ = source_dir.AppendASCII("out");
+    ASSERT_TRUE(base::CreateDirectory(build_dir_));
+    for (const auto& [name, contents] :
+         {std::pair{".gn", kDotfile}, std::pair{"BUILDCONFIG.gn", kBuildConfig},
+          std::pair{"BUILD.gn", kBuildFile}, std::pair{"a.cc", ""},
+          std::pair{"out/args.gn", ""}, std::pair{"out/build.ninja", ""}}) {
+      ASSERT_TRUE(WriteFile(source_dir.AppendASCII(name), contents, nullptr));
+    }
+
+    // The requests swap the command line of the process and the global
+    // switches for their own, which must be set beforehand like in main().
+    // --tree tells the switches of the process apart from empty ones.
+    process_cmdline_ = base::CommandLine(base::CommandLine::NO_PROGRAM);
+    process_cmdline_.AppendArg("query");
+    process_cmdline_.AppendSwitchPath(switches::kRoot, source_dir);
+    process_cmdline_.AppendSwitch("tree");
+    saved_cmdline_ = *base::CommandLine::ForCurrentProcess();
+    *base::CommandLine::ForCurrentProcess() = process_cmdline_;
+    ASSERT_TRUE(commands::CommandSwitches::Init(process_cmdline_));
+  }
+
+  void TearDown() override {
+    commands::CommandSwitches::Set(commands::CommandSwitches());
+    *base::CommandLine::ForCurrentProcess() = saved_cmdline_;
+  }
+
+  // Sends |requests| to "gn query --batch", one per line, and returns the
+  // parsed responses.
+  std::vector<base::Value> RunQuery(const std::vector<std::string>& requests) {
+    FILE* input = tmpfile();
+    FILE* output = tmpfile();
+    for (const std::string& request : requests)
+      fprintf(input, "%s\n", request.c_str());
+    rewind(input);
+    EXPECT_EQ(0, commands::RunQueryBatch(FilePathToUTF8(build_dir_), input,
+                                         output));
+    fclose(input);
+
+    std::string contents;
+    rewind(output);
+    char buffer[4 << 10];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), output)) > 0)
+      contents.append(buffer, size);
+    fclose(output);
+
+    std::vector<base::Value> responses;
+    for (const std::string& line :
+         base::SplitString(contents, "\n", base::KEEP_WHITESPACE,
+                           base::SPLIT_WANT_NONEMPTY)) {
+      std::unique_ptr<base::Value> response = base::JSONReader::Read(line);
+      EXPECT_TRUE(response && response->is_dict()) << line;
+      if (response)
+        responses.push_back(std::move(*response));
+    }
+    return responses;
+  }
+
+  static int GetExitCode(const base::Value& response) {
+    const base::Value* exit_code =
+        response.FindKeyOfType("exit_code", base::Value::Type::INTEGER);
+    return exit_code ? exit_code->GetInt() : -1;
+  }
+
+  static std::string GetOutput(const base::Value& response) {
+    const base::Value* output =
+        response.FindKeyOfType("output", base::Value::Type::STRING);
+    return output ? output->GetString() : std::string();
+  }
+
+  base::ScopedTempDir temp_dir_;
+  base::FilePath build_dir_;
+  base::CommandLine process_cmdline_{base::CommandLine::NO_PROGRAM};
+  base::CommandLine saved_cmdline_{base::CommandLine::NO_PROGRAM};
+};
+
+}  // namespace
+
+// Invalid requests get a response each, with the id of the request when it
+// has one.
+TEST_F(CommandQueryTest, InvalidRequests) {
+  std::vector<base::Value> responses = RunQuery({
+      "{\"id\": 1, \"command\": ",
+      "[\"desc\", \"//:a\"]",
+      "{\"id\": \"two\", \"args\": [\"//:a\"]}",
+      "{\"id\": [3], \"command\": \"gen\"}",
+      "{\"id\": 4, \"command\": \"desc\", \"args\": \"//:a\"}",
+  });
+  ASSERT_EQ(5u, responses.size());
+  for (const base::Value& response : responses)
+    EXPECT_EQ(1, GetExitCode(response));
+
+  EXPECT_EQ(base::Value(), *responses[0].FindKey("id"));
+  EXPECT_NE(std::string::npos, GetOutput(responses[0]).find("not valid JSON"));
+  EXPECT_EQ(base::Value(), *responses[1].FindKey("id"));
+  EXPECT_EQ("The request is not a dictionary.\n", GetOutput(responses[1]));
+  EXPECT_EQ(base::Value("two"), *responses[2].FindKey("id"));
+  EXPECT_EQ(base::Value::Type::LIST, responses[3].FindKey("id")->type());
+  EXPECT_NE(std::string::npos, GetOutput(responses[3]).find("\"gen\""));
+  EXPECT_EQ(base::Value(4), *responses[4].FindKey("id"));
+}
+
+TEST_F(CommandQueryTest, Switches) {
+  std::vector<base::Value> responses = RunQuery({
+      "{\"command\": \"desc\", \"args\": [\"//:c\", \"deps\"]}",
+      "{\"command\": \"desc\", \"args\": [\"//:c\", \"deps\"], "
+      "\"switches\": {\"all\": true}}",
+      "{\"command\": \"desc\", \"args\": [\"//:c\", \"deps\"], "
+      "\"switches\": {\"all\": false}}",
+      "{\"command\": \"desc\", \"args\": [\"//:c\", \"deps\"], "
+      "\"switches\": {\"format\": \"json\"}}",
+      "{\"command\": \"desc\", \"args\": [\"//:c\", \"deps\"], "
+      "\"switches\": {\"all\": 1}}",
+  });
+  ASSERT_EQ(5u, responses.size());
+
+  // Without --tree from the process, only the direct dependency is listed.
+  EXPECT_EQ(0, GetExitCode(responses[0]));
+  EXPECT_EQ("//:b\n", GetOutput(responses[0]));
+
+  // A true boolean is a switch without a value, and a false one is no switch.
+  EXPECT_EQ(0, GetExitCode(responses[1]));
+  EXPECT_EQ("//:a\n//:b\n", GetOutput(responses[1]));
+  EXPECT_EQ(0, GetExitCode(responses[2]));
+  EXPECT_EQ("//:b\n", GetOutput(responses[2]));
+
+  // A string is the value of the switch.
+  EXPECT_EQ(0, GetExitCode(responses[3]));
+  std::unique_ptr<base::Value> json =
+      base::JSONReader::Read(GetOutput(responses[3]));
+  ASSERT_TRUE(json && json->is_dict()) << GetOutput(responses[3]);
+  EXPECT_TRUE(json->FindKey("//:c"));
+
+  EXPECT_EQ(1, GetExitCode(responses[4]));
+  EXPECT_NE(std::string::npos, GetOutput(responses[4]).find("\"all\""));
+}
+
+TEST_F(CommandQueryTest, Stdin) {
+  std::vector<base::Value> responses = RunQuery({
+      "{\"command\": \"analyze\", \"args\": [\"-\", \"-\"], "
+      "\"stdin\": \"{\\\"files\\\": [\\\"//a.cc\\\"], "
+      "\\\"test_targets\\\": [\\\"//:c\\\"], "
+      "\\\"additional_compile_targets\\\": []}\"}",
+      "{\"command\": \"analyze\", \"args\": [\"-\", \"-\"]}",
+  });
+  ASSERT_EQ(2u, responses.size());
+
+  EXPECT_EQ(0, GetExitCode(responses[0])) << GetOutput(responses[0]);
+  std::unique_ptr<base::Value> result =
+      base::JSONReader::Read(GetOutput(responses[0]));
+  ASSERT_TRUE(result && result->is_dict()) << GetOutput(responses[0]);
+  const base::Value* status =
+      result->FindKeyOfType("status", base::Value::Type::STRING);
+  ASSERT_TRUE(status);
+  EXPECT_EQ("Found dependency", status->GetString());
+
+  // Without "stdin", the command reads an empty input rather than the
+  // requests, and reports it in its result.
+  EXPECT_EQ(0, GetExitCode(responses[1]));
+  EXPECT_NE(std::string::npos,
+            GetOutput(responses[1]).find("Input is not valid JSON"))
+      << GetOutput(responses[1]);
+}
+
+// Whether a request fails in its switches or in its command, the command
+// line and the switches of the process are restored for the next one.
+TEST_F(CommandQueryTest, RestoresProcessSwitches) {
+  std::vector<base::Value> responses = RunQuery({
+      "{\"command\": \"desc\", \"args\": [\"//:c\"], "
+      "\"switches\": {\"as\": \"nothing\"}}",
+      "{\"command\": \"desc\", \"args\": [\"//:missing\"], "
+      "\"switches\": {\"all\": true}}",
+      "{\"command\": \"desc\", \"args\": [\"//:c\", \"deps\"]}",
+  });
+  ASSERT_EQ(3u, responses.size());
+  EXPECT_EQ(1, GetExitCode(responses[0]));
+  EXPECT_NE(std::string::npos, GetOutput(responses[0]).find("--as"));
+  EXPECT_EQ(1, GetExitCode(responses[1]));
+
+  // The request doesn't see --tree from the process either.
+  EXPECT_EQ(0, GetExitCode(responses[2]));
+  EXPECT_EQ("//:b\n", GetOutput(responses[2]));
+
+  EXPECT_EQ(process_cmdline_.GetCommandLineString(),
+            base::CommandLine::ForCurrentProcess()->GetCommandLineString());
+  EXPECT_TRUE(commands::CommandSwitches::Get().has_tree());
+  EXPECT_FALSE(commands::CommandSwitches::Get().has_all());
+}
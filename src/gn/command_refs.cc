@@ -4,23 +4,22 @@
 
 #include <stddef.h>
 
-#include <map>
-#include <set>
+#include <vector>
 
 #include "base/command_line.h"
 #include "base/files/file_util.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "gn/commands.h"
-#include "gn/config_values_extractors.h"
-#include "gn/deps_iterator.h"
 #include "gn/filesystem_utils.h"
+#include "gn/graph_snapshot.h"
 #include "gn/input_file.h"
 #include "gn/item.h"
 #include "gn/setup.h"
 #include "gn/standard_out.h"
 #include "gn/switches.h"
 #include "gn/target.h"
+#include "gn/target_graph_index.h"
 #include "gn/unique_vector.h"
 
 namespace commands {
@@ -30,37 +29,16 @@ namespace {
 using TargetSet = TargetSet;
 using TargetVector = std::vector<const Target*>;
 
-// Maps targets to the list of targets that depend on them.
-using DepMap = std::multimap<const Target*, const Target*>;
-
-// Populates the reverse dependency map for the targets in the Setup.
-void FillDepMap(Setup* setup, DepMap* dep_map) {
-  for (auto* target : setup->builder().GetAllResolvedTargets()) {
-    for (const auto& dep_pair : target->GetDeps(Target::DEPS_ALL))
-      dep_map->insert(std::make_pair(dep_pair.ptr, target));
-    for (const auto& validation_pair : target->validations())
-      dep_map->insert(std::make_pair(validation_pair.ptr, target));
-  }
-}
-
-// Forward declaration for function below.
-size_t RecursivePrintTargetDeps(const DepMap& dep_map,
-                                const Target* target,
-                                TargetSet* seen_targets,
-                                int indent_level);
-
-// Prints the target and its dependencies in tree form. If the set is non-null,
-// new targets encountered will be added to the set, and if a ref is in the set
-// already, it will not be recused into. When the set is null, all refs will be
-// printed.
+// Prints one line of a tree of refs. If the set is non-null, the target is
+// added to it, and if it was there already it is printed with "..." when it
+// has refs, which are elided. When the set is null, all refs are printed.
 //
-// Returns the number of items printed.
-size_t RecursivePrintTarget(const DepMap& dep_map,
-                            const Target* target,
-                            TargetSet* seen_targets,
-                            int indent_level) {
+// Returns true if the refs of the target should be printed below it.
+bool PrintTreeLine(const TargetGraphIndex& index,
+                   const Target* target,
+                   TargetSet* seen_targets,
+                   int indent_level) {
   std::string indent(indent_level * 2, ' ');
-  size_t count = 1;
 
   // Only print the toolchain for non-default-toolchain targets.
   OutputString(indent + target->label().GetUserVisibleName(
@@ -73,92 +51,94 @@ size_t RecursivePrintTarget(const DepMap& dep_map,
       print_children = false;
       // Only print "..." if something is actually elided, which means that
       // the current target has children.
-      if (dep_map.lower_bound(target) != dep_map.upper_bound(target))
+      if (!index.GetRefs(target).empty())
         OutputString("...");
     }
   }
 
   OutputString("\n");
-  if (print_children) {
-    count += RecursivePrintTargetDeps(dep_map, target, seen_targets,
-                                      indent_level + 1);
-  }
-  return count;
+  return print_children;
 }
 
-// Prints refs of the given target (not the target itself). See
-// RecursivePrintTarget.
-size_t RecursivePrintTargetDeps(const DepMap& dep_map,
-                                const Target* target,
-                                TargetSet* seen_targets,
-                                int indent_level) {
-  DepMap::const_iterator dep_begin = dep_map.lower_bound(target);
-  DepMap::const_iterator dep_end = dep_map.upper_bound(target);
+// Prints refs of the given target (not the target itself) in tree form, in
+// depth-first order. See PrintTreeLine().
+//
+// Returns the number of items printed.
+size_t PrintTargetRefs(const TargetGraphIndex& index,
+                       const Target* target,
+                       TargetSet* seen_targets,
+                       int indent_level) {
+  // The trees can be very deep, so they are walked with an explicit stack.
+  struct Frame {
+    const std::vector<TargetGraphIndex::Ref>* refs;
+    size_t next;
+    int indent_level;
+  };
+  std::vector<Frame> stack;
+  stack.push_back(Frame{&index.GetRefs(target), 0, indent_level});
+
   size_t count = 0;
-  for (DepMap::const_iterator cur_dep = dep_begin; cur_dep != dep_end;
-       cur_dep++) {
-    count += RecursivePrintTarget(dep_map, cur_dep->second, seen_targets,
-                                  indent_level);
+  while (!stack.empty()) {
+    Frame& frame = stack.back();
+    if (frame.next == frame.refs->size()) {
+      stack.pop_back();
+      continue;
+    }
+    const Target* ref = (*frame.refs)[frame.next++].target;
+    int ref_indent_level = frame.indent_level;
+    count++;
+    if (PrintTreeLine(index, ref, seen_targets, ref_indent_level))
+      stack.push_back(Frame{&index.GetRefs(ref), 0, ref_indent_level + 1});
   }
   return count;
 }
 
-void RecursiveCollectChildRefs(const DepMap& dep_map,
-                               const Target* target,
-                               TargetSet* results);
-
-// Recursively finds all targets that reference the given one, and additionally
-// adds the current one to the list.
-void RecursiveCollectRefs(const DepMap& dep_map,
-                          const Target* target,
-                          TargetSet* results) {
-  if (!results->add(target))
-    return;  // Already found this target.
-  RecursiveCollectChildRefs(dep_map, target, results);
-}
-
-// Recursively finds all targets that reference the given one.
-void RecursiveCollectChildRefs(const DepMap& dep_map,
-                               const Target* target,
-                               TargetSet* results) {
-  DepMap::const_iterator dep_begin = dep_map.lower_bound(target);
-  DepMap::const_iterator dep_end = dep_map.upper_bound(target);
-  for (DepMap::const_iterator cur_dep = dep_begin; cur_dep != dep_end;
-       cur_dep++)
-    RecursiveCollectRefs(dep_map, cur_dep->second, results);
+// Prints the target and its refs in tree form. See PrintTreeLine().
+//
+// Returns the number of items printed.
+size_t PrintTarget(const TargetGraphIndex& index,
+                   const Target* target,
+                   TargetSet* seen_targets,
+                   int indent_level) {
+  size_t count = 1;
+  if (PrintTreeLine(index, target, seen_targets, indent_level))
+    count += PrintTargetRefs(index, target, seen_targets, indent_level + 1);
+  return count;
 }
 
-bool TargetReferencesConfig(const Target* target, const Config* config) {
-  for (const LabelConfigPair& cur : target->configs()) {
-    if (cur.ptr == config)
-      return true;
-  }
-  for (const LabelConfigPair& cur : target->public_configs()) {
-    if (cur.ptr == config)
-      return true;
+// Finds all targets that reference the given one, directly or not.
+void CollectChildRefs(const TargetGraphIndex& index,
+                      const Target* target,
+                      TargetSet* results) {
+  std::vector<const Target*> to_visit = {target};
+  while (!to_visit.empty()) {
+    const Target* current = to_visit.back();
+    to_visit.pop_back();
+    for (const TargetGraphIndex::Ref& ref : index.GetRefs(current)) {
+      if (results->add(ref.target))
+        to_visit.push_back(ref.target);
+    }
   }
-  return false;
 }
 
 void GetTargetsReferencingConfig(Setup* setup,
-                                 const std::vector<const Target*>& all_targets,
+                                 const TargetGraphIndex& index,
                                  const Config* config,
                                  bool default_toolchain_only,
                                  UniqueVector<const Target*>* matches) {
   Label default_toolchain = setup->loader()->default_toolchain_label();
-  for (auto* target : all_targets) {
+  for (auto* target : index.GetConfigRefs(config)) {
     if (default_toolchain_only) {
       // Only check targets in the default toolchain.
       if (target->label().GetToolchainLabel() != default_toolchain)
         continue;
     }
-    if (TargetReferencesConfig(target, config))
-      matches->push_back(target);
+    matches->push_back(target);
   }
 }
 
 // Returns the number of matches printed.
-size_t DoTreeOutput(const DepMap& dep_map,
+size_t DoTreeOutput(const TargetGraphIndex& index,
                     const UniqueVector<const Target*>& implicit_target_matches,
                     const UniqueVector<const Target*>& explicit_target_matches,
                     bool all) {
@@ -168,17 +148,17 @@ size_t DoTreeOutput(const DepMap& dep_map,
   // Implicit targets don't get printed themselves.
   for (const Target* target : implicit_target_matches) {
     if (all)
-      count += RecursivePrintTargetDeps(dep_map, target, nullptr, 0);
+      count += PrintTargetRefs(index, target, nullptr, 0);
     else
-      count += RecursivePrintTargetDeps(dep_map, target, &seen_targets, 0);
+      count += PrintTargetRefs(index, target, &seen_targets, 0);
   }
 
   // Explicit targets appear in the output.
   for (const Target* target : implicit_target_matches) {
     if (all)
-      count += RecursivePrintTarget(dep_map, target, nullptr, 0);
+      count += PrintTarget(index, target, nullptr, 0);
     else
-      count += RecursivePrintTarget(dep_map, target, &seen_targets, 0);
+      count += PrintTarget(index, target, &seen_targets, 0);
   }
 
   return count;
@@ -186,18 +166,18 @@ size_t DoTreeOutput(const DepMap& dep_map,
 
 // Returns the number of matches printed.
 size_t DoAllListOutput(
-    const DepMap& dep_map,
+    const TargetGraphIndex& index,
     const UniqueVector<const Target*>& implicit_target_matches,
     const UniqueVector<const Target*>& explicit_target_matches) {
   // Output recursive dependencies, uniquified and flattened.
   TargetSet results;
 
   for (const Target* target : implicit_target_matches)
-    RecursiveCollectChildRefs(dep_map, target, &results);
+    CollectChildRefs(index, target, &results);
   for (const Target* target : explicit_target_matches) {
     // Explicit targets also get added to the output themselves.
     results.insert(target);
-    RecursiveCollectChildRefs(dep_map, target, &results);
+    CollectChildRefs(index, target, &results);
   }
 
   FilterAndPrintTargetSet(false, results);
@@ -206,18 +186,15 @@ size_t DoAllListOutput(
 
 // Returns the number of matches printed.
 size_t DoDirectListOutput(
-    const DepMap& dep_map,
+    const TargetGraphIndex& index,
     const UniqueVector<const Target*>& implicit_target_matches,
     const UniqueVector<const Target*>& explicit_target_matches) {
   TargetSet results;
 
   // Output everything that refers to the implicit ones.
   for (const Target* target : implicit_target_matches) {
-    DepMap::const_iterator dep_begin = dep_map.lower_bound(target);
-    DepMap::const_iterator dep_end = dep_map.upper_bound(target);
-    for (DepMap::const_iterator cur_dep = dep_begin; cur_dep != dep_end;
-         cur_dep++)
-      results.insert(cur_dep->second);
+    for (const TargetGraphIndex::Ref& ref : index.GetRefs(target))
+      results.insert(ref.target);
   }
 
   // And just output the explicit ones directly (these are the target matches
@@ -262,6 +239,11 @@ const char kRefs_Help[] =
      This allows us to handle long lists of inputs without worrying about
      command line limits.
 
+  When all the inputs are targets and the build directory was generated with
+  "gn gen --graph-snapshot", the targets are loaded from the snapshot instead
+  of running the build files, unless a file read to generate the build changed
+  since. This is only done when printing labels and without --args.
+
 Options
 
   --all
@@ -382,11 +364,6 @@ int RunRefs(const std::vector<std::string>& args) {
   }
   bool default_toolchain_only = cmdline->HasSwitch(switches::kDefaultToolchain);
 
-  // Deliberately leaked to avoid expensive process teardown.
-  Setup* setup = new Setup;
-  if (!setup->DoSetup(args[0], false) || !setup->Run())
-    return 1;
-
   // The inputs are everything but the first arg (which is the build dir).
   std::vector<std::string> inputs;
   for (size_t i = 1; i < args.size(); i++) {
@@ -411,23 +388,47 @@ int RunRefs(const std::vector<std::string>& args) {
     }
   }
 
-  // Get the matches for the command-line input.
+  Setup* setup = GetQueryBatchSetup();
+  bool needs_run = !setup;
+  if (needs_run) {
+    // Deliberately leaked to avoid expensive process teardown.
+    setup = new Setup;
+    if (!setup->DoSetup(args[0], false))
+      return 1;
+  }
+
+  // When all the inputs are targets, the graph snapshot has all it takes to
+  // find what references them without running the build files. It is leaked
+  // like the setup.
   UniqueVector<const Target*> target_matches;
   UniqueVector<const Config*> config_matches;
   UniqueVector<const Toolchain*> toolchain_matches;
   UniqueVector<SourceFile> file_matches;
-  if (!ResolveFromCommandLineInput(setup, inputs, default_toolchain_only,
-                                   &target_matches, &config_matches,
-                                   &toolchain_matches, &file_matches))
-    return 1;
+  std::vector<const Target*> all_targets;
+  GraphSnapshot* snapshot = LoadGraphSnapshotForQuery(setup).release();
+  if (snapshot &&
+      ResolveTargetsFromGraphSnapshot(setup, *snapshot, inputs,
+                                      default_toolchain_only,
+                                      &target_matches)) {
+    all_targets = snapshot->targets();
+  } else {
+    target_matches.clear();
+    if (needs_run && !setup->Run())
+      return 1;
+
+    // Get the matches for the command-line input.
+    if (!ResolveFromCommandLineInput(setup, inputs, default_toolchain_only,
+                                     &target_matches, &config_matches,
+                                     &toolchain_matches, &file_matches))
+      return 1;
+    all_targets = setup->builder().GetAllResolvedTargets();
+  }
 
   // When you give a file or config as an input, you want the targets that are
   // associated with it. We don't want to just append this to the
   // target_matches, however, since these targets should actually be listed in
   // the output, while for normal targets you don't want to see the inputs,
   // only what refers to them.
-  std::vector<const Target*> all_targets =
-      setup->builder().GetAllResolvedTargets();
   UniqueVector<const Target*> explicit_target_matches;
   for (const auto& file : file_matches) {
     std::vector<TargetContainingFile> target_containing;
@@ -443,9 +444,9 @@ int RunRefs(const std::vector<std::string>& args) {
       explicit_target_matches.push_back(pair.first);
     }
   }
+  const TargetGraphIndex& index = TargetGraphIndex::GetShared(all_targets);
   for (auto* config : config_matches) {
-    GetTargetsReferencingConfig(setup, all_targets, config,
-                                default_toolchain_only,
+    GetTargetsReferencingConfig(setup, index, config, default_toolchain_only,
                                 &explicit_target_matches);
   }
 
@@ -462,17 +463,13 @@ int RunRefs(const std::vector<std::string>& args) {
     return 1;
   }
 
-  // Construct the reverse dependency tree.
-  DepMap dep_map;
-  FillDepMap(setup, &dep_map);
-
   size_t cnt = 0;
   if (tree)
-    cnt = DoTreeOutput(dep_map, target_matches, explicit_target_matches, all);
+    cnt = DoTreeOutput(index, target_matches, explicit_target_matches, all);
   else if (all)
-    cnt = DoAllListOutput(dep_map, target_matches, explicit_target_matches);
+    cnt = DoAllListOutput(index, target_matches, explicit_target_matches);
   else
-    cnt = DoDirectListOutput(dep_map, target_matches, explicit_target_matches);
+    cnt = DoDirectListOutput(index, target_matches, explicit_target_matches);
 
   // If you ask for the references of a valid target, but that target has
   // nothing referencing it, we'll get here without having printed anything.
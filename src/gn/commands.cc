@@ -6,7 +6,7 @@
 
 #include <algorithm>
 #include <fstream>
-#include <optional>
+#include <unordered_map>
 
 #include "base/command_line.h"
 #include "base/environment.h"
@@ -16,16 +16,18 @@
 #include "base/strings/utf_string_conversions.h"
 #include "base/values.h"
 #include "gn/builder.h"
-#include "gn/config_values_extractors.h"
 #include "gn/filesystem_utils.h"
+#include "gn/graph_snapshot.h"
 #include "gn/item.h"
 #include "gn/label.h"
 #include "gn/label_pattern.h"
+#include "gn/label_pattern_set.h"
 #include "gn/ninja_build_writer.h"
 #include "gn/setup.h"
 #include "gn/standard_out.h"
 #include "gn/switches.h"
 #include "gn/target.h"
+#include "gn/target_graph_index.h"
 #include "util/atomic_write.h"
 #include "util/build_config.h"
 
@@ -335,47 +337,6 @@ inline std::string FixGitBashLabelEdit(const std::string& label) {
 }
 #endif
 
-std::optional<HowTargetContainsFile> TargetContainsFile(
-    const Target* target,
-    const SourceFile& file) {
-  for (const auto& cur_file : target->sources()) {
-    if (cur_file == file)
-      return HowTargetContainsFile::kSources;
-  }
-  for (const auto& cur_file : target->public_headers()) {
-    if (cur_file == file)
-      return HowTargetContainsFile::kPublic;
-  }
-  for (ConfigValuesIterator iter(target); !iter.done(); iter.Next()) {
-    for (const auto& cur_file : iter.cur().inputs()) {
-      if (cur_file == file)
-        return HowTargetContainsFile::kInputs;
-    }
-  }
-  for (const auto& cur_file : target->data()) {
-    if (cur_file == file.value())
-      return HowTargetContainsFile::kData;
-    if (cur_file.back() == '/' && file.value().starts_with(cur_file))
-      return HowTargetContainsFile::kData;
-  }
-
-  if (target->action_values().script().value() == file.value())
-    return HowTargetContainsFile::kScript;
-
-  std::vector<SourceFile> output_sources;
-  target->action_values().GetOutputsAsSourceFiles(target, &output_sources);
-  for (const auto& cur_file : output_sources) {
-    if (cur_file == file)
-      return HowTargetContainsFile::kOutput;
-  }
-
-  for (const auto& cur_file : target->computed_outputs()) {
-    if (cur_file.AsSourceFile(target->settings()->build_settings()) == file)
-      return HowTargetContainsFile::kOutput;
-  }
-  return std::nullopt;
-}
-
 std::string ToUTF8(base::FilePath::StringType in) {
 #if defined(OS_WIN)
   return base::UTF16ToUTF8(in);
@@ -413,6 +374,7 @@ const CommandInfoMap& GetCommands() {
     INSERT_COMMAND(Ls)
     INSERT_COMMAND(Outputs)
     INSERT_COMMAND(Path)
+    INSERT_COMMAND(Query)
     INSERT_COMMAND(Refs)
     INSERT_COMMAND(Suggest)
     INSERT_COMMAND(CleanStale)
@@ -670,46 +632,87 @@ bool ResolveFromCommandLineInput(
   return true;
 }
 
+std::unique_ptr<GraphSnapshot> LoadGraphSnapshotForQuery(Setup* setup) {
+  const base::CommandLine* cmdline = base::CommandLine::ForCurrentProcess();
+  if (GetQueryBatchSetup() || cmdline->HasSwitch(switches::kArgs) ||
+      CommandSwitches::Get().target_print_mode() !=
+          CommandSwitches::TARGET_PRINT_LABEL) {
+    return nullptr;
+  }
+  return GraphSnapshot::LoadIfUpToDate(&setup->build_settings());
+}
+
+bool ResolveTargetsFromGraphSnapshot(
+    Setup* setup,
+    const GraphSnapshot& snapshot,
+    const std::vector<std::string>& input,
+    bool default_toolchain_only,
+    UniqueVector<const Target*>* target_matches) {
+  if (input.empty())
+    return false;
+
+  const BuildSettings& build_settings = setup->build_settings();
+  SourceDir cur_dir = SourceDirForCurrentDirectory(build_settings.root_path());
+  std::unordered_map<Label, const Target*> targets_by_label;
+  for (const auto& cur : input) {
+    Err err;
+    if (LabelPattern::HasWildcard(cur)) {
+      LabelPattern pattern =
+          LabelPattern::GetPattern(cur_dir, build_settings.root_path_utf8(),
+                                   Value(nullptr, cur), &err);
+      if (err.has_error())
+        return false;
+      // See ResolveTargetsFromCommandLinePattern().
+      if (default_toolchain_only && pattern.toolchain().is_null())
+        pattern.set_toolchain(snapshot.default_toolchain_label());
+      FilterTargetsByPatterns(snapshot.targets(), {pattern}, target_matches);
+      continue;
+    }
+
+    Label label = Label::Resolve(cur_dir, build_settings.root_path_utf8(),
+                                 snapshot.default_toolchain_label(),
+                                 Value(nullptr, cur), &err);
+    if (err.has_error())
+      return false;
+    if (targets_by_label.empty()) {
+      for (const Target* target : snapshot.targets())
+        targets_by_label.emplace(target->label(), target);
+    }
+    auto found = targets_by_label.find(label);
+    if (found == targets_by_label.end())
+      return false;
+    target_matches->push_back(found->second);
+  }
+  return true;
+}
+
 void FilterTargetsByPatterns(const std::vector<const Target*>& input,
                              const std::vector<LabelPattern>& filter,
                              std::vector<const Target*>* output) {
+  LabelPatternSet filter_set(filter);
   for (auto* target : input) {
-    for (const auto& pattern : filter) {
-      if (pattern.Matches(target->label())) {
-        output->push_back(target);
-        break;
-      }
-    }
+    if (filter_set.Matches(target->label()))
+      output->push_back(target);
   }
 }
 
 void FilterTargetsByPatterns(const std::vector<const Target*>& input,
                              const std::vector<LabelPattern>& filter,
                              UniqueVector<const Target*>* output) {
+  LabelPatternSet filter_set(filter);
   for (auto* target : input) {
-    for (const auto& pattern : filter) {
-      if (pattern.Matches(target->label())) {
-        output->push_back(target);
-        break;
-      }
-    }
+    if (filter_set.Matches(target->label()))
+      output->push_back(target);
   }
 }
 
 void FilterOutTargetsByPatterns(const std::vector<const Target*>& input,
                                 const std::vector<LabelPattern>& filter,
                                 std::vector<const Target*>* output) {
+  LabelPatternSet filter_set(filter);
   for (auto* target : input) {
-    bool match = false;
-    for (const auto& pattern : filter) {
-      if (pattern.Matches(target->label())) {
-        match = true;
-        break;
-      }
-    }
-    if (!match) {
+    if (!filter_set.Matches(target->label()))
       output->push_back(target);
-    }
   }
 }
 
@@ -790,14 +793,16 @@ void GetTargetsContainingFile(Setup* setup,
                               bool default_toolchain_only,
                               std::vector<TargetContainingFile>* matches) {
   Label default_toolchain = setup->loader()->default_toolchain_label();
-  for (auto* target : all_targets) {
+  std::vector<TargetContainingFile> all_matches;
+  TargetGraphIndex::GetShared(all_targets)
+      .GetTargetsContainingFile(file, &all_matches);
+  for (const TargetContainingFile& match : all_matches) {
     if (default_toolchain_only) {
       // Only check targets in the default toolchain.
-      if (target->label().GetToolchainLabel() != default_toolchain)
+      if (match.first->label().GetToolchainLabel() != default_toolchain)
         continue;
     }
-    if (auto how = TargetContainsFile(target, file))
-      matches->emplace_back(target, *how);
+    matches->push_back(match);
   }
 }
 
@@ -5,8 +5,11 @@
 #ifndef TOOLS_GN_COMMANDS_H_
 #define TOOLS_GN_COMMANDS_H_
 
+#include <stdio.h>
+
 #include <functional>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <string_view>
@@ -19,6 +22,7 @@
 
 class BuildSettings;
 class Config;
+class GraphSnapshot;
 class LabelPattern;
 class Setup;
 class SourceFile;
@@ -100,6 +104,11 @@ extern const char kPath_HelpShort[];
 extern const char kPath_Help[];
 int RunPath(const std::vector<std::string>& args);
 
+extern const char kQuery[];
+extern const char kQuery_HelpShort[];
+extern const char kQuery_Help[];
+int RunQuery(const std::vector<std::string>& args);
+
 extern const char kRefs[];
 extern const char kRefs_HelpShort[];
 extern const char kRefs_Help[];
@@ -329,6 +338,43 @@ bool ResolveFromCommandLineInput(
     UniqueVector<const Toolchain*>* toolchain_matches,
     UniqueVector<SourceFile>* file_matches);
 
+// Runs "gn query <build_dir> --batch" with the requests read from |input| and
+// the responses written to |output|.
+int RunQueryBatch(const std::string& build_dir, FILE* input, FILE* output);
+
+// Returns the setup loaded by "gn query --batch" while it answers a query, or
+// null otherwise.
+Setup* GetQueryBatchSetup();
+
+// Returns the setup of |build_dir| for a query command ("gn desc", "gn refs",
+// etc.) after running it: the one of "gn query --batch" if it is answering
+// the query, or a new one which is deliberately leaked to avoid expensive
+// process teardown. Returns null on failure, after printing the error.
+Setup* LoadSetupForQuery(const std::string& build_dir);
+
+// Returns what a query command reads when given "-" as an input file: the
+// standard input, or the "stdin" of the query "gn query --batch" answers.
+std::string ReadQueryStdin();
+
+// Loads the snapshot of the resolved targets that "gn gen --graph-snapshot"
+// wrote in the build directory of |setup|, if the current command can use it
+// instead of running |setup|: the snapshot must be up to date, the build
+// arguments must not be overridden with --args, the targets must be printed as
+// labels, and "gn query --batch" must not be answering the command, since it
+// has run its setup already. Returns null otherwise.
+std::unique_ptr<GraphSnapshot> LoadGraphSnapshotForQuery(Setup* setup);
+
+// Like ResolveFromCommandLineInput() but only resolves target labels and
+// patterns, against the targets of |snapshot|. Returns false without printing
+// anything if an input doesn't resolve that way, since it may name a config,
+// a toolchain or a file that only running the setup knows about.
+bool ResolveTargetsFromGraphSnapshot(
+    Setup* setup,
+    const GraphSnapshot& snapshot,
+    const std::vector<std::string>& input,
+    bool default_toolchain_only,
+    UniqueVector<const Target*>* target_matches);
+
 // Runs the header checker. All targets in the build should be given in
 // all_targets, and the specific targets to check should be in to_check.
 //
@@ -423,7 +469,9 @@ void FilterAndPrintTargetSet(bool indent, const TargetSet& targets);
 void FilterAndPrintTargetSet(const TargetSet& targets, base::ListValue* out);
 
 // Computes which targets reference the given file and also stores how the
-// target references the file.
+// target references the file. A target containing the file in several ways
+// is listed once, with the first way in this order. The lookup goes through
+// the shared TargetGraphIndex of |all_targets|.
 enum class HowTargetContainsFile {
   kSources,
   kPublic,
@@ -15,6 +15,7 @@
 #include "gn/config_values_extractors.h"
 #include "gn/deps_iterator.h"
 #include "gn/escape.h"
+#include "gn/label_pattern_set.h"
 #include "gn/ninja_module_writer_util.h"
 #include "gn/ninja_target_command_util.h"
 #include "gn/path_output.h"
@@ -364,8 +365,9 @@ std::vector<const Target*> CompileCommandsWriter::CollectTargets(
   // Collect the first level of target matches. These are the ones that the
   // patterns match directly.
   std::vector<const Target*> input_targets;
+  LabelPatternSet pattern_set(patterns);
   for (const Target* target : all_targets) {
-    if (LabelPattern::VectorMatches(patterns, target->label()))
+    if (pattern_set.Matches(target->label()))
       input_targets.push_back(target);
   }
 
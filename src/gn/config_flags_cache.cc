@@ -0,0 +1,112 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/config_flags_cache.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+#include "gn/escape.h"
+
+namespace {
+
+constexpr size_t kShardCount = 16;
+
+std::atomic<uint64_t> g_lookups{0};
+std::atomic<uint64_t> g_hits{0};
+std::atomic<size_t> g_entries{0};
+std::atomic<size_t> g_bytes{0};
+
+template <typename T>
+void AppendBytes(const T& value, std::string* key) {
+  key->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+}  // namespace
+
+struct alignas(64) ConfigFlagsCache::Shard {
+  std::mutex lock;
+  // Values are never removed, so pointers to them stay valid.
+  std::unordered_map<std::string, std::string> renderings;
+};
+
+ConfigFlagsCache::ConfigFlagsCache()
+    : shards_(std::make_unique<Shard[]>(kShardCount)) {}
+
+ConfigFlagsCache::~ConfigFlagsCache() = default;
+
+// static
+ConfigFlagsCache::Stats ConfigFlagsCache::GetStats() {
+  Stats stats;
+  stats.lookups = g_lookups.load(std::memory_order_relaxed);
+  stats.hits = g_hits.load(std::memory_order_relaxed);
+  stats.entries = g_entries.load(std::memory_order_relaxed);
+  stats.bytes = g_bytes.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void ConfigFlagsCache::WriteStrings(
+    const Substitution* field,
+    RecursiveWriterConfig config,
+    const Target* target,
+    const std::vector<std::string>& (ConfigValues::*getter)() const,
+    const EscapeOptions& escape_options,
+    std::ostream& out) {
+  std::string context;
+  AppendBytes(escape_options.mode, &context);
+  AppendBytes(escape_options.platform, &context);
+  AppendBytes(escape_options.inhibit_quoting, &context);
+  WriteCached(MakeKey(field, context, config, target, getter),
+              [&](std::ostream& rendered) {
+                RecursiveTargetConfigStringsToStream(
+                    config, target, getter, escape_options, rendered);
+              },
+              out);
+}
+
+// static
+std::string ConfigFlagsCache::MakeBaseKey(const Substitution* field,
+                                          std::string_view context,
+                                          RecursiveWriterConfig config,
+                                          const Target* target) {
+  const auto& configs = target->configs();
+  std::string key;
+  key.reserve(sizeof(field) + context.size() + 16 +
+              configs.size() * sizeof(const Config*));
+  AppendBytes(field, &key);
+  AppendBytes(config, &key);
+  AppendBytes(context.size(), &key);
+  key.append(context);
+  AppendBytes(configs.size(), &key);
+  for (const auto& pair : configs)
+    AppendBytes(pair.ptr, &key);
+  return key;
+}
+
+const std::string* ConfigFlagsCache::Find(const std::string& key) {
+  g_lookups.fetch_add(1, std::memory_order_relaxed);
+  Shard& shard = shards_[std::hash<std::string>()(key) % kShardCount];
+  std::lock_guard<std::mutex> lock(shard.lock);
+  auto found = shard.renderings.find(key);
+  if (found == shard.renderings.end())
+    return nullptr;
+  g_hits.fetch_add(1, std::memory_order_relaxed);
+  return &found->second;
+}
+
+const std::string& ConfigFlagsCache::Insert(std::string key,
+                                            std::string rendered) {
+  Shard& shard = shards_[std::hash<std::string>()(key) % kShardCount];
+  std::lock_guard<std::mutex> lock(shard.lock);
+  size_t size = rendered.size();
+  auto [it, inserted] =
+      shard.renderings.emplace(std::move(key), std::move(rendered));
+  if (inserted) {
+    g_entries.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+  }
+  return it->second;
+}
@@ -0,0 +1,135 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_CONFIG_FLAGS_CACHE_H_
+#define TOOLS_GN_CONFIG_FLAGS_CACHE_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gn/config_values_extractors.h"
+#include "gn/source_dir.h"
+
+struct Substitution;
+
+// Memoizes the flags that RecursiveTargetConfigToStream() renders for a
+// target, such as "defines" or "cflags_cc".
+//
+// Most targets get their flags from the same chains of configs, so the text
+// written for them is identical. The rendering is keyed by the ordered list
+// of configs, the values set on the target itself, and a context string that
+// the caller uses to describe everything else the writer depends on (the
+// escaping mode, the directory paths are relative to, etc.).
+//
+// Configs are identified by pointer, so they must not change once flags have
+// been written for a target using them. This is the case once they are
+// resolved. There is one cache per build (see BuildSettings), and it is
+// thread-safe.
+class ConfigFlagsCache {
+ public:
+  // Statistics for all the caches in the process, reported by --time.
+  struct Stats {
+    uint64_t lookups = 0;
+    uint64_t hits = 0;
+    size_t entries = 0;
+    size_t bytes = 0;  // Size of the cached renderings.
+  };
+
+  ConfigFlagsCache();
+  ~ConfigFlagsCache();
+
+  // Writes the same thing as RecursiveTargetConfigToStream(). |field|
+  // identifies |getter|.
+  template <typename T, class Writer>
+  void Write(const Substitution* field,
+             std::string_view context,
+             RecursiveWriterConfig config,
+             const Target* target,
+             const std::vector<T>& (ConfigValues::*getter)() const,
+             const Writer& writer,
+             std::ostream& out) {
+    WriteCached(MakeKey(field, context, config, target, getter),
+                [&](std::ostream& rendered) {
+                  RecursiveTargetConfigToStream<T>(config, target, getter,
+                                                   writer, rendered);
+                },
+                out);
+  }
+
+  // Writes the same thing as RecursiveTargetConfigStringsToStream().
+  void WriteStrings(
+      const Substitution* field,
+      RecursiveWriterConfig config,
+      const Target* target,
+      const std::vector<std::string>& (ConfigValues::*getter)() const,
+      const EscapeOptions& escape_options,
+      std::ostream& out);
+
+  static Stats GetStats();
+
+ private:
+  struct Shard;
+
+  template <typename T>
+  static std::string MakeKey(
+      const Substitution* field,
+      std::string_view context,
+      RecursiveWriterConfig config,
+      const Target* target,
+      const std::vector<T>& (ConfigValues::*getter)() const) {
+    std::string key = MakeBaseKey(field, context, config, target);
+    if (target->has_config_values()) {
+      for (const T& value : (target->config_values().*getter)())
+        AppendToKey(value, &key);
+    }
+    return key;
+  }
+
+  // Returns the part of the key that doesn't depend on the type of the
+  // values: everything but the values set on the target itself.
+  static std::string MakeBaseKey(const Substitution* field,
+                                 std::string_view context,
+                                 RecursiveWriterConfig config,
+                                 const Target* target);
+
+  static void AppendToKey(const std::string& value, std::string* key) {
+    key->append(value);
+    key->push_back('\0');
+  }
+  static void AppendToKey(const SourceDir& value, std::string* key) {
+    AppendToKey(value.value(), key);
+  }
+
+  // Writes the rendering for |key|, calling |render| to produce it if it's
+  // not cached yet.
+  template <class Render>
+  void WriteCached(std::string key, const Render& render, std::ostream& out) {
+    if (const std::string* cached = Find(key)) {
+      out << *cached;
+      return;
+    }
+    std::ostringstream rendered;
+    render(rendered);
+    out << Insert(std::move(key), rendered.str());
+  }
+
+  const std::string* Find(const std::string& key);
+
+  // Returns the rendering stored for |key|, which is |rendered| unless
+  // another thread got there first.
+  const std::string& Insert(std::string key, std::string rendered);
+
+  std::unique_ptr<Shard[]> shards_;
+
+  ConfigFlagsCache(const ConfigFlagsCache&) = delete;
+  ConfigFlagsCache& operator=(const ConfigFlagsCache&) = delete;
+};
+
+#endif  // TOOLS_GN_CONFIG_FLAGS_CACHE_H_
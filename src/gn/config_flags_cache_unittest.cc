@@ -0,0 +1,95 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/config_flags_cache.h"
+
+#include <sstream>
+
+#include "gn/c_substitution_type.h"
+#include "gn/config.h"
+#include "gn/escape.h"
+#include "gn/target.h"
+#include "gn/test_with_scope.h"
+#include "util/test/test.h"
+
+namespace {
+
+struct IncludeWriter {
+  void operator()(const SourceDir& dir, std::ostream& out) const {
+    out << " " << dir.value();
+  }
+};
+
+}  // namespace
+
+TEST(ConfigFlagsCache, SharesRenderings) {
+  TestWithScope setup;
+  Err err;
+
+  Config config(setup.settings(), Label(SourceDir("//foo/"), "config"));
+  config.visibility().SetPublic();
+  config.own_values().cflags().push_back("-a b");
+  config.own_values().include_dirs().push_back(SourceDir("//foo/include/"));
+  ASSERT_TRUE(config.OnResolved(&err));
+
+  Target first(setup.settings(), Label(SourceDir("//foo/"), "first"));
+  first.set_output_type(Target::SOURCE_SET);
+  first.SetToolchain(setup.toolchain());
+  first.configs().push_back(LabelConfigPair(&config));
+  ASSERT_TRUE(first.OnResolved(&err));
+
+  Target second(setup.settings(), Label(SourceDir("//foo/"), "second"));
+  second.set_output_type(Target::SOURCE_SET);
+  second.SetToolchain(setup.toolchain());
+  second.configs().push_back(LabelConfigPair(&config));
+  ASSERT_TRUE(second.OnResolved(&err));
+
+  // Same configs, but also values of its own.
+  Target third(setup.settings(), Label(SourceDir("//foo/"), "third"));
+  third.set_output_type(Target::SOURCE_SET);
+  third.SetToolchain(setup.toolchain());
+  third.config_values().cflags().push_back("-c");
+  third.configs().push_back(LabelConfigPair(&config));
+  ASSERT_TRUE(third.OnResolved(&err));
+
+  ConfigFlagsCache cache;
+  EscapeOptions escape_options;
+  escape_options.mode = ESCAPE_NINJA_COMMAND;
+  escape_options.platform = ESCAPE_PLATFORM_POSIX;
+  auto write_cflags = [&](const Target* target) {
+    std::ostringstream out;
+    cache.WriteStrings(&CSubstitutionCFlags, kRecursiveWriterKeepDuplicates,
+                       target, &ConfigValues::cflags, escape_options, out);
+    return out.str();
+  };
+
+  ConfigFlagsCache::Stats before = ConfigFlagsCache::GetStats();
+  EXPECT_EQ(" -a\\$ b", write_cflags(&first));
+  EXPECT_EQ(" -a\\$ b", write_cflags(&second));
+  EXPECT_EQ(" -c -a\\$ b", write_cflags(&third));
+  ConfigFlagsCache::Stats after = ConfigFlagsCache::GetStats();
+  EXPECT_EQ(3u, after.lookups - before.lookups);
+  EXPECT_EQ(1u, after.hits - before.hits);
+  EXPECT_EQ(2u, after.entries - before.entries);
+
+  // A different escaping mode is a different rendering.
+  escape_options.mode = ESCAPE_NONE;
+  EXPECT_EQ(" -a b", write_cflags(&first));
+
+  // As is a different field or context.
+  auto write_include_dirs = [&](const Target* target, const char* context) {
+    std::ostringstream out;
+    cache.Write<SourceDir>(&CSubstitutionIncludeDirs, context,
+                           kRecursiveWriterSkipDuplicates, target,
+                           &ConfigValues::include_dirs, IncludeWriter(), out);
+    return out.str();
+  };
+  before = ConfigFlagsCache::GetStats();
+  EXPECT_EQ(" //foo/include/", write_include_dirs(&first, "a"));
+  EXPECT_EQ(" //foo/include/", write_include_dirs(&third, "a"));
+  EXPECT_EQ(" //foo/include/", write_include_dirs(&second, "b"));
+  after = ConfigFlagsCache::GetStats();
+  EXPECT_EQ(1u, after.hits - before.hits);
+  EXPECT_EQ(2u, after.entries - before.entries);
+}
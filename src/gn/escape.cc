@@ -6,6 +6,7 @@
 
 #include <stddef.h>
 
+#include <bit>
 #include <memory>
 
 #include "base/compiler_specific.h"
@@ -13,6 +14,10 @@
 #include "base/logging.h"
 #include "util/build_config.h"
 
+#if defined(ARCH_CPU_X86_64)
+#include <emmintrin.h>
+#endif
+
 namespace {
 
 constexpr size_t kStackStringBufferSize = 1024;
@@ -239,6 +244,161 @@ size_t EscapeStringToString_PosixNinjaFork(std::string_view str,
   return i;
 }
 
+// Vectorized fast paths -------------------------------------------------------
+//
+// Most strings written to ninja files (paths, flags) need no escaping at all.
+// The fast paths find runs of characters that an escaping mode leaves
+// unchanged 16 at a time and copy them in bulk, leaving the other characters
+// to the scalar functions above. Each "Chars" class below defines the
+// characters that a mode leaves unchanged, both for one character and for a
+// vector of 16.
+
+// ESCAPE_NINJA.
+struct NinjaChars {
+  static bool IsUnchanged(char ch) { return !ShouldEscapeCharForNinja(ch); }
+#if defined(ARCH_CPU_X86_64)
+  static __m128i Changed(__m128i chars) {
+    return _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('$')),
+                     _mm_cmpeq_epi8(chars, _mm_set1_epi8(' '))),
+        _mm_cmpeq_epi8(chars, _mm_set1_epi8(':')));
+  }
+#endif
+};
+
+// ESCAPE_NINJA_PREFORMATTED_COMMAND.
+struct NinjaPreformattedChars {
+  static bool IsUnchanged(char ch) { return ch != '$'; }
+#if defined(ARCH_CPU_X86_64)
+  static __m128i Changed(__m128i chars) {
+    return _mm_cmpeq_epi8(chars, _mm_set1_epi8('$'));
+  }
+#endif
+};
+
+// ESCAPE_NINJA_COMMAND on Posix: the valid shell characters except ':'.
+struct PosixNinjaForkChars {
+  static bool IsUnchanged(char ch) {
+    return static_cast<unsigned char>(ch) < 0x80 &&
+           kShellValid[static_cast<int>(ch)] && ch != ':';
+  }
+#if defined(ARCH_CPU_X86_64)
+  // Returns whether the signed bytes of |chars| are in [first, last]. Bytes
+  // of 0x80 and up are negative, so they are never in range.
+  static __m128i InRange(__m128i chars, char first, char last) {
+    return _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8(first - 1)),
+                         _mm_cmplt_epi8(chars, _mm_set1_epi8(last + 1)));
+  }
+  static __m128i Changed(__m128i chars) {
+    __m128i unchanged = _mm_or_si128(
+        _mm_or_si128(InRange(chars, '+', '9'), InRange(chars, '@', 'Z')),
+        _mm_or_si128(InRange(chars, 'a', 'z'),
+                     _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('=')),
+                                  _mm_cmpeq_epi8(chars, _mm_set1_epi8('_')))));
+    return _mm_xor_si128(unchanged, _mm_set1_epi8(-1));
+  }
+#endif
+};
+
+// ESCAPE_NINJA_COMMAND on Windows, which quotes the whole string if it has a
+// space or a quote. Only used to check whole strings.
+struct WindowsNinjaForkChars {
+  static bool IsUnchanged(char ch) {
+    return ch != '"' && !ShouldEscapeCharForNinja(ch);
+  }
+#if defined(ARCH_CPU_X86_64)
+  static __m128i Changed(__m128i chars) {
+    return _mm_or_si128(NinjaChars::Changed(chars),
+                        _mm_cmpeq_epi8(chars, _mm_set1_epi8('"')));
+  }
+#endif
+};
+
+// Returns the length of the longest prefix of |str| that Chars leaves
+// unchanged.
+template <typename Chars>
+size_t UnchangedPrefixLength(std::string_view str) {
+  size_t i = 0;
+#if defined(ARCH_CPU_X86_64)
+  for (; i + 16 <= str.size(); i += 16) {
+    __m128i chars =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(str.data() + i));
+    unsigned changed = static_cast<unsigned>(
+        _mm_movemask_epi8(Chars::Changed(chars)));
+    if (changed)
+      return i + std::countr_zero(changed);
+  }
+#endif
+  while (i < str.size() && Chars::IsUnchanged(str[i]))
+    i++;
+  return i;
+}
+
+// Escapes |str| like |escape|, a scalar function escaping each character
+// independently, but copies the runs of characters that Chars leaves
+// unchanged in bulk.
+template <typename Chars, typename EscapeFunction>
+size_t EscapeStringToString_Fast(std::string_view str,
+                                 char* dest,
+                                 EscapeFunction escape) {
+  size_t i = 0;
+  while (!str.empty()) {
+    size_t unchanged = UnchangedPrefixLength<Chars>(str);
+    memcpy(dest + i, str.data(), unchanged);
+    i += unchanged;
+    if (unchanged == str.size())
+      break;
+    i += escape(str.substr(unchanged, 1), dest + i);
+    str.remove_prefix(unchanged + 1);
+  }
+  return i;
+}
+
+// Same as EscapeStringToString() (below) for the modes that have a fast path.
+// Returns false if |options| has none.
+bool EscapeStringToString_TryFast(std::string_view str,
+                                  const EscapeOptions& options,
+                                  char* dest,
+                                  size_t* written) {
+  switch (options.mode) {
+    case ESCAPE_NINJA:
+      *written = EscapeStringToString_Fast<NinjaChars>(
+          str, dest, [&](std::string_view ch, char* out) {
+            return EscapeStringToString_Ninja(ch, options, out, nullptr);
+          });
+      return true;
+    case ESCAPE_NINJA_PREFORMATTED_COMMAND:
+      *written = EscapeStringToString_Fast<NinjaPreformattedChars>(
+          str, dest, [](std::string_view ch, char* out) {
+            return EscapeStringToString_NinjaPreformatted(ch, out);
+          });
+      return true;
+    case ESCAPE_NINJA_COMMAND: {
+      bool windows = options.platform == ESCAPE_PLATFORM_WIN;
+#if defined(OS_WIN)
+      windows |= options.platform == ESCAPE_PLATFORM_CURRENT;
+#endif
+      if (windows) {
+        // Only the strings left unchanged can skip the scalar function,
+        // since the others may need to be quoted as a whole.
+        if (UnchangedPrefixLength<WindowsNinjaForkChars>(str) != str.size())
+          return false;
+        memcpy(dest, str.data(), str.size());
+        *written = str.size();
+        return true;
+      }
+      *written = EscapeStringToString_Fast<PosixNinjaForkChars>(
+          str, dest, [&](std::string_view ch, char* out) {
+            return EscapeStringToString_PosixNinjaFork(ch, options, out,
+                                                       nullptr);
+          });
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
 // Escapes |str| into |dest| and returns the number of characters written.
 size_t EscapeStringToString(std::string_view str,
                             const EscapeOptions& options,
@@ -284,21 +444,41 @@ size_t EscapeStringToString(std::string_view str,
   return 0;
 }
 
+// Same as EscapeStringToString() but uses the fast paths when possible.
+size_t EscapeStringToStringFast(std::string_view str,
+                                const EscapeOptions& options,
+                                char* dest,
+                                bool* needed_quoting) {
+  size_t written;
+  if (EscapeStringToString_TryFast(str, options, dest, &written))
+    return written;
+  return EscapeStringToString(str, options, dest, needed_quoting);
+}
+
 }  // namespace
 
 std::string EscapeString(std::string_view str,
                          const EscapeOptions& options,
                          bool* needed_quoting) {
   StackOrHeapBuffer dest(str.size() * kMaxEscapedCharsPerChar);
+  return std::string(
+      dest, EscapeStringToStringFast(str, options, dest, needed_quoting));
+}
+
+std::string EscapeStringWithoutFastPathsForTesting(std::string_view str,
+                                                   const EscapeOptions& options,
+                                                   bool* needed_quoting) {
+  StackOrHeapBuffer dest(str.size() * kMaxEscapedCharsPerChar);
   return std::string(dest,
                      EscapeStringToString(str, options, dest, needed_quoting));
 }
 
-void EscapeStringToStream(std::ostream& out,
+void EscapeStringToStream(OutputSink out,
                           std::string_view str,
                           const EscapeOptions& options) {
   StackOrHeapBuffer dest(str.size() * kMaxEscapedCharsPerChar);
-  out.write(dest, EscapeStringToString(str, options, dest, nullptr));
+  size_t size = EscapeStringToStringFast(str, options, dest, nullptr);
+  out.Append(std::string_view(dest, size));
 }
 
 void EscapeJSONStringToStream(std::ostream& out,
@@ -9,6 +9,8 @@
 #include <string>
 #include <string_view>
 
+#include "gn/output_sink.h"
+
 enum EscapingMode {
   // No escaping.
   ESCAPE_NONE,
@@ -76,9 +78,15 @@ std::string EscapeString(std::string_view str,
                          const EscapeOptions& options,
                          bool* needed_quoting);
 
-// Same as EscapeString but writes the results to the given stream, saving a
+// Same as EscapeString but without the vectorized fast paths, which must give
+// the same results.
+std::string EscapeStringWithoutFastPathsForTesting(std::string_view str,
+                                                   const EscapeOptions& options,
+                                                   bool* needed_quoting);
+
+// Same as EscapeString but writes the results to the given sink, saving a
 // copy.
-void EscapeStringToStream(std::ostream& out,
+void EscapeStringToStream(OutputSink out,
                           std::string_view str,
                           const EscapeOptions& options);
 
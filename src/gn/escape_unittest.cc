@@ -3,9 +3,56 @@
 // found in the LICENSE file.
 
 #include "gn/escape.h"
+
+#include <string>
+#include <vector>
+
 #include "gn/string_output_buffer.h"
 #include "util/test/test.h"
 
+namespace {
+
+// The modes that have vectorized fast paths.
+std::vector<EscapeOptions> GetFastPathOptions() {
+  std::vector<EscapeOptions> result;
+  EscapeOptions opts;
+  opts.mode = ESCAPE_NINJA;
+  result.push_back(opts);
+  opts.mode = ESCAPE_NINJA_PREFORMATTED_COMMAND;
+  result.push_back(opts);
+  opts.mode = ESCAPE_NINJA_COMMAND;
+  for (EscapingPlatform platform :
+       {ESCAPE_PLATFORM_CURRENT, ESCAPE_PLATFORM_POSIX, ESCAPE_PLATFORM_WIN}) {
+    opts.platform = platform;
+    opts.inhibit_quoting = false;
+    result.push_back(opts);
+    opts.inhibit_quoting = true;
+    result.push_back(opts);
+  }
+  return result;
+}
+
+// Windows command escaping doesn't support whitespace other than spaces.
+bool IsSupported(const EscapeOptions& opts, char ch) {
+  bool windows = opts.mode == ESCAPE_NINJA_COMMAND &&
+                 opts.platform != ESCAPE_PLATFORM_POSIX;
+  return !windows || (ch != '\t' && ch != '\n' && ch != '\v' && ch != '\r');
+}
+
+// Checks that the fast paths escape |str| like the scalar code.
+void ExpectSameAsScalar(const EscapeOptions& opts, std::string_view str) {
+  bool fast_quoting = false;
+  bool scalar_quoting = false;
+  std::string fast = EscapeString(str, opts, &fast_quoting);
+  std::string scalar =
+      EscapeStringWithoutFastPathsForTesting(str, opts, &scalar_quoting);
+  EXPECT_TRUE(fast == scalar && fast_quoting == scalar_quoting)
+      << "Mode " << opts.mode << " platform " << opts.platform << " escaped \""
+      << str << "\" as \"" << fast << "\" instead of \"" << scalar << "\"";
+}
+
+}  // namespace
+
 TEST(Escape, Ninja) {
   EscapeOptions opts;
   opts.mode = ESCAPE_NINJA;
@@ -110,3 +157,37 @@ TEST(Escape, CompilationDatabase) {
   std::string result = EscapeString("asdf:$ \\#*[|]bar", opts, nullptr);
   EXPECT_EQ("\"asdf:$ \\\\#*[|]bar\"", result);
 }
+
+TEST(Escape, FastPathsMatchScalar) {
+  for (const EscapeOptions& opts : GetFastPathOptions()) {
+    // Every character alone, and at each position of strings spanning several
+    // vectors, so it's found at every offset of a vector and in the tail.
+    for (int c = 0; c < 256; c++) {
+      char ch = static_cast<char>(c);
+      if (!IsSupported(opts, ch))
+        continue;
+      ExpectSameAsScalar(opts, std::string(1, ch));
+      for (size_t size : {15, 16, 17, 31, 32, 33, 47}) {
+        std::string str(size, 'a');
+        for (size_t pos = 0; pos < size; pos++) {
+          str[pos] = ch;
+          ExpectSameAsScalar(opts, str);
+          str[pos] = 'a';
+        }
+      }
+    }
+
+    // Every pair of characters next to each other and a vector apart.
+    for (int a = 0; a < 256; a++) {
+      for (int b = 0; b < 256; b++) {
+        if (!IsSupported(opts, a) || !IsSupported(opts, b))
+          continue;
+        std::string str(40, '/');
+        str[14] = static_cast<char>(a);
+        str[15] = static_cast<char>(b);
+        str[31] = static_cast<char>(b);
+        ExpectSameAsScalar(opts, str);
+      }
+    }
+  }
+}
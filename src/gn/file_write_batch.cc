@@ -0,0 +1,78 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/file_write_batch.h"
+
+#include <utility>
+
+#include "gn/string_output_buffer.h"
+
+FileWriteBatch* FileWriteBatch::active_ = nullptr;
+
+FileWriteBatch::FileWriteBatch(size_t thread_count) : pool_(thread_count) {}
+
+FileWriteBatch::~FileWriteBatch() {
+  std::unique_lock<std::mutex> lock(lock_);
+  pending_cv_.wait(lock, [this]() { return pending_ == 0; });
+}
+
+void FileWriteBatch::Add(const base::FilePath& file_path,
+                         std::unique_ptr<StringOutputBuffer> contents) {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    ++pending_;
+  }
+  // WorkerPool tasks must be copyable, so the task owns the raw pointer.
+  pool_.PostTask([this, file_path, contents = contents.release()]() {
+    std::unique_ptr<StringOutputBuffer> owned(contents);
+    Write(file_path, *owned);
+    owned.reset();
+
+    std::lock_guard<std::mutex> lock(lock_);
+    if (--pending_ == 0)
+      pending_cv_.notify_all();
+  });
+}
+
+bool FileWriteBatch::Finish(Err* err) {
+  std::unique_lock<std::mutex> lock(lock_);
+  pending_cv_.wait(lock, [this]() { return pending_ == 0; });
+  if (first_error_.has_error()) {
+    *err = first_error_;
+    return false;
+  }
+  return true;
+}
+
+// static
+void FileWriteBatch::WriteFileIfChanged(
+    const base::FilePath& file_path,
+    std::unique_ptr<StringOutputBuffer> contents) {
+  if (active_)
+    active_->Add(file_path, std::move(contents));
+  else
+    contents->WriteToFileIfChanged(file_path, nullptr);
+}
+
+void FileWriteBatch::Write(const base::FilePath& file_path,
+                           const StringOutputBuffer& contents) {
+  Err err;
+  if (EnsureDirectory(file_path.DirName(), &err))
+    contents.WriteToFileIfChangedImpl(file_path, false, &err);
+  if (err.has_error()) {
+    std::lock_guard<std::mutex> lock(lock_);
+    if (!first_error_.has_error())
+      first_error_ = err;
+  }
+}
+
+bool FileWriteBatch::EnsureDirectory(const base::FilePath& dir, Err* err) {
+  std::lock_guard<std::mutex> lock(dirs_lock_);
+  if (dirs_.count(dir.value()))
+    return true;
+  if (!StringOutputBuffer::MakeDirectory(dir, err))
+    return false;
+  dirs_.insert(dir.value());
+  return true;
+}
@@ -0,0 +1,80 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_FILE_WRITE_BATCH_H_
+#define TOOLS_GN_FILE_WRITE_BATCH_H_
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include "base/files/file_path.h"
+#include "gn/err.h"
+#include "util/worker_pool.h"
+
+class StringOutputBuffer;
+
+// Writes output files from a dedicated pool of I/O threads, so that the
+// threads generating them don't wait for the disk.
+//
+// Files are written with StringOutputBuffer::WriteToFileIfChanged(), except
+// that each directory is only created once for the whole batch instead of
+// being looked up again for every file written to it.
+//
+// Only files that nothing reads back before Finish() can be added: "gn gen"
+// uses it for the ninja files of the targets and their generated module
+// maps, not for write_file() whose result may be read by the build files.
+// Thread-safe.
+class FileWriteBatch {
+ public:
+  explicit FileWriteBatch(size_t thread_count);
+  ~FileWriteBatch();
+
+  // Queues |contents| to be written to |file_path| if it changed.
+  void Add(const base::FilePath& file_path,
+           std::unique_ptr<StringOutputBuffer> contents);
+
+  // Waits for the queued files to be written. Returns false and sets |err|
+  // to the first error if any of them failed.
+  bool Finish(Err* err);
+
+  // Writes |contents| to |file_path| if it changed, through the active batch
+  // if there is one or right away otherwise.
+  static void WriteFileIfChanged(const base::FilePath& file_path,
+                                 std::unique_ptr<StringOutputBuffer> contents);
+
+  // The batch used by WriteFileIfChanged(), if any. Must not be changed while
+  // files are being written.
+  static FileWriteBatch* active() { return active_; }
+  static void set_active(FileWriteBatch* batch) { active_ = batch; }
+
+ private:
+  void Write(const base::FilePath& file_path,
+             const StringOutputBuffer& contents);
+
+  // Creates |dir| unless it was already created for this batch.
+  bool EnsureDirectory(const base::FilePath& dir, Err* err);
+
+  std::mutex lock_;
+  std::condition_variable pending_cv_;
+  size_t pending_ = 0;
+  Err first_error_;
+
+  // Directories created for this batch, guarded by |dirs_lock_|. It's held
+  // while a directory is being created so that the other threads writing to
+  // it wait for it.
+  std::mutex dirs_lock_;
+  std::unordered_set<base::FilePath::StringType> dirs_;
+
+  WorkerPool pool_;  // Last so that its threads stop first.
+
+  static FileWriteBatch* active_;
+
+  FileWriteBatch(const FileWriteBatch&) = delete;
+  FileWriteBatch& operator=(const FileWriteBatch&) = delete;
+};
+
+#endif  // TOOLS_GN_FILE_WRITE_BATCH_H_
@@ -0,0 +1,79 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/file_write_batch.h"
+
+#include <memory>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "gn/err.h"
+#include "gn/filesystem_utils.h"
+#include "gn/string_output_buffer.h"
+#include "util/test/test.h"
+
+namespace {
+
+std::unique_ptr<StringOutputBuffer> MakeContents(const std::string& str) {
+  auto contents = std::make_unique<StringOutputBuffer>();
+  contents->Append(str);
+  return contents;
+}
+
+}  // namespace
+
+TEST(FileWriteBatch, WritesFiles) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath dir_a = temp_dir.GetPath().AppendASCII("a");
+  base::FilePath dir_b = temp_dir.GetPath().AppendASCII("b").AppendASCII("c");
+
+  StringOutputBuffer::IoStats before = StringOutputBuffer::GetIoStats();
+  FileWriteBatch batch(3);
+  for (int i = 0; i < 10; ++i) {
+    std::string name = "file" + std::to_string(i) + ".ninja";
+    batch.Add(dir_a.AppendASCII(name), MakeContents("a" + std::to_string(i)));
+    batch.Add(dir_b.AppendASCII(name), MakeContents("b" + std::to_string(i)));
+  }
+  Err err;
+  ASSERT_TRUE(batch.Finish(&err));
+  StringOutputBuffer::IoStats after = StringOutputBuffer::GetIoStats();
+
+  EXPECT_EQ(20u, after.files_written - before.files_written);
+  // Each directory is only made once.
+  EXPECT_EQ(2u, after.directories_made - before.directories_made);
+  EXPECT_TRUE(ContentsEqual(dir_a.AppendASCII("file0.ninja"), "a0"));
+  EXPECT_TRUE(ContentsEqual(dir_b.AppendASCII("file9.ninja"), "b9"));
+
+  // Rewriting the same contents doesn't write anything.
+  FileWriteBatch::set_active(&batch);
+  FileWriteBatch::WriteFileIfChanged(dir_a.AppendASCII("file0.ninja"),
+                                     MakeContents("a0"));
+  FileWriteBatch::WriteFileIfChanged(dir_a.AppendASCII("file1.ninja"),
+                                     MakeContents("changed"));
+  FileWriteBatch::set_active(nullptr);
+  ASSERT_TRUE(batch.Finish(&err));
+  StringOutputBuffer::IoStats last = StringOutputBuffer::GetIoStats();
+  EXPECT_EQ(1u, last.files_written - after.files_written);
+  EXPECT_EQ(0u, last.directories_made - after.directories_made);
+  EXPECT_TRUE(ContentsEqual(dir_a.AppendASCII("file1.ninja"), "changed"));
+}
+
+TEST(FileWriteBatch, ReportsErrors) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+
+  // A file can't be created in a directory that is a file.
+  base::FilePath not_a_dir = temp_dir.GetPath().AppendASCII("file");
+  ASSERT_TRUE(WriteFile(not_a_dir, "", nullptr));
+
+  FileWriteBatch batch(2);
+  batch.Add(temp_dir.GetPath().AppendASCII("ok.ninja"), MakeContents("ok"));
+  batch.Add(not_a_dir.AppendASCII("foo.ninja"), MakeContents("foo"));
+  Err err;
+  EXPECT_FALSE(batch.Finish(&err));
+  EXPECT_TRUE(err.has_error());
+  EXPECT_TRUE(ContentsEqual(temp_dir.GetPath().AppendASCII("ok.ninja"), "ok"));
+}
@@ -8,6 +8,7 @@
 #include "gn/err.h"
 #include "gn/functions.h"
 #include "gn/label_pattern.h"
+#include "gn/label_pattern_set.h"
 #include "gn/parse_tree.h"
 #include "gn/scope.h"
 #include "gn/settings.h"
@@ -59,6 +60,7 @@ Value RunFilterLabels(Scope* scope,
   }
 
   // Iterate over "labels", resolving and matching against the list of patterns.
+  LabelPatternSet pattern_set(patterns);
   Value result(function, Value::LIST);
   for (const auto& value : args[0].list_value()) {
     Label label =
@@ -72,7 +74,7 @@ Value RunFilterLabels(Scope* scope,
       return Value();
     }
 
-    const bool matches_pattern = LabelPattern::VectorMatches(patterns, label);
+    const bool matches_pattern = pattern_set.Matches(label);
     switch (selection) {
       case kIncludeFilter:
         if (matches_pattern)
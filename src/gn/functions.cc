@@ -1572,6 +1572,21 @@ Value RunFunction(Scope* scope,
                   const ListNode* args_list,
                   BlockNode* block,
                   Err* err) {
+  const FunctionInfoMap& function_map = GetFunctions();
+  FunctionInfoMap::const_iterator found_function =
+      function_map.find(function->function().value());
+  return RunResolvedFunction(
+      scope, function, args_list, block,
+      found_function == function_map.end() ? nullptr : &found_function->second,
+      err);
+}
+
+Value RunResolvedFunction(Scope* scope,
+                          const FunctionCallNode* function,
+                          const ListNode* args_list,
+                          BlockNode* block,
+                          const FunctionInfo* builtin,
+                          Err* err) {
   const Token& name = function->function();
 
   std::string template_name(function->function().value());
@@ -1585,24 +1600,21 @@ Value RunFunction(Scope* scope,
   }
 
   // No template matching this, check for a built-in function.
-  const FunctionInfoMap& function_map = GetFunctions();
-  FunctionInfoMap::const_iterator found_function =
-      function_map.find(name.value());
-  if (found_function == function_map.end()) {
+  if (!builtin) {
     *err = Err(name, "Unknown function.");
     return Value();
   }
 
-  if (found_function->second.self_evaluating_args_runner) {
+  if (builtin->self_evaluating_args_runner) {
     // Self evaluating args functions are special weird built-ins like foreach.
     // Rather than force them all to check that they have a block or no block
     // and risk bugs for new additions, check an allowlist here.
-    if (found_function->second.self_evaluating_args_runner != &RunForEach) {
+    if (builtin->self_evaluating_args_runner != &RunForEach) {
       if (!VerifyNoBlockForFunctionCall(function, block, err))
         return Value();
     }
-    return found_function->second.self_evaluating_args_runner(scope, function,
-                                                              args_list, err);
+    return builtin->self_evaluating_args_runner(scope, function, args_list,
+                                                err);
   }
 
   // All other function types take a pre-executed set of args.
@@ -1610,16 +1622,16 @@ Value RunFunction(Scope* scope,
   if (err->has_error())
     return Value();
 
-  if (found_function->second.generic_block_runner) {
+  if (builtin->generic_block_runner) {
     if (!block) {
       FillNeedsBlockError(function, err);
       return Value();
     }
-    return found_function->second.generic_block_runner(
-        scope, function, args.list_value(), block, err);
+    return builtin->generic_block_runner(scope, function, args.list_value(),
+                                         block, err);
   }
 
-  if (found_function->second.executed_block_runner) {
+  if (builtin->executed_block_runner) {
     if (!block) {
       FillNeedsBlockError(function, err);
       return Value();
@@ -1630,8 +1642,8 @@ Value RunFunction(Scope* scope,
     if (err->has_error())
       return Value();
 
-    Value result = found_function->second.executed_block_runner(
-        function, args.list_value(), &block_scope, err);
+    Value result = builtin->executed_block_runner(function, args.list_value(),
+                                                  &block_scope, err);
     if (err->has_error())
       return Value();
 
@@ -1643,8 +1655,7 @@ Value RunFunction(Scope* scope,
   // Otherwise it's a no-block function.
   if (!VerifyNoBlockForFunctionCall(function, block, err))
     return Value();
-  return found_function->second.no_block_runner(scope, function,
-                                                args.list_value(), err);
+  return builtin->no_block_runner(scope, function, args.list_value(), err);
 }
 
 }  // namespace functions
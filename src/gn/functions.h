@@ -509,6 +509,16 @@ Value RunFunction(Scope* scope,
                   BlockNode* block,  // Optional.
                   Err* err);
 
+// Like RunFunction, but with the built-in function already looked up by the
+// caller. |builtin| is null when there is no built-in with the function's
+// name. Templates defined in the scope still take precedence.
+Value RunResolvedFunction(Scope* scope,
+                          const FunctionCallNode* function,
+                          const ListNode* args_list,
+                          BlockNode* block,  // Optional.
+                          const FunctionInfo* builtin,
+                          Err* err);
+
 }  // namespace functions
 
 // Helper functions -----------------------------------------------------------
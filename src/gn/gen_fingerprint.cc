@@ -0,0 +1,194 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/gen_fingerprint.h"
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string_view>
+
+#include "base/command_line.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "gn/err.h"
+#include "gn/filesystem_utils.h"
+#include "gn/parallel_for.h"
+#include "gn/switches.h"
+#include "util/atomic_write.h"
+
+#include "last_commit_position.h"
+
+namespace {
+
+const char kHeader[] = "# gn gen fingerprint v1\n";
+
+// Written while a run is in progress, which doesn't match any fingerprint.
+const char kIncomplete[] = "# gn gen fingerprint: incomplete\n";
+
+// Recorded for a file that didn't exist.
+const char kMissing[] = "-";
+
+// Below this, checking the files isn't worth a thread.
+constexpr size_t kMinFilesPerThread = 256;
+
+// Switches which don't change the generated files.
+bool IsIgnoredSwitch(std::string_view name) {
+  return name == switches::kColor || name == switches::kNoColor ||
+         name == switches::kQuiet || name == switches::kRegeneration ||
+         name == switches::kTime || name == switches::kTracelog ||
+         name == switches::kVerbose;
+}
+
+// Returns what precedes the files in the fingerprint of |cmdline|: the
+// header, the version of GN and the switches, one per line.
+std::string GetFingerprintPrefix(const base::CommandLine& cmdline) {
+  std::string result(kHeader);
+  result.append("version ");
+  result.append(LAST_COMMIT_POSITION);
+  result.push_back('\n');
+  for (const auto& [name, value] : cmdline.GetSwitches()) {
+    if (IsIgnoredSwitch(name))
+      continue;
+    // The value of --args may span several lines.
+    std::string line = name + "=" + FilePathToUTF8(value);
+    base::ReplaceSubstringsAfterOffset(&line, 0, "\\", "\\\\");
+    base::ReplaceSubstringsAfterOffset(&line, 0, "\n", "\\n");
+    result.append("switch ");
+    result.append(line);
+    result.push_back('\n');
+  }
+  return result;
+}
+
+base::FilePath GetFilePath(const base::FilePath& build_dir,
+                           std::string_view file) {
+  base::FilePath path = UTF8ToFilePath(file);
+  return path.IsAbsolute() ? path : build_dir.Append(path);
+}
+
+// Returns the line of |file| in a fingerprint: "<mtime> <size> <path>", or
+// "- - <path>" if it doesn't exist. The path comes last since it may contain
+// spaces.
+std::string GetFileLine(const base::FilePath& build_dir,
+                        std::string_view file,
+                        Ticks* last_modified) {
+  std::string line;
+  base::File::Info info;
+  if (base::GetFileInfo(GetFilePath(build_dir, file), &info)) {
+    *last_modified = info.last_modified;
+    line = base::NumberToString(
+               static_cast<unsigned long long>(info.last_modified)) +
+           " " + base::NumberToString(static_cast<long long>(info.size));
+  } else {
+    *last_modified = 0;
+    line = std::string(kMissing) + " " + kMissing;
+  }
+  line.push_back(' ');
+  line.append(file);
+  return line;
+}
+
+}  // namespace
+
+const char kGenFingerprintFileName[] = "build.ninja.fingerprint";
+
+Ticks InvalidateGenFingerprint(const base::FilePath& build_dir) {
+  base::FilePath path = build_dir.AppendASCII(kGenFingerprintFileName);
+  base::File::Info info;
+  // On the first run, the build directory doesn't exist yet.
+  if (!base::CreateDirectory(build_dir) ||
+      base::WriteFile(path, kIncomplete, sizeof(kIncomplete) - 1) !=
+          static_cast<int>(sizeof(kIncomplete) - 1) ||
+      !base::GetFileInfo(path, &info)) {
+    return 0;
+  }
+  return info.last_modified;
+}
+
+bool WriteGenFingerprint(const base::FilePath& build_dir,
+                         const base::CommandLine& cmdline,
+                         const std::vector<std::string>& inputs,
+                         const std::vector<std::string>& outputs,
+                         Ticks start_time,
+                         Err* err) {
+  std::vector<std::string> files(inputs);
+  files.insert(files.end(), outputs.begin(), outputs.end());
+  std::vector<std::string> lines(files.size());
+  std::atomic<bool> modified = false;
+  ParallelFor(files.size(), kMinFilesPerThread,
+              [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                  Ticks last_modified;
+                  lines[i] = GetFileLine(build_dir, files[i], &last_modified);
+                  if (i < inputs.size() && last_modified >= start_time)
+                    modified = true;
+                }
+              });
+  // An input modified during the run may have been read before the change.
+  // The fingerprint then stays invalid, so the next run does all the work.
+  if (modified)
+    return true;
+
+  std::string contents = GetFingerprintPrefix(cmdline);
+  for (const std::string& line : lines) {
+    contents.append(line);
+    contents.push_back('\n');
+  }
+  base::FilePath path = build_dir.AppendASCII(kGenFingerprintFileName);
+  if (util::WriteFileAtomically(path, contents.data(),
+                                static_cast<int>(contents.size())) !=
+      static_cast<int>(contents.size())) {
+    *err = Err(Location(), "Failed to write " +
+                               std::string(kGenFingerprintFileName) + ".");
+    return false;
+  }
+  return true;
+}
+
+bool IsGenFingerprintUpToDate(const base::FilePath& build_dir,
+                              const base::CommandLine& cmdline) {
+  std::string contents;
+  std::string prefix = GetFingerprintPrefix(cmdline);
+  if (!base::ReadFileToString(build_dir.AppendASCII(kGenFingerprintFileName),
+                              &contents) ||
+      !contents.starts_with(prefix) || !contents.ends_with('\n')) {
+    return false;
+  }
+
+  // The recorded line of each file, compared with a new one.
+  std::vector<std::string_view> lines;
+  std::vector<std::string_view> files;
+  std::string_view remaining(contents);
+  remaining.remove_prefix(prefix.size());
+  while (!remaining.empty()) {
+    size_t newline = remaining.find('\n');
+    std::string_view line = remaining.substr(0, newline);
+    remaining.remove_prefix(newline + 1);
+
+    size_t first_space = line.find(' ');
+    size_t second_space = first_space == std::string_view::npos
+                              ? first_space
+                              : line.find(' ', first_space + 1);
+    if (second_space == std::string_view::npos)
+      return false;
+    lines.push_back(line);
+    files.push_back(line.substr(second_space + 1));
+  }
+
+  std::atomic<bool> changed = false;
+  ParallelFor(files.size(), kMinFilesPerThread,
+              [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end && !changed; ++i) {
+                  Ticks last_modified;
+                  if (GetFileLine(build_dir, files[i], &last_modified) !=
+                      lines[i]) {
+                    changed = true;
+                  }
+                }
+              });
+  return !changed;
+}
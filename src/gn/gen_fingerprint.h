@@ -0,0 +1,52 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_GEN_FINGERPRINT_H_
+#define TOOLS_GN_GEN_FINGERPRINT_H_
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "util/ticks.h"
+
+class Err;
+
+namespace base {
+class CommandLine;
+}  // namespace base
+
+// With "gn gen --fingerprint", a successful run records in the build directory
+// the version of GN, the switches it was given, and the modification time and
+// size of the files it read and of build.ninja. The next run with the same
+// switches first checks these files in parallel, and returns right away if
+// none of them changed, without running the build files.
+//
+// Switches that only change what is printed, like --quiet, are ignored. The
+// files are relative to the build directory, or absolute.
+
+// Name of the fingerprint in the build directory.
+extern const char kGenFingerprintFileName[];
+
+// Invalidates the fingerprint of |build_dir| before a run, creating the
+// directory if needed, and returns the time of the file system when this was
+// done. An input modified after it may have been read before the change, so
+// WriteGenFingerprint() never records it as unchanged.
+Ticks InvalidateGenFingerprint(const base::FilePath& build_dir);
+
+// Writes the fingerprint of a run with the switches of |cmdline| which started
+// at |start_time|, read |inputs| and wrote |outputs|.
+bool WriteGenFingerprint(const base::FilePath& build_dir,
+                         const base::CommandLine& cmdline,
+                         const std::vector<std::string>& inputs,
+                         const std::vector<std::string>& outputs,
+                         Ticks start_time,
+                         Err* err);
+
+// Returns true if |build_dir| has a fingerprint written by this version of GN
+// for the switches of |cmdline|, and none of its files changed since.
+bool IsGenFingerprintUpToDate(const base::FilePath& build_dir,
+                              const base::CommandLine& cmdline);
+
+#endif  // TOOLS_GN_GEN_FINGERPRINT_H_
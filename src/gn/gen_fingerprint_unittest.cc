@@ -0,0 +1,113 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/gen_fingerprint.h"
+
+#include <chrono>
+#include <thread>
+
+#include "base/command_line.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "gn/err.h"
+#include "gn/filesystem_utils.h"
+#include "util/test/test.h"
+
+namespace {
+
+Ticks GetLastModified(const base::FilePath& path) {
+  base::File::Info info;
+  base::GetFileInfo(path, &info);
+  return info.last_modified;
+}
+
+base::CommandLine GetCommandLine(const char* args) {
+  base::CommandLine cmdline(base::CommandLine::NO_PROGRAM);
+  cmdline.AppendArg("gen");
+  cmdline.AppendArg("out");
+  cmdline.AppendSwitch("args", args);
+  cmdline.AppendSwitch("fingerprint");
+  return cmdline;
+}
+
+// Invalidates the fingerprint of |build_dir| until its time is past the one
+// of |input|, which may take a bit depending on the resolution of the file
+// system.
+Ticks StartRun(const base::FilePath& build_dir, const base::FilePath& input) {
+  Ticks start_time = InvalidateGenFingerprint(build_dir);
+  for (int i = 0; i < 200 && start_time <= GetLastModified(input); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    start_time = InvalidateGenFingerprint(build_dir);
+  }
+  return start_time;
+}
+
+}  // namespace
+
+TEST(GenFingerprint, UpToDate) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath build_dir = temp_dir.GetPath().AppendASCII("out");
+  ASSERT_TRUE(base::CreateDirectory(build_dir));
+  base::FilePath build_file = temp_dir.GetPath().AppendASCII("BUILD.gn");
+  base::FilePath args_file = build_dir.AppendASCII("args.gn");
+  base::FilePath build_ninja = build_dir.AppendASCII("build.ninja");
+  ASSERT_TRUE(WriteFile(build_file, "group(\"foo\") {}\n", nullptr));
+  ASSERT_TRUE(WriteFile(args_file, "", nullptr));
+
+  base::CommandLine cmdline = GetCommandLine("is_debug=true");
+  // No fingerprint yet.
+  EXPECT_FALSE(IsGenFingerprintUpToDate(build_dir, cmdline));
+
+  std::vector<std::string> inputs = {"../BUILD.gn",
+                                     FilePathToUTF8(args_file)};  // Absolute.
+  Ticks start_time = StartRun(build_dir, build_file);
+  ASSERT_TRUE(WriteFile(build_ninja, "", nullptr));
+  Err err;
+  ASSERT_TRUE(WriteGenFingerprint(build_dir, cmdline, inputs, {"build.ninja"},
+                                  start_time, &err));
+  EXPECT_TRUE(IsGenFingerprintUpToDate(build_dir, cmdline));
+
+  // Switches that only change what is printed are ignored, not the others.
+  base::CommandLine quiet_cmdline = cmdline;
+  quiet_cmdline.AppendSwitch("q");
+  EXPECT_TRUE(IsGenFingerprintUpToDate(build_dir, quiet_cmdline));
+  EXPECT_FALSE(IsGenFingerprintUpToDate(build_dir,
+                                        GetCommandLine("is_debug=false")));
+
+  // A changed input.
+  ASSERT_TRUE(WriteFile(build_file, "group(\"foobar\") {}\n", nullptr));
+  EXPECT_FALSE(IsGenFingerprintUpToDate(build_dir, cmdline));
+
+  // A missing output.
+  start_time = StartRun(build_dir, build_file);
+  ASSERT_TRUE(WriteGenFingerprint(build_dir, cmdline, inputs, {"build.ninja"},
+                                  start_time, &err));
+  EXPECT_TRUE(IsGenFingerprintUpToDate(build_dir, cmdline));
+  ASSERT_TRUE(base::DeleteFile(build_ninja, false));
+  EXPECT_FALSE(IsGenFingerprintUpToDate(build_dir, cmdline));
+}
+
+TEST(GenFingerprint, InputModifiedDuringRun) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath build_dir = temp_dir.GetPath();
+  base::FilePath build_file = build_dir.AppendASCII("BUILD.gn");
+  ASSERT_TRUE(WriteFile(build_file, "", nullptr));
+  base::CommandLine cmdline = GetCommandLine("");
+
+  Ticks start_time = StartRun(build_dir, build_file);
+  for (int i = 0; i < 200 && GetLastModified(build_file) < start_time; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_TRUE(WriteFile(build_file, "", nullptr));
+  }
+
+  // The run succeeds, but the next one has to do the work.
+  Err err;
+  EXPECT_TRUE(WriteGenFingerprint(build_dir, cmdline, {"BUILD.gn"}, {},
+                                  start_time, &err));
+  EXPECT_FALSE(IsGenFingerprintUpToDate(build_dir, cmdline));
+}
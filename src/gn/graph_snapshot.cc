@@ -0,0 +1,407 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/graph_snapshot.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <unordered_map>
+
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "gn/build_settings.h"
+#include "gn/err.h"
+#include "gn/filesystem_utils.h"
+#include "gn/input_summary.h"
+#include "gn/settings.h"
+#include "gn/target.h"
+#include "util/atomic_write.h"
+
+// The snapshot is only read back by the GN binary that wrote it on the same
+// machine, so integers are written as 32-bit values in the native byte order.
+//
+//   magic, version
+//   string table: count, then each string as its size and characters
+//   source root, start time of the run as its low and high halves, default
+//       toolchain label, inputs
+//   toolchains: count, then each label and output subdirectory
+//   targets: count, then each label, toolchain index, type, testonly and its
+//       public, private, data and validation deps as target indices
+//
+// Strings other than the ones of the table itself are indices in the table,
+// and labels are their directory and name.
+
+namespace {
+
+const char kMagic[] = "gn graph snapshot\n";
+constexpr uint32_t kVersion = 2;
+
+class SnapshotWriter {
+ public:
+  void WriteInt(uint32_t value) { AppendInt(&body_, value); }
+
+  void WriteTicks(Ticks value) {
+    WriteInt(static_cast<uint32_t>(value));
+    WriteInt(static_cast<uint32_t>(value >> 32));
+  }
+
+  void WriteString(std::string_view str) {
+    auto [iter, inserted] = indices_.emplace(
+        std::string(str), static_cast<uint32_t>(strings_.size()));
+    if (inserted)
+      strings_.push_back(&iter->first);
+    WriteInt(iter->second);
+  }
+
+  void WriteLabel(const Label& label) {
+    WriteString(label.dir().value());
+    WriteString(label.name());
+  }
+
+  std::string Finish() const {
+    std::string result(kMagic);
+    AppendInt(&result, kVersion);
+    AppendInt(&result, static_cast<uint32_t>(strings_.size()));
+    for (const std::string* str : strings_) {
+      AppendInt(&result, static_cast<uint32_t>(str->size()));
+      result.append(*str);
+    }
+    result.append(body_);
+    return result;
+  }
+
+ private:
+  static void AppendInt(std::string* out, uint32_t value) {
+    out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  std::string body_;
+  std::unordered_map<std::string, uint32_t> indices_;
+  std::vector<const std::string*> strings_;
+};
+
+// All reads fail once the end of the data is reached, so that a truncated
+// snapshot is rejected.
+class SnapshotReader {
+ public:
+  explicit SnapshotReader(std::string_view data) : data_(data) {}
+
+  bool ReadMagic() {
+    if (!data_.starts_with(kMagic))
+      return false;
+    data_.remove_prefix(sizeof(kMagic) - 1);
+    return true;
+  }
+
+  bool ReadInt(uint32_t* value) {
+    if (data_.size() < sizeof(*value))
+      return false;
+    memcpy(value, data_.data(), sizeof(*value));
+    data_.remove_prefix(sizeof(*value));
+    return true;
+  }
+
+  bool ReadTicks(Ticks* value) {
+    uint32_t low, high;
+    if (!ReadInt(&low) || !ReadInt(&high))
+      return false;
+    *value = static_cast<Ticks>(high) << 32 | low;
+    return true;
+  }
+
+  // Reads a count of items that take at least |min_item_size| bytes each,
+  // rejecting counts that can't fit in the rest of the data.
+  bool ReadCount(size_t min_item_size, uint32_t* count) {
+    return ReadInt(count) && *count <= data_.size() / min_item_size;
+  }
+
+  bool ReadStringTable() {
+    uint32_t count;
+    if (!ReadCount(sizeof(uint32_t), &count))
+      return false;
+    strings_.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+      uint32_t size;
+      if (!ReadInt(&size) || size > data_.size())
+        return false;
+      strings_.push_back(data_.substr(0, size));
+      data_.remove_prefix(size);
+    }
+    return true;
+  }
+
+  bool ReadString(std::string_view* str) {
+    uint32_t index;
+    if (!ReadInt(&index) || index >= strings_.size())
+      return false;
+    *str = strings_[index];
+    return true;
+  }
+
+  bool ReadDir(SourceDir* dir) {
+    std::string_view value;
+    if (!ReadString(&value) || !value.starts_with('/') ||
+        !value.ends_with('/')) {
+      return false;
+    }
+    *dir = SourceDir(value);
+    return true;
+  }
+
+  bool ReadLabel(const Label& toolchain, Label* label) {
+    SourceDir dir;
+    std::string_view name;
+    if (!ReadDir(&dir) || !ReadString(&name))
+      return false;
+    *label = Label(dir, name, toolchain.dir(), toolchain.name());
+    return true;
+  }
+
+  bool at_end() const { return data_.empty(); }
+
+ private:
+  std::string_view data_;
+  std::vector<std::string_view> strings_;
+};
+
+}  // namespace
+
+const char kGraphSnapshotFileName[] = "build.ninja.graph";
+
+std::string SerializeGraphSnapshot(const BuildSettings* build_settings,
+                                   const Label& default_toolchain_label,
+                                   const std::vector<const Target*>& targets,
+                                   const std::vector<std::string>& inputs,
+                                   Ticks start_time) {
+  SnapshotWriter writer;
+  writer.WriteString(build_settings->root_path_utf8());
+  writer.WriteTicks(start_time);
+  writer.WriteLabel(default_toolchain_label);
+  writer.WriteInt(static_cast<uint32_t>(inputs.size()));
+  for (const std::string& input : inputs)
+    writer.WriteString(input);
+
+  std::unordered_map<const Settings*, uint32_t> toolchain_indices;
+  std::vector<const Settings*> toolchains;
+  std::unordered_map<const Target*, uint32_t> target_indices;
+  for (const Target* target : targets) {
+    target_indices.emplace(target,
+                           static_cast<uint32_t>(target_indices.size()));
+    if (toolchain_indices
+            .emplace(target->settings(),
+                     static_cast<uint32_t>(toolchains.size()))
+            .second) {
+      toolchains.push_back(target->settings());
+    }
+  }
+
+  writer.WriteInt(static_cast<uint32_t>(toolchains.size()));
+  for (const Settings* settings : toolchains) {
+    writer.WriteLabel(settings->toolchain_label());
+    writer.WriteString(settings->toolchain_output_subdir().value());
+  }
+
+  auto write_deps = [&writer, &target_indices](const LabelTargetVector& deps) {
+    writer.WriteInt(static_cast<uint32_t>(deps.size()));
+    for (const LabelTargetPair& pair : deps)
+      writer.WriteInt(target_indices.at(pair.ptr));
+  };
+  writer.WriteInt(static_cast<uint32_t>(targets.size()));
+  for (const Target* target : targets) {
+    writer.WriteLabel(target->label());
+    writer.WriteInt(toolchain_indices[target->settings()]);
+    writer.WriteInt(target->output_type());
+    writer.WriteInt(target->testonly());
+    write_deps(target->public_deps());
+    write_deps(target->private_deps());
+    write_deps(target->data_deps());
+    write_deps(target->validations());
+  }
+  return writer.Finish();
+}
+
+Ticks InvalidateGraphSnapshot(const base::FilePath& build_dir) {
+  base::FilePath path = build_dir.AppendASCII(kGraphSnapshotFileName);
+  base::File::Info info;
+  // An empty file is not a valid snapshot. On the first run, the build
+  // directory doesn't exist yet.
+  if (!base::CreateDirectory(build_dir) || base::WriteFile(path, "", 0) != 0 ||
+      !base::GetFileInfo(path, &info)) {
+    return 0;
+  }
+  return info.last_modified;
+}
+
+bool WriteGraphSnapshot(const BuildSettings* build_settings,
+                        const Label& default_toolchain_label,
+                        const std::vector<const Target*>& targets,
+                        Ticks start_time,
+                        Err* err) {
+  std::vector<std::string> inputs = GetGenInputs(build_settings);
+  const base::FilePath build_path =
+      build_settings->build_dir().Resolve(build_settings->root_path());
+
+  std::string contents = SerializeGraphSnapshot(
+      build_settings, default_toolchain_label, targets, inputs, start_time);
+  base::FilePath path = build_path.AppendASCII(kGraphSnapshotFileName);
+  if (util::WriteFileAtomically(path, contents.data(),
+                                static_cast<int>(contents.size())) !=
+      static_cast<int>(contents.size())) {
+    *err = Err(Location(), "Failed to write " +
+                               std::string(kGraphSnapshotFileName) + ".");
+    return false;
+  }
+  return true;
+}
+
+GraphSnapshot::GraphSnapshot() = default;
+
+GraphSnapshot::~GraphSnapshot() = default;
+
+// static
+std::unique_ptr<GraphSnapshot> GraphSnapshot::LoadIfUpToDate(
+    const BuildSettings* build_settings) {
+  const base::FilePath build_path =
+      build_settings->build_dir().Resolve(build_settings->root_path());
+  const base::FilePath path = build_path.AppendASCII(kGraphSnapshotFileName);
+
+  std::string contents;
+  if (!base::ReadFileToString(path, &contents))
+    return nullptr;
+
+  std::vector<std::string> inputs;
+  Ticks start_time;
+  std::unique_ptr<GraphSnapshot> snapshot =
+      Parse(build_settings, contents, &inputs, &start_time);
+  if (!snapshot || start_time == 0)
+    return nullptr;
+
+  // A file modified while the run was reading the build files may have been
+  // read before the change, so the inputs must be older than the start of the
+  // run, not only than the snapshot. With a coarse file system clock, a file
+  // modified at the start time may have been modified after it.
+  std::vector<std::string_view> input_views(inputs.begin(), inputs.end());
+  if (!AreInputsOlderThan(build_path, input_views, start_time - 1))
+    return nullptr;
+  return snapshot;
+}
+
+// static
+std::unique_ptr<GraphSnapshot> GraphSnapshot::Parse(
+    const BuildSettings* build_settings,
+    std::string_view contents,
+    std::vector<std::string>* inputs,
+    Ticks* start_time) {
+  SnapshotReader reader(contents);
+  uint32_t version;
+  if (!reader.ReadMagic() || !reader.ReadInt(&version) ||
+      version != kVersion || !reader.ReadStringTable()) {
+    return nullptr;
+  }
+
+  std::string_view source_root;
+  if (!reader.ReadString(&source_root) ||
+      source_root != build_settings->root_path_utf8() ||
+      !reader.ReadTicks(start_time)) {
+    return nullptr;
+  }
+
+  std::unique_ptr<GraphSnapshot> snapshot(new GraphSnapshot);
+  uint32_t input_count;
+  if (!reader.ReadLabel(Label(), &snapshot->default_toolchain_label_) ||
+      !reader.ReadCount(sizeof(uint32_t), &input_count)) {
+    return nullptr;
+  }
+  inputs->reserve(input_count);
+  for (uint32_t i = 0; i < input_count; ++i) {
+    std::string_view input;
+    if (!reader.ReadString(&input))
+      return nullptr;
+    inputs->emplace_back(input);
+  }
+
+  uint32_t toolchain_count;
+  if (!reader.ReadCount(3 * sizeof(uint32_t), &toolchain_count))
+    return nullptr;
+  for (uint32_t i = 0; i < toolchain_count; ++i) {
+    Label toolchain_label;
+    std::string_view output_subdir;
+    if (!reader.ReadLabel(Label(), &toolchain_label) ||
+        !reader.ReadString(&output_subdir) ||
+        (!output_subdir.empty() && !output_subdir.ends_with('/'))) {
+      return nullptr;
+    }
+    auto settings = std::make_unique<Settings>(build_settings,
+                                               std::string(output_subdir));
+    settings->set_toolchain_label(toolchain_label);
+    settings->set_default_toolchain_label(snapshot->default_toolchain_label_);
+    snapshot->settings_.push_back(std::move(settings));
+  }
+
+  // The deps refer to targets by index, so all the targets are created before
+  // the deps are read.
+  uint32_t target_count;
+  if (!reader.ReadCount(9 * sizeof(uint32_t), &target_count))
+    return nullptr;
+  struct Deps {
+    std::vector<uint32_t> public_deps;
+    std::vector<uint32_t> private_deps;
+    std::vector<uint32_t> data_deps;
+    std::vector<uint32_t> validations;
+  };
+  std::vector<Deps> deps(target_count);
+  auto read_deps = [&reader, target_count](std::vector<uint32_t>* indices) {
+    uint32_t count;
+    if (!reader.ReadCount(sizeof(uint32_t), &count))
+      return false;
+    indices->resize(count);
+    for (uint32_t& index : *indices) {
+      if (!reader.ReadInt(&index) || index >= target_count)
+        return false;
+    }
+    return true;
+  };
+  snapshot->owned_targets_.reserve(target_count);
+  for (uint32_t i = 0; i < target_count; ++i) {
+    SourceDir dir;
+    std::string_view name;
+    uint32_t toolchain_index, type, testonly;
+    if (!reader.ReadDir(&dir) || !reader.ReadString(&name) ||
+        !reader.ReadInt(&toolchain_index) ||
+        toolchain_index >= snapshot->settings_.size() ||
+        !reader.ReadInt(&type) || type > Target::RUST_PROC_MACRO ||
+        !reader.ReadInt(&testonly) || !read_deps(&deps[i].public_deps) ||
+        !read_deps(&deps[i].private_deps) || !read_deps(&deps[i].data_deps) ||
+        !read_deps(&deps[i].validations)) {
+      return nullptr;
+    }
+    const Settings* settings = snapshot->settings_[toolchain_index].get();
+    const Label& toolchain = settings->toolchain_label();
+    auto target = std::make_unique<Target>(
+        settings, Label(dir, name, toolchain.dir(), toolchain.name()));
+    target->set_output_type(static_cast<Target::OutputType>(type));
+    target->set_testonly(testonly != 0);
+    snapshot->owned_targets_.push_back(std::move(target));
+  }
+  if (!reader.at_end())
+    return nullptr;
+
+  auto add_deps = [&snapshot](const std::vector<uint32_t>& indices,
+                              LabelTargetVector* out) {
+    out->reserve(indices.size());
+    for (uint32_t index : indices)
+      out->emplace_back(snapshot->owned_targets_[index].get());
+  };
+  snapshot->targets_.reserve(target_count);
+  for (uint32_t i = 0; i < target_count; ++i) {
+    Target* target = snapshot->owned_targets_[i].get();
+    add_deps(deps[i].public_deps, &target->public_deps());
+    add_deps(deps[i].private_deps, &target->private_deps());
+    add_deps(deps[i].data_deps, &target->data_deps());
+    add_deps(deps[i].validations, &target->validations());
+    snapshot->targets_.push_back(target);
+  }
+  return snapshot;
+}
@@ -0,0 +1,98 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_GRAPH_SNAPSHOT_H_
+#define TOOLS_GN_GRAPH_SNAPSHOT_H_
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gn/label.h"
+#include "util/ticks.h"
+
+namespace base {
+class FilePath;
+}
+
+class BuildSettings;
+class Err;
+class Settings;
+class Target;
+
+// With "gn gen --graph-snapshot", the resolved targets are also saved in a
+// binary snapshot in the build directory: their labels, types, testonly flags
+// and dependencies, along with the files read to generate the build. Queries
+// that only need these ("gn ls", "gn refs") then load the snapshot instead of
+// running all the build files, as long as none of these files changed since
+// the "gn gen" run that wrote it started.
+
+// Name of the snapshot in the build directory.
+extern const char kGraphSnapshotFileName[];
+
+// Returns the contents of the snapshot of |targets|. |inputs| are the files
+// read to generate the build, relative to the build directory or absolute, by
+// a run that started at |start_time|.
+std::string SerializeGraphSnapshot(const BuildSettings* build_settings,
+                                   const Label& default_toolchain_label,
+                                   const std::vector<const Target*>& targets,
+                                   const std::vector<std::string>& inputs,
+                                   Ticks start_time);
+
+// Invalidates the snapshot of |build_dir| before a "gn gen" run, creating the
+// directory if needed, and returns the time of the file system when this was
+// done. A build file modified after it may have been read before the change,
+// so the snapshot of the run is out of date if an input is newer.
+Ticks InvalidateGraphSnapshot(const base::FilePath& build_dir);
+
+// Writes the snapshot of |targets| for the current "gn gen" run, which
+// started at |start_time| and whose inputs are taken from the scheduler.
+bool WriteGraphSnapshot(const BuildSettings* build_settings,
+                        const Label& default_toolchain_label,
+                        const std::vector<const Target*>& targets,
+                        Ticks start_time,
+                        Err* err);
+
+// The targets loaded from a snapshot. They only have what the snapshot has:
+// each Target knows its label, type, testonly flag and dependencies, and each
+// Settings its toolchain, but nothing else is resolved.
+class GraphSnapshot {
+ public:
+  ~GraphSnapshot();
+
+  // Loads the snapshot in the build directory of |build_settings|. Returns
+  // null if there is none, if it was written by another version of GN or for
+  // another source root, or if any of its inputs is missing or was modified
+  // after the run that wrote it started.
+  static std::unique_ptr<GraphSnapshot> LoadIfUpToDate(
+      const BuildSettings* build_settings);
+
+  // Like LoadIfUpToDate() but from |contents| and without checking the
+  // inputs, for tests. |start_time| is set to the start of the run that wrote
+  // it.
+  static std::unique_ptr<GraphSnapshot> Parse(
+      const BuildSettings* build_settings,
+      std::string_view contents,
+      std::vector<std::string>* inputs,
+      Ticks* start_time);
+
+  const Label& default_toolchain_label() const {
+    return default_toolchain_label_;
+  }
+  const std::vector<const Target*>& targets() const { return targets_; }
+
+ private:
+  GraphSnapshot();
+
+  Label default_toolchain_label_;
+  std::vector<std::unique_ptr<Settings>> settings_;
+  std::vector<std::unique_ptr<Target>> owned_targets_;
+  std::vector<const Target*> targets_;
+
+  GraphSnapshot(const GraphSnapshot&) = delete;
+  GraphSnapshot& operator=(const GraphSnapshot&) = delete;
+};
+
+#endif  // TOOLS_GN_GRAPH_SNAPSHOT_H_
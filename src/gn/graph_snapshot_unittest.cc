@@ -0,0 +1,110 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/graph_snapshot.h"
+
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "gn/filesystem_utils.h"
+#include "gn/settings.h"
+#include "gn/target.h"
+#include "gn/test_with_scope.h"
+#include "util/test/test.h"
+
+TEST(GraphSnapshot, RoundTrip) {
+  TestWithScope setup;
+
+  TestTarget a(setup, "//foo:a", Target::EXECUTABLE);
+  TestTarget b(setup, "//foo:b", Target::STATIC_LIBRARY);
+  TestTarget c(setup, "//bar:c", Target::ACTION);
+  c.set_testonly(true);
+  a.private_deps().push_back(LabelTargetPair(&b));
+  a.data_deps().push_back(LabelTargetPair(&c));
+  b.public_deps().push_back(LabelTargetPair(&c));
+  b.validations().push_back(LabelTargetPair(&a));
+
+  std::vector<const Target*> targets = {&a, &b, &c};
+  std::vector<std::string> inputs = {"../../foo/BUILD.gn", "/abs/file.txt"};
+  std::string contents =
+      SerializeGraphSnapshot(setup.build_settings(), setup.toolchain()->label(),
+                             targets, inputs, 0x123456789);
+
+  std::vector<std::string> read_inputs;
+  Ticks start_time = 0;
+  std::unique_ptr<GraphSnapshot> snapshot = GraphSnapshot::Parse(
+      setup.build_settings(), contents, &read_inputs, &start_time);
+  ASSERT_TRUE(snapshot);
+  EXPECT_EQ(inputs, read_inputs);
+  EXPECT_EQ(0x123456789u, start_time);
+  EXPECT_EQ(setup.toolchain()->label(), snapshot->default_toolchain_label());
+
+  const std::vector<const Target*>& read = snapshot->targets();
+  ASSERT_EQ(3u, read.size());
+  EXPECT_EQ(a.label(), read[0]->label());
+  EXPECT_EQ(Target::EXECUTABLE, read[0]->output_type());
+  EXPECT_FALSE(read[0]->testonly());
+  EXPECT_TRUE(read[0]->settings()->is_default());
+  EXPECT_EQ(c.label(), read[2]->label());
+  EXPECT_EQ(Target::ACTION, read[2]->output_type());
+  EXPECT_TRUE(read[2]->testonly());
+
+  ASSERT_EQ(1u, read[0]->private_deps().size());
+  EXPECT_EQ(read[1], read[0]->private_deps()[0].ptr);
+  ASSERT_EQ(1u, read[0]->data_deps().size());
+  EXPECT_EQ(read[2], read[0]->data_deps()[0].ptr);
+  ASSERT_EQ(1u, read[1]->public_deps().size());
+  EXPECT_EQ(read[2], read[1]->public_deps()[0].ptr);
+  ASSERT_EQ(1u, read[1]->validations().size());
+  EXPECT_EQ(read[0], read[1]->validations()[0].ptr);
+  EXPECT_TRUE(read[2]->public_deps().empty());
+
+  // Truncated or corrupted snapshots are rejected.
+  EXPECT_FALSE(GraphSnapshot::Parse(setup.build_settings(),
+                                    contents.substr(0, contents.size() - 1),
+                                    &read_inputs, &start_time));
+  std::string other_version = contents;
+  other_version[sizeof("gn graph snapshot\n") - 1]++;
+  EXPECT_FALSE(GraphSnapshot::Parse(setup.build_settings(), other_version,
+                                    &read_inputs, &start_time));
+}
+
+// An input modified during the run that wrote the snapshot makes it out of
+// date, even though the snapshot is newer.
+TEST(GraphSnapshot, InputsComparedToStartTime) {
+  TestWithScope setup;
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  setup.build_settings()->SetRootPath(temp_dir.GetPath());
+  setup.build_settings()->SetBuildDir(SourceDir("//out/"));
+  base::FilePath build_dir = temp_dir.GetPath().AppendASCII("out");
+
+  Ticks start_time = InvalidateGraphSnapshot(build_dir);
+  ASSERT_NE(0u, start_time);
+  // The invalid snapshot left by the start of a run is never loaded.
+  EXPECT_FALSE(GraphSnapshot::LoadIfUpToDate(setup.build_settings()));
+
+  base::FilePath input = temp_dir.GetPath().AppendASCII("BUILD.gn");
+  ASSERT_TRUE(WriteFile(input, "", nullptr));
+  base::File::Info info;
+  ASSERT_TRUE(base::GetFileInfo(input, &info));
+
+  TestTarget a(setup, "//foo:a", Target::EXECUTABLE);
+  std::vector<const Target*> targets = {&a};
+  auto write_snapshot = [&](Ticks time) {
+    std::string contents =
+        SerializeGraphSnapshot(setup.build_settings(),
+                               setup.toolchain()->label(), targets,
+                               {"../BUILD.gn"}, time);
+    ASSERT_TRUE(WriteFile(build_dir.AppendASCII(kGraphSnapshotFileName),
+                          contents, nullptr));
+  };
+
+  write_snapshot(info.last_modified + 1);
+  EXPECT_TRUE(GraphSnapshot::LoadIfUpToDate(setup.build_settings()));
+  write_snapshot(info.last_modified);
+  EXPECT_FALSE(GraphSnapshot::LoadIfUpToDate(setup.build_settings()));
+  write_snapshot(info.last_modified - 1);
+  EXPECT_FALSE(GraphSnapshot::LoadIfUpToDate(setup.build_settings()));
+}
@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "gn/err.h"
+#include "gn/lazy_import.h"
 #include "gn/parse_tree.h"
 #include "gn/scheduler.h"
 #include "gn/scope_per_file_provider.h"
@@ -38,7 +39,10 @@ std::unique_ptr<Scope> UncachedImport(const Settings* settings,
   ScopePerFileProvider per_file_provider(scope.get(), false);
 
   scope->SetProcessingImport();
-  node->Execute(scope.get(), err);
+  if (const LazyImport* lazy_import = node->AsBlock()->lazy_import())
+    lazy_import->Execute(scope.get(), err);
+  else
+    node->Execute(scope.get(), err);
   if (err->has_error()) {
     // If there was an error, append the caller location so the error message
     // displays a why the file was imported (esp. useful for failed asserts).
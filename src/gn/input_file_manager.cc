@@ -8,7 +8,9 @@
 #include <utility>
 
 #include "base/stl_util.h"
+#include "gn/bytecode.h"
 #include "gn/filesystem_utils.h"
+#include "gn/lazy_import.h"
 #include "gn/parser.h"
 #include "gn/scheduler.h"
 #include "gn/scope_per_file_provider.h"
@@ -38,6 +40,8 @@ bool DoLoadFile(const LocationRange& origin,
                 const BuildSettings* build_settings,
                 const SourceFile& name,
                 InputFileManager::SyncLoadFileCallback load_file_callback,
+                bool compile_to_bytecode,
+                bool prepare_lazy_imports,
                 InputFile* file,
                 std::vector<Token>* tokens,
                 std::unique_ptr<ParseNode>* root,
@@ -93,6 +97,11 @@ bool DoLoadFile(const LocationRange& origin,
   if (err->has_error())
     return false;
 
+  if (compile_to_bytecode)
+    BytecodeChunk::CompileTree(root->get());
+  if (prepare_lazy_imports)
+    LazyImport::PrepareTree(root->get());
+
   exec_trace.Done();
   return true;
 }
@@ -291,7 +300,8 @@ bool InputFileManager::LoadFile(const LocationRange& origin,
   std::vector<Token> tokens;
   std::unique_ptr<ParseNode> root;
   bool success = DoLoadFile(origin, build_settings, name, load_file_callback_,
-                            file, &tokens, &root, err);
+                            compile_to_bytecode_, prepare_lazy_imports_, file,
+                            &tokens, &root, err);
   // Can't return early. We have to ensure that the completion event is
   // signaled in all cases because another thread could be blocked on this one.
 
@@ -106,6 +106,20 @@ class InputFileManager : public base::RefCountedThreadSafe<InputFileManager> {
     load_file_callback_ = load_file_callback;
   }
 
+  // When set, parsed files are compiled to bytecode (see bytecode.h) and
+  // executed by the bytecode VM instead of the tree walker. Must be set
+  // before any file is loaded.
+  bool compile_to_bytecode() const { return compile_to_bytecode_; }
+  void set_compile_to_bytecode(bool compile) { compile_to_bytecode_ = compile; }
+
+  // When set, files are prepared for lazy imports (see lazy_import.h) after
+  // they're parsed, and imports defer evaluating the constants they define.
+  // Must be set before any file is loaded.
+  bool prepare_lazy_imports() const { return prepare_lazy_imports_; }
+  void set_prepare_lazy_imports(bool prepare) {
+    prepare_lazy_imports_ = prepare;
+  }
+
  private:
   friend class base::RefCountedThreadSafe<InputFileManager>;
 
@@ -168,6 +182,9 @@ class InputFileManager : public base::RefCountedThreadSafe<InputFileManager> {
   // Used by unit tests to mock out SyncLoadFile().
   SyncLoadFileCallback load_file_callback_;
 
+  bool compile_to_bytecode_ = false;
+  bool prepare_lazy_imports_ = false;
+
   InputFileManager(const InputFileManager&) = delete;
   InputFileManager& operator=(const InputFileManager&) = delete;
 };
@@ -0,0 +1,119 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/input_summary.h"
+
+#include <atomic>
+#include <vector>
+
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/strings/string_split.h"
+#include "gn/build_settings.h"
+#include "gn/err.h"
+#include "gn/filesystem_utils.h"
+#include "gn/input_file_manager.h"
+#include "gn/parallel_for.h"
+#include "gn/scheduler.h"
+#include "gn/vector_utils.h"
+#include "util/atomic_write.h"
+
+namespace {
+
+const char kHeader[] = "# gn input summary v1\n";
+
+// Below this, checking the inputs isn't worth a thread.
+constexpr size_t kMinInputsPerThread = 256;
+
+}  // namespace
+
+const char kInputSummaryFileName[] = "build.ninja.inputs";
+const char kInputSummaryDirtyFileName[] = "build.ninja.inputs.checked_by_gn";
+
+std::string GetGenInputPath(const BuildSettings* build_settings,
+                            const base::FilePath& input_file) {
+  const base::FilePath build_path =
+      build_settings->build_dir().Resolve(build_settings->root_path());
+  return FilePathToUTF8(
+      MakeAbsoluteFilePathRelativeIfPossible(build_path, input_file)
+          .NormalizePathSeparatorsTo('/'));
+}
+
+std::vector<std::string> GetGenInputs(const BuildSettings* build_settings) {
+  std::vector<base::FilePath> other_files = g_scheduler->GetGenDependencies();
+  const InputFileManager* input_file_manager =
+      g_scheduler->input_file_manager();
+  VectorSetSorter<base::FilePath> sorter(
+      input_file_manager->GetInputFileCount() + other_files.size());
+  input_file_manager->AddAllPhysicalInputFileNamesToVectorSetSorter(&sorter);
+  sorter.Add(other_files.begin(), other_files.end());
+
+  std::vector<std::string> inputs;
+  sorter.IterateOver(
+      [&inputs, build_settings](const base::FilePath& input_file) {
+        inputs.push_back(GetGenInputPath(build_settings, input_file));
+      });
+  return inputs;
+}
+
+InputSummaryWriter::InputSummaryWriter() : contents_(kHeader) {}
+
+void InputSummaryWriter::AddInput(std::string_view path) {
+  contents_.append(path);
+  contents_.push_back('\n');
+}
+
+bool InputSummaryWriter::Write(const base::FilePath& build_dir,
+                               Err* err) const {
+  base::FilePath path = build_dir.AppendASCII(kInputSummaryFileName);
+  if (util::WriteFileAtomically(path, contents_.data(),
+                                static_cast<int>(contents_.size())) !=
+      static_cast<int>(contents_.size())) {
+    *err = Err(Location(), "Failed to write " +
+                               std::string(kInputSummaryFileName) + ".");
+    return false;
+  }
+  return true;
+}
+
+bool IsInputSummaryUpToDate(const base::FilePath& build_dir) {
+  base::File::Info stamp_info;
+  if (!base::GetFileInfo(build_dir.AppendASCII("build.ninja.stamp"),
+                         &stamp_info)) {
+    return false;
+  }
+
+  std::string contents;
+  if (!base::ReadFileToString(build_dir.AppendASCII(kInputSummaryFileName),
+                              &contents) ||
+      !contents.starts_with(kHeader)) {
+    return false;
+  }
+  std::vector<std::string_view> inputs = base::SplitStringPiece(
+      std::string_view(contents).substr(sizeof(kHeader) - 1), "\n",
+      base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+
+  return AreInputsOlderThan(build_dir, inputs, stamp_info.last_modified);
+}
+
+bool AreInputsOlderThan(const base::FilePath& build_dir,
+                        const std::vector<std::string_view>& inputs,
+                        Ticks time) {
+  // Like ninja, consider an input that is missing or newer as a change.
+  std::atomic<bool> changed = false;
+  ParallelFor(inputs.size(), kMinInputsPerThread,
+              [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end && !changed; ++i) {
+                  base::FilePath input = UTF8ToFilePath(inputs[i]);
+                  if (!input.IsAbsolute())
+                    input = build_dir.Append(input);
+                  base::File::Info info;
+                  if (!base::GetFileInfo(input, &info) ||
+                      info.last_modified > time) {
+                    changed = true;
+                  }
+                }
+              });
+  return !changed;
+}
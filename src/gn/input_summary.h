@@ -0,0 +1,65 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_INPUT_SUMMARY_H_
+#define TOOLS_GN_INPUT_SUMMARY_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "util/ticks.h"
+
+class BuildSettings;
+class Err;
+
+// With "gn gen --input-summary", the files read to generate the build (build
+// files, imports, exec_script() inputs, etc.) are listed in an input summary
+// in the build directory instead of in build.ninja.d. Ninja then doesn't
+// check all of them each time it runs. Instead, build.ninja.d refers to a file
+// that never exists, so ninja always runs "gn gen", which checks the summary
+// with IsInputSummaryUpToDate() from several threads and returns right away
+// if no input changed.
+
+// Name of the input summary in the build directory.
+extern const char kInputSummaryFileName[];
+
+// Name of the file that build.ninja.d refers to, which never exists.
+extern const char kInputSummaryDirtyFileName[];
+
+// Returns |input_file| as listed by GetGenInputs().
+std::string GetGenInputPath(const BuildSettings* build_settings,
+                            const base::FilePath& input_file);
+
+// Returns the files read to generate the build, the same as the ones listed in
+// build.ninja.d, sorted: relative to the build directory, or absolute. Must be
+// called once the build graph is loaded.
+std::vector<std::string> GetGenInputs(const BuildSettings* build_settings);
+
+// Accumulates the contents of an input summary.
+class InputSummaryWriter {
+ public:
+  InputSummaryWriter();
+
+  // |path| is relative to the build directory, or absolute.
+  void AddInput(std::string_view path);
+
+  bool Write(const base::FilePath& build_dir, Err* err) const;
+
+ private:
+  std::string contents_;
+};
+
+// Returns true if the input summary of |build_dir| exists, and all the files
+// it lists exist and are older than build.ninja.stamp.
+bool IsInputSummaryUpToDate(const base::FilePath& build_dir);
+
+// Returns true if all the |inputs| exist and are not newer than |time|. The
+// inputs are relative to |build_dir|, or absolute.
+bool AreInputsOlderThan(const base::FilePath& build_dir,
+                        const std::vector<std::string_view>& inputs,
+                        Ticks time);
+
+#endif  // TOOLS_GN_INPUT_SUMMARY_H_
@@ -0,0 +1,73 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/input_summary.h"
+
+#include <chrono>
+#include <thread>
+
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "gn/err.h"
+#include "gn/filesystem_utils.h"
+#include "util/test/test.h"
+
+namespace {
+
+base::File::Info GetInfo(const base::FilePath& path) {
+  base::File::Info info;
+  base::GetFileInfo(path, &info);
+  return info;
+}
+
+}  // namespace
+
+TEST(InputSummary, UpToDate) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath build_dir = temp_dir.GetPath().AppendASCII("out");
+  base::FilePath build_file = temp_dir.GetPath().AppendASCII("BUILD.gn");
+  base::FilePath args_file = build_dir.AppendASCII("args.gn");
+  base::FilePath stamp = build_dir.AppendASCII("build.ninja.stamp");
+  ASSERT_TRUE(WriteFile(build_file, "group(\"foo\") {}\n", nullptr));
+  ASSERT_TRUE(WriteFile(args_file, "", nullptr));
+
+  // No summary yet.
+  EXPECT_FALSE(IsInputSummaryUpToDate(build_dir));
+
+  InputSummaryWriter writer;
+  writer.AddInput("../BUILD.gn");
+  writer.AddInput(FilePathToUTF8(args_file));  // Absolute.
+  Err err;
+  ASSERT_TRUE(writer.Write(build_dir, &err));
+  ASSERT_TRUE(WriteFile(stamp, "", nullptr));
+  EXPECT_TRUE(IsInputSummaryUpToDate(build_dir));
+
+  // Modify an input until its time is past the one of the stamp, which may
+  // take a bit depending on the resolution of the file system.
+  for (int i = 0; i < 200 && GetInfo(build_file).last_modified <=
+                                 GetInfo(stamp).last_modified;
+       ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_TRUE(WriteFile(build_file, "group(\"bar\") {}\n", nullptr));
+  }
+  EXPECT_FALSE(IsInputSummaryUpToDate(build_dir));
+
+  // Regenerated.
+  ASSERT_TRUE(writer.Write(build_dir, &err));
+  ASSERT_TRUE(WriteFile(stamp, "", nullptr));
+  for (int i = 0; i < 200 && GetInfo(stamp).last_modified <
+                                 GetInfo(build_file).last_modified;
+       ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_TRUE(WriteFile(stamp, "", nullptr));
+  }
+  EXPECT_TRUE(IsInputSummaryUpToDate(build_dir));
+
+  // A missing input is a change too.
+  ASSERT_TRUE(base::DeleteFile(args_file, false));
+  EXPECT_FALSE(IsInputSummaryUpToDate(build_dir));
+}
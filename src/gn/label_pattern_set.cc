@@ -0,0 +1,108 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/label_pattern_set.h"
+
+#include <string_view>
+#include <utility>
+
+#include "base/logging.h"
+
+LabelPatternSet::DirNode::DirNode() = default;
+LabelPatternSet::DirNode::DirNode(DirNode&&) = default;
+LabelPatternSet::DirNode::~DirNode() = default;
+LabelPatternSet::DirNode& LabelPatternSet::DirNode::operator=(DirNode&&) =
+    default;
+
+LabelPatternSet::Bucket::Bucket() = default;
+LabelPatternSet::Bucket::Bucket(Bucket&&) = default;
+LabelPatternSet::Bucket::~Bucket() = default;
+LabelPatternSet::Bucket& LabelPatternSet::Bucket::operator=(Bucket&&) =
+    default;
+
+bool LabelPatternSet::Bucket::Matches(const Label& label) const {
+  // Source directories always end with a slash, so a recursive pattern
+  // matches if its directory is one of the prefixes of the label's that end
+  // with a slash (the empty one included).
+  const DirNode* node = &recursive_root;
+  std::string_view dir = label.dir().value();
+  size_t begin = 0;
+  while (!node->recursive) {
+    size_t slash = dir.find('/', begin);
+    if (slash == std::string_view::npos)
+      break;
+    auto found = node->children.find(dir.substr(begin, slash - begin));
+    if (found == node->children.end())
+      break;
+    node = found->second.get();
+    begin = slash + 1;
+  }
+  if (node->recursive)
+    return true;
+
+  auto found = dirs.find(label.dir());
+  if (found == dirs.end())
+    return false;
+  return found->second.all ||
+         found->second.names.find(label.name_atom()) !=
+             found->second.names.end();
+}
+
+LabelPatternSet::LabelPatternSet() = default;
+
+LabelPatternSet::LabelPatternSet(const std::vector<LabelPattern>& patterns) {
+  for (const LabelPattern& pattern : patterns)
+    Add(pattern);
+}
+
+LabelPatternSet::LabelPatternSet(LabelPatternSet&&) = default;
+
+LabelPatternSet::~LabelPatternSet() = default;
+
+LabelPatternSet& LabelPatternSet::operator=(LabelPatternSet&&) = default;
+
+void LabelPatternSet::Add(const LabelPattern& pattern) {
+  size_++;
+  // Only the directory and name of the toolchain are compared.
+  Bucket* bucket =
+      pattern.toolchain().is_null()
+          ? &any_toolchain_
+          : &toolchains_[pattern.toolchain().GetWithNoToolchain()];
+
+  switch (pattern.type()) {
+    case LabelPattern::MATCH:
+      bucket->dirs[pattern.dir()].names.insert(StringAtom(pattern.name()));
+      break;
+    case LabelPattern::DIRECTORY:
+      bucket->dirs[pattern.dir()].all = true;
+      break;
+    case LabelPattern::RECURSIVE_DIRECTORY: {
+      DirNode* node = &bucket->recursive_root;
+      std::string_view dir = pattern.dir().value();
+      size_t begin = 0;
+      for (size_t slash = dir.find('/'); slash != std::string_view::npos;
+           slash = dir.find('/', begin)) {
+        std::unique_ptr<DirNode>& child =
+            node->children[std::string(dir.substr(begin, slash - begin))];
+        if (!child)
+          child = std::make_unique<DirNode>();
+        node = child.get();
+        begin = slash + 1;
+      }
+      // Directories end with a slash, so nothing is left.
+      DCHECK(begin == dir.size());
+      node->recursive = true;
+      break;
+    }
+  }
+}
+
+bool LabelPatternSet::Matches(const Label& label) const {
+  if (any_toolchain_.Matches(label))
+    return true;
+  if (toolchains_.empty())
+    return false;
+  auto found = toolchains_.find(label.GetToolchainLabel());
+  return found != toolchains_.end() && found->second.Matches(label);
+}
@@ -0,0 +1,94 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_LABEL_PATTERN_SET_H_
+#define TOOLS_GN_LABEL_PATTERN_SET_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "gn/label.h"
+#include "gn/label_pattern.h"
+#include "gn/source_dir.h"
+#include "gn/string_atom.h"
+
+// A set of label patterns compiled for matching many labels against it.
+// Matching a label takes time proportional to the depth of its directory
+// rather than to the number of patterns, so this should be preferred over
+// LabelPattern::VectorMatches() when the same patterns are checked for all
+// the targets of a build.
+//
+// The patterns are bucketed by toolchain, and the ones of each bucket are
+// split into exact directories (with the names that match in them, or all
+// names) and a trie of the recursive directories, by path component.
+class LabelPatternSet {
+ public:
+  LabelPatternSet();
+  explicit LabelPatternSet(const std::vector<LabelPattern>& patterns);
+  LabelPatternSet(LabelPatternSet&&);
+  ~LabelPatternSet();
+
+  LabelPatternSet& operator=(LabelPatternSet&&);
+
+  void Add(const LabelPattern& pattern);
+
+  // Returns true if any of the patterns matches the label. Same as
+  // LabelPattern::VectorMatches() on the patterns added.
+  bool Matches(const Label& label) const;
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+ private:
+  // A directory of the trie. The children are keyed by the next path
+  // component, without its slash.
+  struct DirNode {
+    DirNode();
+    DirNode(DirNode&&);
+    ~DirNode();
+
+    DirNode& operator=(DirNode&&);
+
+    // Set if a recursive pattern ends at this directory.
+    bool recursive = false;
+    std::map<std::string, std::unique_ptr<DirNode>, std::less<>> children;
+  };
+
+  // The names matched in one directory.
+  struct DirNames {
+    bool all = false;
+    std::unordered_set<StringAtom> names;
+  };
+
+  // The patterns for one toolchain, or for all of them.
+  struct Bucket {
+    Bucket();
+    Bucket(Bucket&&);
+    ~Bucket();
+
+    Bucket& operator=(Bucket&&);
+
+    bool Matches(const Label& label) const;
+
+    std::unordered_map<SourceDir, DirNames> dirs;
+    DirNode recursive_root;
+  };
+
+  size_t size_ = 0;
+
+  // Patterns without a toolchain.
+  Bucket any_toolchain_;
+
+  // Patterns with a toolchain, by toolchain.
+  std::unordered_map<Label, Bucket> toolchains_;
+
+  LabelPatternSet(const LabelPatternSet&) = delete;
+  LabelPatternSet& operator=(const LabelPatternSet&) = delete;
+};
+
+#endif  // TOOLS_GN_LABEL_PATTERN_SET_H_
@@ -0,0 +1,77 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/label_pattern_set.h"
+
+#include <string>
+#include <vector>
+
+#include "gn/err.h"
+#include "gn/value.h"
+#include "util/test/test.h"
+
+namespace {
+
+LabelPattern MakePattern(const char* str) {
+  Err err;
+  LabelPattern pattern = LabelPattern::GetPattern(
+      SourceDir("//"), std::string_view(), Value(nullptr, str), &err);
+  EXPECT_FALSE(err.has_error()) << str;
+  return pattern;
+}
+
+Label MakeLabel(const char* dir,
+                const char* name,
+                const char* toolchain_dir,
+                const char* toolchain_name) {
+  return Label(SourceDir(dir), name, SourceDir(toolchain_dir), toolchain_name);
+}
+
+}  // namespace
+
+TEST(LabelPatternSet, Matches) {
+  const char* const kPatterns[] = {
+      "//foo:bar",           "//foo/baz:*",
+      "//a/b/*",             "//tc/only:*(//build:other)",
+      "//x:y(//build:other)", "//long/path/to/a/*",
+  };
+  const Label kLabels[] = {
+      MakeLabel("//foo/", "bar", "//build/", "default"),
+      MakeLabel("//foo/", "baz", "//build/", "default"),
+      MakeLabel("//foo/baz/", "any", "//build/", "default"),
+      MakeLabel("//foo/baz/sub/", "any", "//build/", "default"),
+      MakeLabel("//a/", "b", "//build/", "default"),
+      MakeLabel("//a/b/", "x", "//build/", "default"),
+      MakeLabel("//a/b/c/d/", "x", "//build/", "default"),
+      MakeLabel("//a/bc/", "x", "//build/", "default"),
+      MakeLabel("//tc/only/", "x", "//build/", "default"),
+      MakeLabel("//tc/only/", "x", "//build/", "other"),
+      MakeLabel("//x/", "y", "//build/", "other"),
+      MakeLabel("//x/", "y", "//build/", "default"),
+      MakeLabel("//long/path/to/a/", "z", "//build/", "default"),
+      MakeLabel("//long/path/to/", "z", "//build/", "default"),
+      MakeLabel("/C:/abs/", "z", "//build/", "default"),
+  };
+
+  // Check each prefix of the pattern list against the linear match.
+  std::vector<LabelPattern> patterns;
+  for (const char* str : kPatterns) {
+    patterns.push_back(MakePattern(str));
+    LabelPatternSet set(patterns);
+    EXPECT_EQ(patterns.size(), set.size());
+    for (const Label& label : kLabels) {
+      EXPECT_EQ(LabelPattern::VectorMatches(patterns, label),
+                set.Matches(label))
+          << label.GetUserVisibleName(true) << " " << str;
+    }
+  }
+
+  // Everything.
+  LabelPatternSet all;
+  EXPECT_TRUE(all.empty());
+  EXPECT_FALSE(all.Matches(kLabels[0]));
+  all.Add(MakePattern("*"));
+  for (const Label& label : kLabels)
+    EXPECT_TRUE(all.Matches(label));
+}
@@ -0,0 +1,312 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/lazy_import.h"
+
+#include <map>
+#include <string_view>
+
+#include "base/logging.h"
+#include "gn/err.h"
+#include "gn/operators.h"
+#include "gn/parse_tree.h"
+#include "gn/variables.h"
+
+namespace {
+
+// The constants that a statement may read, by identifier: the ones assigned
+// by a deferred statement earlier in the file and not possibly changed since.
+using KnownConstants = std::map<std::string_view, const LazyValue*>;
+
+// What is known about the value of a constant without evaluating it.
+struct ConstantInfo {
+  Value::Type type = Value::NONE;
+  bool is_nonempty_list = false;
+};
+
+// Returns true if |node| evaluates to the same value in any scope and can't
+// fail, so that evaluating it can be deferred. It may only read the constants
+// of |known|, and the identifiers that read them are appended to
+// |references|. What is known about its value is set in |info|.
+bool GetConstantInfo(const ParseNode* node,
+                     const KnownConstants& known,
+                     ConstantInfo* info,
+                     LazyValue::References* references) {
+  if (const LiteralNode* literal = node->AsLiteral()) {
+    switch (literal->value().type()) {
+      case Token::TRUE_TOKEN:
+      case Token::FALSE_TOKEN:
+        info->type = Value::BOOLEAN;
+        return true;
+      case Token::STRING:
+        // Strings with expansions read the scope.
+        info->type = Value::STRING;
+        return literal->value().value().find('$') == std::string_view::npos;
+      case Token::INTEGER: {
+        // Malformed integers only fail when evaluated.
+        Err err;
+        literal->Execute(nullptr, &err);
+        info->type = Value::INTEGER;
+        return !err.has_error();
+      }
+      default:
+        return false;
+    }
+  }
+
+  if (const ListNode* list = node->AsList()) {
+    info->type = Value::LIST;
+    info->is_nonempty_list = false;
+    for (const auto& item : list->contents()) {
+      if (item->AsBlockComment())
+        continue;
+      ConstantInfo item_info;
+      if (!GetConstantInfo(item.get(), known, &item_info, references))
+        return false;
+      info->is_nonempty_list = true;
+    }
+    return true;
+  }
+
+  if (const IdentifierNode* identifier = node->AsIdentifier()) {
+    auto found = known.find(identifier->value().value());
+    if (found == known.end())
+      return false;
+    info->type = found->second->type();
+    info->is_nonempty_list = found->second->is_nonempty_list();
+    references->emplace_back(identifier, found->second);
+    return true;
+  }
+
+  if (const UnaryOpNode* unary = node->AsUnaryOp()) {
+    // "!" is the only unary operator.
+    ConstantInfo operand;
+    if (!GetConstantInfo(unary->operand(), known, &operand, references) ||
+        operand.type != Value::BOOLEAN) {
+      return false;
+    }
+    info->type = Value::BOOLEAN;
+    return true;
+  }
+
+  const BinaryOpNode* binary = node->AsBinaryOp();
+  ConstantInfo left, right;
+  if (!binary ||
+      !GetConstantInfo(binary->left(), known, &left, references) ||
+      !GetConstantInfo(binary->right(), known, &right, references)) {
+    return false;
+  }
+  // Only the operations that succeed for the types of their operands. "-" on
+  // lists is left out since it fails when an item to remove is missing.
+  switch (binary->op().type()) {
+    case Token::PLUS:
+      if (left.type == Value::LIST && right.type == Value::LIST) {
+        info->type = Value::LIST;
+        info->is_nonempty_list =
+            left.is_nonempty_list || right.is_nonempty_list;
+        return true;
+      }
+      if ((left.type != Value::INTEGER && left.type != Value::STRING) ||
+          (right.type != Value::INTEGER && right.type != Value::STRING)) {
+        return false;
+      }
+      info->type = left.type == Value::INTEGER && right.type == Value::INTEGER
+                       ? Value::INTEGER
+                       : Value::STRING;
+      return true;
+    case Token::MINUS:
+      info->type = Value::INTEGER;
+      return left.type == Value::INTEGER && right.type == Value::INTEGER;
+    case Token::EQUAL_EQUAL:
+    case Token::NOT_EQUAL:
+      info->type = Value::BOOLEAN;
+      return true;
+    case Token::LESS_THAN:
+    case Token::LESS_EQUAL:
+    case Token::GREATER_THAN:
+    case Token::GREATER_EQUAL:
+      info->type = Value::BOOLEAN;
+      return left.type == Value::INTEGER && right.type == Value::INTEGER;
+    case Token::BOOLEAN_AND:
+    case Token::BOOLEAN_OR:
+      info->type = Value::BOOLEAN;
+      return left.type == Value::BOOLEAN && right.type == Value::BOOLEAN;
+    default:
+      return false;
+  }
+}
+
+// Returns true if the scope answers |identifier| before looking at its
+// values (see ScopePerFileProvider), so that reading it never reads the
+// constant of the file with the same name.
+bool IsProgrammatic(std::string_view identifier) {
+  static const char* const kProgrammatic[] = {
+      variables::kGnVersion,
+      variables::kCurrentToolchain,
+      variables::kDefaultToolchain,
+      variables::kPythonPath,
+      variables::kRootBuildDir,
+      variables::kRootGenDir,
+      variables::kRootOutDir,
+      variables::kTargetGenDir,
+      variables::kTargetOutDir,
+  };
+  for (const char* programmatic : kProgrammatic) {
+    if (identifier == programmatic)
+      return true;
+  }
+  return false;
+}
+
+// Returns true if executing |statement| can't change the value of any
+// identifier but the one it assigns, if any.
+bool OnlyAssigns(const ParseNode* statement) {
+  if (statement->AsBlockComment())
+    return true;
+  if (const BinaryOpNode* binary = statement->AsBinaryOp()) {
+    return binary->op().type() == Token::EQUAL ||
+           binary->op().type() == Token::PLUS_EQUALS ||
+           binary->op().type() == Token::MINUS_EQUALS;
+  }
+  if (const FunctionCallNode* call = statement->AsFunctionCall()) {
+    std::string_view function = call->function().value();
+    return function == "template" || function == "assert";
+  }
+  return false;
+}
+
+// Returns the identifier that the assignment |statement| changes, which is
+// the base of an accessor like "a[0] = 1".
+std::string_view GetAssignedIdentifier(const BinaryOpNode* statement) {
+  if (const IdentifierNode* identifier = statement->left()->AsIdentifier())
+    return identifier->value().value();
+  if (const AccessorNode* accessor = statement->left()->AsAccessor())
+    return accessor->base().value();
+  return std::string_view();
+}
+
+}  // namespace
+
+LazyValue::LazyValue(const BinaryOpNode* assignment,
+                     Value::Type type,
+                     bool is_nonempty_list,
+                     References references)
+    : assignment_(assignment),
+      type_(type),
+      is_nonempty_list_(is_nonempty_list),
+      references_(std::move(references)) {}
+
+LazyValue::~LazyValue() = default;
+
+bool LazyValue::evaluated() const {
+  return evaluated_.load(std::memory_order_acquire);
+}
+
+const Value& LazyValue::Get() const {
+  std::call_once(once_, [this]() {
+    value_ = Evaluate(assignment_->right());
+    value_.set_origin(assignment_->right());
+    evaluated_.store(true, std::memory_order_release);
+  });
+  return value_;
+}
+
+// Evaluates the operators like ExecuteBinaryOperator() and
+// ExecuteUnaryOperator(), with the identifiers read from |references_|
+// instead of a scope.
+Value LazyValue::Evaluate(const ParseNode* node) const {
+  Err err;
+  Value result;
+  if (const ListNode* list = node->AsList()) {
+    result = Value(list, Value::LIST);
+    for (const auto& item : list->contents()) {
+      if (!item->AsBlockComment())
+        result.list_value().push_back(Evaluate(item.get()));
+    }
+  } else if (node->AsIdentifier()) {
+    for (const auto& [identifier, value] : references_) {
+      if (identifier == node) {
+        result = value->Get();
+        break;
+      }
+    }
+    result.set_origin(node);
+  } else if (const UnaryOpNode* unary = node->AsUnaryOp()) {
+    result = ExecuteUnaryOperator(nullptr, unary, Evaluate(unary->operand()),
+                                  &err);
+  } else if (const BinaryOpNode* binary = node->AsBinaryOp()) {
+    Value left = Evaluate(binary->left());
+    Token::Type op = binary->op().type();
+    if (op == Token::BOOLEAN_AND || op == Token::BOOLEAN_OR) {
+      // The right-hand side is only evaluated if it decides the result.
+      bool value = left.boolean_value();
+      if (value == (op == Token::BOOLEAN_AND))
+        value = Evaluate(binary->right()).boolean_value();
+      result = Value(binary, value);
+    } else {
+      result = ExecuteBinaryOperatorOnValues(
+          nullptr, binary, std::move(left), Evaluate(binary->right()), &err);
+    }
+  } else {
+    result = node->Execute(nullptr, &err);
+  }
+  DCHECK(!err.has_error());
+  return result;
+}
+
+LazyImport::LazyImport(const BlockNode* root) : root_(root) {
+  KnownConstants known;
+  for (const auto& statement : root->statements()) {
+    const BinaryOpNode* assignment = statement->AsBinaryOp();
+    ConstantInfo info;
+    LazyValue::References references;
+    if (assignment && assignment->op().type() == Token::EQUAL &&
+        assignment->left()->AsIdentifier() &&
+        GetConstantInfo(assignment->right(), known, &info, &references)) {
+      deferred_.push_back(std::make_unique<LazyValue>(
+          assignment, info.type, info.is_nonempty_list, std::move(references)));
+      std::string_view identifier = GetAssignedIdentifier(assignment);
+      if (!IsProgrammatic(identifier))
+        known[identifier] = deferred_.back().get();
+      continue;
+    }
+
+    deferred_.push_back(nullptr);
+    if (!OnlyAssigns(statement.get()))
+      known.clear();
+    else if (assignment)
+      known.erase(GetAssignedIdentifier(assignment));
+  }
+}
+
+LazyImport::~LazyImport() = default;
+
+// static
+void LazyImport::PrepareTree(const ParseNode* root) {
+  const BlockNode* block = root->AsBlock();
+  DCHECK(block);
+  // Like the bytecode, the plan is attached while the tree is still owned by
+  // a single thread.
+  const_cast<BlockNode*>(block)->set_lazy_import(
+      std::unique_ptr<LazyImport>(new LazyImport(block)));
+}
+
+void LazyImport::Execute(Scope* scope, Err* err) const {
+  const auto& statements = root_->statements();
+  for (size_t i = 0; i < statements.size() && !err->has_error(); i++) {
+    if (deferred_[i])
+      ExecuteLazyAssignment(scope, deferred_[i].get(), err);
+    else
+      BlockNode::ExecuteStatement(statements[i].get(), scope, err);
+  }
+}
+
+size_t LazyImport::deferred_count() const {
+  size_t count = 0;
+  for (const auto& value : deferred_) {
+    if (value)
+      count++;
+  }
+  return count;
+}
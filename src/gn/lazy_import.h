@@ -0,0 +1,120 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_LAZY_IMPORT_H_
+#define TOOLS_GN_LAZY_IMPORT_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "gn/value.h"
+
+class BinaryOpNode;
+class BlockNode;
+class Err;
+class ParseNode;
+class Scope;
+
+// The value of a top-level assignment of an imported file whose right-hand
+// side is a constant: an expression without side effects that can't fail and
+// only reads literals without string expansions and the constants assigned
+// earlier in the same file, like "b = a + [ \"x\" ]" after "a = [ 1 ]".
+//
+// Since a constant doesn't depend on the scope it's evaluated in, it is only
+// evaluated when it is first read, once for the whole process, and the result
+// is shared by every scope the import is merged into, in every toolchain.
+class LazyValue {
+ public:
+  // The identifiers that the right-hand side reads, with their values.
+  using References = std::vector<std::pair<const ParseNode*, const LazyValue*>>;
+
+  LazyValue(const BinaryOpNode* assignment,
+            Value::Type type,
+            bool is_nonempty_list,
+            References references);
+  ~LazyValue();
+
+  const BinaryOpNode* assignment() const { return assignment_; }
+
+  // The type of the value, known without evaluating it.
+  Value::Type type() const { return type_; }
+
+  // Whether the value is a non-empty list, known without evaluating it.
+  bool is_nonempty_list() const { return is_nonempty_list_; }
+
+  // Returns true if the value has been evaluated.
+  bool evaluated() const;
+
+  // Evaluates the value if needed. Thread-safe.
+  const Value& Get() const;
+
+ private:
+  // Evaluates |node|, a part of the right-hand side.
+  Value Evaluate(const ParseNode* node) const;
+
+  const BinaryOpNode* assignment_;
+  Value::Type type_;
+  bool is_nonempty_list_;
+  References references_;
+
+  mutable std::once_flag once_;
+  mutable std::atomic<bool> evaluated_{false};
+  mutable Value value_;
+
+  LazyValue(const LazyValue&) = delete;
+  LazyValue& operator=(const LazyValue&) = delete;
+};
+
+// How to execute an imported file in lazy import mode (see --lazy-imports).
+//
+// The top-level statements that assign a constant to an identifier are
+// deferred: executing them only checks that the assignment is valid and
+// records a LazyValue in the scope. Every other statement, including
+// template definitions and function calls that may have side effects, is
+// executed normally and in order, so the resulting scope behaves exactly
+// like the one of a normal import.
+//
+// A constant may read the ones assigned before it as long as no statement in
+// between may have changed them: an assignment to the same identifier, or any
+// statement other than an assignment, a comment, template() or assert(),
+// since conditions, imports and other functions may assign anything. The
+// built-in variables that the scope provides itself, like root_build_dir,
+// are never read from the constants.
+class LazyImport {
+ public:
+  ~LazyImport();
+
+  // Computes the plan for |root|, which must be a BlockNode, and attaches it
+  // to the block (see BlockNode::set_lazy_import). This must be called before
+  // the tree is shared with other threads.
+  static void PrepareTree(const ParseNode* root);
+
+  // Executes the file in |scope|.
+  void Execute(Scope* scope, Err* err) const;
+
+  // Number of deferred statements.
+  size_t deferred_count() const;
+
+  // Returns the LazyValue of the |index|-th top-level statement, or null if
+  // the statement is executed normally.
+  const LazyValue* deferred_value(size_t index) const {
+    return deferred_[index].get();
+  }
+
+ private:
+  explicit LazyImport(const BlockNode* root);
+
+  const BlockNode* root_;
+
+  // One entry per top-level statement.
+  std::vector<std::unique_ptr<LazyValue>> deferred_;
+
+  LazyImport(const LazyImport&) = delete;
+  LazyImport& operator=(const LazyImport&) = delete;
+};
+
+#endif  // TOOLS_GN_LAZY_IMPORT_H_
@@ -0,0 +1,218 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/lazy_import.h"
+
+#include "gn/parse_tree.h"
+#include "gn/test_with_scope.h"
+#include "util/test/test.h"
+
+namespace {
+
+struct RunResult {
+  std::string output;
+  Err err;
+};
+
+// Runs |program| either normally or as a lazy import.
+RunResult Run(const std::string& program, bool lazy) {
+  TestWithScope setup;
+  TestParseInput input(program);
+  EXPECT_FALSE(input.has_error());
+
+  RunResult result;
+  if (lazy) {
+    LazyImport::PrepareTree(input.parsed());
+    input.parsed()->AsBlock()->lazy_import()->Execute(setup.scope(),
+                                                      &result.err);
+  } else {
+    input.parsed()->Execute(setup.scope(), &result.err);
+  }
+  result.output = setup.print_output();
+  return result;
+}
+
+// Runs |program| both ways and checks that the output and the error, if any,
+// are the same.
+RunResult RunBoth(const std::string& program) {
+  RunResult eager = Run(program, false);
+  RunResult lazy = Run(program, true);
+  EXPECT_EQ(eager.output, lazy.output) << program;
+  EXPECT_EQ(eager.err.has_error(), lazy.err.has_error()) << program;
+  if (eager.err.has_error() && lazy.err.has_error()) {
+    EXPECT_EQ(eager.err.message(), lazy.err.message()) << program;
+    EXPECT_EQ(eager.err.location().line_number(),
+              lazy.err.location().line_number())
+        << program;
+  }
+  return lazy;
+}
+
+}  // namespace
+
+TEST(LazyImport, DefersConstants) {
+  TestWithScope setup;
+  TestParseInput input(
+      "a = [ \"x\", [ 1 ], true ]\n"
+      "b = \"foo\"\n"
+      "c = \"$b\"\n"
+      "d = 1 + 1\n"
+      "e = false\n"
+      "f = 01\n");
+  ASSERT_FALSE(input.has_error());
+  LazyImport::PrepareTree(input.parsed());
+
+  const LazyImport* lazy_import = input.parsed()->AsBlock()->lazy_import();
+  ASSERT_TRUE(lazy_import);
+  EXPECT_EQ(4u, lazy_import->deferred_count());
+  EXPECT_TRUE(lazy_import->deferred_value(0));
+  EXPECT_TRUE(lazy_import->deferred_value(1));
+  EXPECT_FALSE(lazy_import->deferred_value(2));  // Expansion.
+  EXPECT_TRUE(lazy_import->deferred_value(3));
+  EXPECT_TRUE(lazy_import->deferred_value(4));
+  EXPECT_FALSE(lazy_import->deferred_value(5));  // Invalid integer.
+
+  // Run a file without the invalid statement.
+  Err err;
+  TestParseInput valid(
+      "a = [ \"x\", [ 1 ], true ]\n"
+      "b = \"foo\"\n"
+      "c = \"$b\"\n");
+  ASSERT_FALSE(valid.has_error());
+  LazyImport::PrepareTree(valid.parsed());
+  lazy_import = valid.parsed()->AsBlock()->lazy_import();
+  lazy_import->Execute(setup.scope(), &err);
+  ASSERT_FALSE(err.has_error());
+
+  // "c" read "b", but "a" hasn't been read.
+  EXPECT_FALSE(lazy_import->deferred_value(0)->evaluated());
+  EXPECT_TRUE(lazy_import->deferred_value(1)->evaluated());
+
+  const Value* a = setup.scope()->GetValue("a");
+  ASSERT_TRUE(a);
+  EXPECT_TRUE(lazy_import->deferred_value(0)->evaluated());
+  EXPECT_EQ("[\"x\", [1], true]", a->ToString(true));
+  const ParseNode* first = valid.parsed()->AsBlock()->statements()[0].get();
+  EXPECT_TRUE(a->origin() == first->AsBinaryOp()->right());
+}
+
+TEST(LazyImport, DefersExpressionsOfConstants) {
+  TestParseInput input(
+      "a = [ \"x\" ]\n"
+      "b = a + [ \"y\" ]\n"
+      "c = b == a || !(1 < 2)\n"
+      "d = \"v\" + 2\n"
+      "e = a - [ \"x\" ]\n"  // May fail.
+      "f = a + 1\n"          // Fails.
+      "g = undefined\n"      // Not a constant.
+      "template(\"t\") {\n"
+      "}\n"
+      "# Comment.\n"
+      "\n"
+      "h = [ b, d ]\n"        // Still known after template() and a comment.
+      "a += [ \"z\" ]\n"
+      "i = a\n"              // Changed by +=.
+      "root_build_dir = \"//\"\n"
+      "j = root_build_dir\n"  // Built-in.
+      "print(b)\n"
+      "k = b\n");             // Any other call may assign.
+  ASSERT_FALSE(input.has_error());
+  LazyImport::PrepareTree(input.parsed());
+  const LazyImport* lazy_import = input.parsed()->AsBlock()->lazy_import();
+
+  ASSERT_EQ(16u, input.parsed()->AsBlock()->statements().size());
+  for (size_t i : {0, 1, 2, 3, 9, 12})
+    EXPECT_TRUE(lazy_import->deferred_value(i)) << i;
+  for (size_t i : {4, 5, 6, 10, 11, 13, 15})
+    EXPECT_FALSE(lazy_import->deferred_value(i)) << i;
+  EXPECT_EQ(Value::LIST, lazy_import->deferred_value(9)->type());
+  EXPECT_TRUE(lazy_import->deferred_value(9)->is_nonempty_list());
+}
+
+TEST(LazyImport, ExpressionsSameAsEager) {
+  RunResult result = RunBoth(
+      "a = [ \"x\" ]\n"
+      "b = a + [ \"y\" ] + []\n"
+      "c = b == a || !(1 < 2)\n"
+      "d = \"v\" + 2 + (3 - 1)\n"
+      "e = [ b, d, c && true ]\n"
+      "f = []\n"
+      "g = f + f\n"
+      "g = a\n"
+      "print(a, b, c, d, e, g)\n");
+  EXPECT_FALSE(result.err.has_error());
+  EXPECT_EQ("[\"x\"] [\"x\", \"y\"] false v22 "
+            "[[\"x\", \"y\"], \"v22\", false] [\"x\"]\n",
+            result.output);
+
+  // Overwriting a non-empty list with one computed from constants fails
+  // the same way.
+  result = RunBoth("a = [ 1 ]\nb = [ 2 ]\nb = a + []\n");
+  EXPECT_TRUE(result.err.has_error());
+}
+
+TEST(LazyImport, SameAsEager) {
+  RunResult result = RunBoth(
+      "a = [ \"x\" ]\n"
+      "a += [ \"y\" ]\n"
+      "b = \"s\"\n"
+      "b += \"t\"\n"
+      "c = [ 1 ]\n"
+      "c = []\n"
+      "c += [ 2 ]\n"
+      "d = true\n"
+      "e = []\n"
+      "e = [ 3 ]\n"
+      "if (d) {\n"
+      "  f = 4\n"
+      "}\n"
+      "print(a, b, c, d, e, f)\n");
+  EXPECT_FALSE(result.err.has_error());
+  EXPECT_EQ("[\"x\", \"y\"] st [2] true [3] 4\n", result.output);
+}
+
+TEST(LazyImport, Errors) {
+  const char* kPrograms[] = {
+      "a = [ 1 ]\na = [ 2 ]\n",
+      "a = [ 1 ]\nb = a\na = [ 2 ]\n",
+      "a = 1\na = [ 2 ]\nprint(a)\nb = undefined\n",
+      "print(1)\na = 01\n",
+  };
+  for (const char* program : kPrograms) {
+    RunResult result = RunBoth(program);
+    EXPECT_TRUE(result.err.has_error()) << program;
+  }
+}
+
+TEST(LazyImport, MergeDoesNotEvaluate) {
+  TestWithScope setup;
+  TestParseInput input("a = [ 1, 2 ]\n");
+  ASSERT_FALSE(input.has_error());
+  LazyImport::PrepareTree(input.parsed());
+  const LazyImport* lazy_import = input.parsed()->AsBlock()->lazy_import();
+
+  // Simulates importing the same file twice.
+  Err err;
+  Scope first(setup.settings());
+  lazy_import->Execute(&first, &err);
+  ASSERT_FALSE(err.has_error());
+  Scope second(setup.settings());
+  lazy_import->Execute(&second, &err);
+  ASSERT_FALSE(err.has_error());
+
+  Scope::MergeOptions options;
+  EXPECT_TRUE(first.NonRecursiveMergeTo(setup.scope(), options,
+                                        input.parsed(), "import", &err));
+  EXPECT_TRUE(second.NonRecursiveMergeTo(setup.scope(), options,
+                                         input.parsed(), "import", &err));
+  EXPECT_FALSE(err.has_error());
+  EXPECT_FALSE(lazy_import->deferred_value(0)->evaluated());
+
+  // Modifying the merged value copies it without changing the shared one.
+  Value* a = setup.scope()->GetMutableValue("a", Scope::SEARCH_CURRENT, true);
+  ASSERT_TRUE(a);
+  a->list_value().push_back(Value(nullptr, int64_t(3)));
+  EXPECT_EQ("[1, 2, 3]", setup.scope()->GetValue("a")->ToString(false));
+  EXPECT_EQ("[1, 2]", first.GetValue("a")->ToString(false));
+}
@@ -4,6 +4,8 @@
 
 #include "gn/metadata_walk.h"
 
+#include <utility>
+
 std::vector<Value> WalkMetadata(
     const UniqueVector<const Target*>& targets_to_walk,
     const std::vector<std::string>& keys_to_extract,
@@ -21,3 +23,65 @@ std::vector<Value> WalkMetadata(
   }
   return result;
 }
+
+MetadataStepCache::MetadataStepCache(
+    const std::vector<std::string>& keys_to_extract,
+    const std::vector<std::string>& keys_to_walk,
+    const SourceDir& rebase_dir)
+    : keys_to_extract_(keys_to_extract),
+      keys_to_walk_(keys_to_walk),
+      rebase_dir_(rebase_dir) {}
+
+MetadataStepCache::~MetadataStepCache() = default;
+
+const MetadataWalkStep& MetadataStepCache::GetStep(const Target* target) {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto found = steps_.find(target);
+    if (found != steps_.end())
+      return *found->second;
+  }
+
+  // Computed without the lock, since it may rebase many values. If another
+  // walk computed the same step meanwhile, the first one is kept, which is
+  // equal anyway.
+  auto step = std::make_unique<MetadataWalkStep>();
+  target->GetMetadataStep(keys_to_extract_, keys_to_walk_, rebase_dir_,
+                          /*deps_only=*/false, step.get());
+  std::lock_guard<std::mutex> lock(lock_);
+  return *steps_.emplace(target, std::move(step)).first->second;
+}
+
+MetadataWalkCache* MetadataWalkCache::active_ = nullptr;
+
+MetadataWalkCache::MetadataWalkCache() = default;
+
+MetadataWalkCache::~MetadataWalkCache() = default;
+
+MetadataStepCache* MetadataWalkCache::GetStepCache(
+    const std::vector<std::string>& keys_to_extract,
+    const std::vector<std::string>& keys_to_walk,
+    const SourceDir& rebase_dir) {
+  // Each key is terminated by '\0' and each list by '\1', so different
+  // parameters never give the same string.
+  std::string params;
+  for (const std::string& key : keys_to_extract) {
+    params.append(key);
+    params.push_back('\0');
+  }
+  params.push_back('\1');
+  for (const std::string& key : keys_to_walk) {
+    params.append(key);
+    params.push_back('\0');
+  }
+  params.push_back('\1');
+  params.append(rebase_dir.value());
+
+  std::lock_guard<std::mutex> lock(lock_);
+  std::unique_ptr<MetadataStepCache>& step_cache = step_caches_[params];
+  if (!step_cache) {
+    step_cache = std::make_unique<MetadataStepCache>(keys_to_extract,
+                                                     keys_to_walk, rebase_dir);
+  }
+  return step_cache.get();
+}
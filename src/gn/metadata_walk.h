@@ -5,7 +5,14 @@
 #ifndef TOOLS_GN_METADATAWALK_H_
 #define TOOLS_GN_METADATAWALK_H_
 
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "gn/build_settings.h"
+#include "gn/err.h"
 #include "gn/target.h"
 #include "gn/unique_vector.h"
 #include "gn/value.h"
@@ -23,4 +30,68 @@ std::vector<Value> WalkMetadata(
     TargetSet* targets_walked,
     Err* err);
 
+// What a metadata walk collects from one target: the values of the target
+// itself, and the deps to walk before adding them, in order. If |err| is set,
+// it is reported once these deps are walked.
+struct MetadataWalkStep {
+  std::vector<Value> values;
+  std::vector<const Target*> next;
+  Err err;
+};
+
+// The steps of the targets for one set of keys and rebase directory. Each one
+// is computed once, by the first walk that needs it. Thread-safe.
+class MetadataStepCache {
+ public:
+  MetadataStepCache(const std::vector<std::string>& keys_to_extract,
+                    const std::vector<std::string>& keys_to_walk,
+                    const SourceDir& rebase_dir);
+  ~MetadataStepCache();
+
+  const MetadataWalkStep& GetStep(const Target* target);
+
+ private:
+  const std::vector<std::string> keys_to_extract_;
+  const std::vector<std::string> keys_to_walk_;
+  const SourceDir rebase_dir_;
+
+  std::mutex lock_;
+  std::unordered_map<const Target*, std::unique_ptr<MetadataWalkStep>> steps_;
+
+  MetadataStepCache(const MetadataStepCache&) = delete;
+  MetadataStepCache& operator=(const MetadataStepCache&) = delete;
+};
+
+// Shares the steps of the metadata walks of the generated_file targets of a
+// "gn gen" run, so that the deps they have in common are only collected and
+// rebased once. The walks still visit all the targets in the same order, so
+// their results are unchanged. The targets must outlive the cache.
+// Thread-safe.
+class MetadataWalkCache {
+ public:
+  MetadataWalkCache();
+  ~MetadataWalkCache();
+
+  // Returns the cache for walks with the given keys and rebase directory.
+  MetadataStepCache* GetStepCache(
+      const std::vector<std::string>& keys_to_extract,
+      const std::vector<std::string>& keys_to_walk,
+      const SourceDir& rebase_dir);
+
+  // The cache used by the generated_file targets, if any. Must not be changed
+  // while targets are being written.
+  static MetadataWalkCache* active() { return active_; }
+  static void set_active(MetadataWalkCache* cache) { active_ = cache; }
+
+ private:
+  std::mutex lock_;
+  std::unordered_map<std::string, std::unique_ptr<MetadataStepCache>>
+      step_caches_;
+
+  static MetadataWalkCache* active_;
+
+  MetadataWalkCache(const MetadataWalkCache&) = delete;
+  MetadataWalkCache& operator=(const MetadataWalkCache&) = delete;
+};
+
 #endif  // TOOLS_GN_METADATAWALK_H_
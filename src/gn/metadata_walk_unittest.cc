@@ -209,3 +209,87 @@ TEST(MetadataWalkTest, CollectWithError) {
             "specified the appropriate toolchain.")
       << err.message();
 }
+
+TEST(MetadataWalkTest, StepCache) {
+  TestWithScope setup;
+
+  TestTarget one(setup, "//foo:one", Target::SOURCE_SET);
+  Value a_expected(nullptr, Value::LIST);
+  a_expected.list_value().push_back(Value(nullptr, "foo"));
+  one.metadata().contents().insert(
+      std::pair<std::string_view, Value>("a", a_expected));
+
+  Value walk_expected(nullptr, Value::LIST);
+  walk_expected.list_value().push_back(
+      Value(nullptr, "//foo:two(//toolchain:default)"));
+  one.metadata().contents().insert(
+      std::pair<std::string_view, Value>("walk", walk_expected));
+
+  TestTarget two(setup, "//foo:two", Target::SOURCE_SET);
+  Value a_2_expected(nullptr, Value::LIST);
+  a_2_expected.list_value().push_back(Value(nullptr, "bar"));
+  two.metadata().contents().insert(
+      std::pair<std::string_view, Value>("a", a_2_expected));
+
+  TestTarget three(setup, "//foo:three", Target::SOURCE_SET);
+  Value a_3_expected(nullptr, Value::LIST);
+  a_3_expected.list_value().push_back(Value(nullptr, "baz"));
+  three.metadata().contents().insert(
+      std::pair<std::string_view, Value>("a", a_3_expected));
+
+  one.public_deps().push_back(LabelTargetPair(&two));
+  one.public_deps().push_back(LabelTargetPair(&three));
+
+  // Two generated files walking overlapping deps.
+  TestTarget gen_one(setup, "//foo:gen_one", Target::GENERATED_FILE);
+  gen_one.public_deps().push_back(LabelTargetPair(&one));
+  gen_one.public_deps().push_back(LabelTargetPair(&three));
+  TestTarget gen_two(setup, "//foo:gen_two", Target::GENERATED_FILE);
+  gen_two.public_deps().push_back(LabelTargetPair(&three));
+  gen_two.public_deps().push_back(LabelTargetPair(&one));
+
+  std::vector<std::string> data_keys;
+  data_keys.push_back("a");
+
+  std::vector<std::string> walk_keys;
+  walk_keys.push_back("walk");
+
+  MetadataWalkCache cache;
+  MetadataStepCache* step_cache =
+      cache.GetStepCache(data_keys, walk_keys, SourceDir());
+  EXPECT_EQ(step_cache, cache.GetStepCache(data_keys, walk_keys, SourceDir()));
+  EXPECT_NE(step_cache,
+            cache.GetStepCache(data_keys, walk_keys, SourceDir("//foo/")));
+
+  for (const Target* gen : {&gen_one, &gen_two, &gen_one}) {
+    Err err;
+    std::vector<Value> expected;
+    TargetSet expected_walked;
+    ASSERT_TRUE(gen->GetMetadata(data_keys, walk_keys, SourceDir(), true,
+                                 &expected, &expected_walked, &err));
+
+    std::vector<Value> result;
+    TargetSet targets_walked;
+    ASSERT_TRUE(gen->GetMetadata(data_keys, walk_keys, SourceDir(), true,
+                                 &result, &targets_walked, &err, step_cache));
+    EXPECT_EQ(expected, result);
+    EXPECT_EQ(expected_walked, targets_walked);
+  }
+
+  // Errors are reported each time the step is used.
+  Value missing(nullptr, Value::LIST);
+  missing.list_value().push_back(Value(nullptr, "//foo:missing"));
+  three.metadata().contents().insert(
+      std::pair<std::string_view, Value>("walk", missing));
+  MetadataStepCache* error_cache =
+      cache.GetStepCache(data_keys, walk_keys, SourceDir("//bar/"));
+  for (int i = 0; i < 2; i++) {
+    Err err;
+    std::vector<Value> result;
+    TargetSet targets_walked;
+    EXPECT_FALSE(gen_two.GetMetadata(data_keys, walk_keys, SourceDir("//bar/"),
+                                     true, &result, &targets_walked, &err,
+                                     error_cache));
+    EXPECT_TRUE(err.has_error());
+  }
+}
@@ -93,7 +93,7 @@ void WriteModuleDeps(std::ostream& out,
 }  // namespace
 
 NinjaBinaryTargetWriter::NinjaBinaryTargetWriter(const Target* target,
-                                                 std::ostream& out)
+                                                 OutputSink out)
     : NinjaTargetWriter(target, out),
       rule_prefix_(GetNinjaRulePrefixForToolchain(settings_)) {}
 
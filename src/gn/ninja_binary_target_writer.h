@@ -17,7 +17,7 @@ struct EscapeOptions;
 // library, or a static library).
 class NinjaBinaryTargetWriter : public NinjaTargetWriter {
  public:
-  NinjaBinaryTargetWriter(const Target* target, std::ostream& out);
+  NinjaBinaryTargetWriter(const Target* target, OutputSink out);
   ~NinjaBinaryTargetWriter() override;
 
   void Run() override;
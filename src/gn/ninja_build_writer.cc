@@ -10,6 +10,7 @@
 #include <map>
 #include <set>
 #include <sstream>
+#include <unordered_set>
 
 #include "base/command_line.h"
 #include "base/files/file_util.h"
@@ -21,11 +22,14 @@
 #include "gn/escape.h"
 #include "gn/filesystem_utils.h"
 #include "gn/input_file_manager.h"
+#include "gn/input_summary.h"
 #include "gn/loader.h"
 #include "gn/ninja_utils.h"
+#include "gn/parallel_for.h"
 #include "gn/pool.h"
 #include "gn/scheduler.h"
 #include "gn/string_atom.h"
+#include "gn/string_output_buffer.h"
 #include "gn/switches.h"
 #include "gn/target.h"
 #include "gn/trace.h"
@@ -39,6 +43,9 @@
 
 namespace {
 
+// Below this, computing the names of the targets isn't worth a thread.
+constexpr size_t kMinTargetsPerThread = 2048;
+
 struct Counts {
   Counts() : count(0), last_seen(nullptr) {}
 
@@ -199,7 +206,7 @@ NinjaBuildWriter::NinjaBuildWriter(
     const std::vector<const Target*>& all_targets,
     const Toolchain* default_toolchain,
     const std::vector<const Target*>& default_toolchain_targets,
-    std::ostream& out,
+    OutputSink out,
     std::ostream& dep_out)
     : build_settings_(build_settings),
       used_toolchains_(used_toolchains),
@@ -254,10 +261,10 @@ bool NinjaBuildWriter::RunAndWriteFile(const BuildSettings* build_settings,
     }
   }
 
-  std::stringstream file;
+  StringOutputBuffer file;
   std::stringstream depfile;
   NinjaBuildWriter gen(build_settings, used_toolchains, all_targets,
-                       default_toolchain, default_toolchain_targets, file,
+                       default_toolchain, default_toolchain_targets, &file,
                        depfile);
   if (!gen.Run(err))
     return false;
@@ -288,6 +295,12 @@ bool NinjaBuildWriter::RunAndWriteFile(const BuildSettings* build_settings,
     return false;
   }
 
+  // The input summary must be older than the stamp.
+  if (gen.input_summary_ &&
+      !gen.input_summary_->Write(ninja_file_name.DirName(), err)) {
+    return false;
+  }
+
   // Finally, write the empty build.ninja.stamp file. This is the output
   // expected by the first of the two ninja rules used to accomplish
   // regeneration.
@@ -329,7 +342,12 @@ void NinjaBuildWriter::WriteNinjaRules() {
   out_ << "  command = " << GetSelfInvocationCommand(build_settings_) << "\n";
   // Putting gn rule to console pool for colorful output on regeneration
   out_ << "  pool = console\n";
-  out_ << "  description = Regenerating ninja files\n\n";
+  out_ << "  description = Regenerating ninja files\n";
+  // With an input summary, ninja runs gn every time, and gn doesn't touch
+  // build.ninja.stamp when nothing changed.
+  if (build_settings_->write_input_summary())
+    out_ << "  restat = 1\n";
+  out_ << "\n";
 
   // A comment is left in the build.ninja explaining the two statement setup to
   // avoid confusion, since build.ninja is written earlier than the ninja rules
@@ -368,14 +386,22 @@ void NinjaBuildWriter::WriteNinjaRules() {
 
   EscapeOptions depfile_escape;
   depfile_escape.mode = ESCAPE_DEPFILE;
+  if (build_settings_->write_input_summary()) {
+    // Make ninja always run gn, which checks the inputs itself.
+    dep_out_ << " " << kInputSummaryDirtyFileName;
+    input_summary_ = std::make_unique<InputSummaryWriter>();
+  }
   auto item_callback = [this, &depfile_escape,
                         &build_path](const base::FilePath& input_file) {
     const base::FilePath file =
         MakeAbsoluteFilePathRelativeIfPossible(build_path, input_file);
-    dep_out_ << " ";
-    EscapeStringToStream(dep_out_,
-                         FilePathToUTF8(file.NormalizePathSeparatorsTo('/')),
-                         depfile_escape);
+    std::string path = FilePathToUTF8(file.NormalizePathSeparatorsTo('/'));
+    if (input_summary_) {
+      input_summary_->AddInput(path);
+    } else {
+      dep_out_ << " ";
+      EscapeStringToStream(dep_out_, path, depfile_escape);
+    }
   };
 
   sorter.IterateOver(item_callback);
@@ -422,30 +448,32 @@ void NinjaBuildWriter::WriteAllPools() {
 }
 
 bool NinjaBuildWriter::WriteSubninjas(Err* err) {
-  // Write toolchains sorted by their name, to make output deterministic.
-  std::vector<std::pair<const Settings*, const Toolchain*>> sorted_settings(
-      used_toolchains_.begin(), used_toolchains_.end());
-  std::sort(sorted_settings.begin(), sorted_settings.end(),
-            [this](const std::pair<const Settings*, const Toolchain*>& a,
-                   const std::pair<const Settings*, const Toolchain*>& b) {
+  // Write toolchains sorted by their name, to make output deterministic. The
+  // names are computed once rather than on every comparison.
+  std::vector<std::pair<SourceFile, const Toolchain*>> subninjas;
+  subninjas.reserve(used_toolchains_.size());
+  for (const auto& [settings, toolchain] : used_toolchains_)
+    subninjas.emplace_back(GetNinjaFileForToolchain(settings), toolchain);
+  std::sort(subninjas.begin(), subninjas.end(),
+            [this](const std::pair<SourceFile, const Toolchain*>& a,
+                   const std::pair<SourceFile, const Toolchain*>& b) {
               // Always put the default toolchain first.
               if (b.second == default_toolchain_)
                 return false;
               if (a.second == default_toolchain_)
                 return true;
-              return GetNinjaFileForToolchain(a.first) <
-                     GetNinjaFileForToolchain(b.first);
+              return a.first < b.first;
             });
 
-  SourceFile previous_subninja;
+  const SourceFile* previous_subninja = nullptr;
   const Toolchain* previous_toolchain = nullptr;
 
-  for (const auto& pair : sorted_settings) {
-    SourceFile subninja = GetNinjaFileForToolchain(pair.first);
+  for (const auto& pair : subninjas) {
+    const SourceFile& subninja = pair.first;
 
     // Since the toolchains are sorted, comparing to the previous subninja is
     // enough to find duplicates.
-    if (subninja == previous_subninja) {
+    if (previous_subninja && subninja == *previous_subninja) {
       *err =
           GetDuplicateToolchainError(subninja, previous_toolchain, pair.second);
       return false;
@@ -454,7 +482,7 @@ bool NinjaBuildWriter::WriteSubninjas(Err* err) {
     out_ << "subninja ";
     path_output_.WriteFile(out_, subninja);
     out_ << std::endl;
-    previous_subninja = subninja;
+    previous_subninja = &subninja;
     previous_toolchain = pair.second;
   }
   out_ << std::endl;
@@ -517,7 +545,8 @@ bool NinjaBuildWriter::WritePhonyAndAllRules(Err* err) {
   // Track rules as we generate them so we don't accidentally write a phony
   // rule that collides with something else.
   // GN internally generates an "all" target, so don't duplicate it.
-  std::set<StringAtom, StringAtom::PtrCompare> written_rules;
+  std::unordered_set<StringAtom, StringAtom::PtrHash, StringAtom::PtrEqual>
+      written_rules;
   written_rules.insert(StringAtom("all"));
 
   // Set if we encounter a target named "//:default".
@@ -532,8 +561,17 @@ bool NinjaBuildWriter::WritePhonyAndAllRules(Err* err) {
 
   // Tracks the number of each target with the given short name, as well
   // as the short names of executables (which will be a subset of short_names).
-  std::map<std::string, Counts> short_names;
-  std::map<std::string, Counts> exes;
+  // These are sorted by name.
+  std::map<StringAtom, Counts> short_names;
+  std::map<StringAtom, Counts> exes;
+
+  // The names below are computed in parallel since there is one or more of
+  // them per target. The rules are then picked in order on this thread, which
+  // keeps the output deterministic.
+  std::vector<StringAtom> output_names;
+  std::vector<size_t> output_names_begin;
+  ComputeOutputNames(&output_names, &output_names_begin);
+  std::vector<LabelNames> label_names = ComputeLabelNames();
 
   // ----------------------------------------------------
   // If you change this algorithm, update the help above!
@@ -541,10 +579,10 @@ bool NinjaBuildWriter::WritePhonyAndAllRules(Err* err) {
 
   for (const Target* target : default_toolchain_targets_) {
     const Label& label = target->label();
-    const std::string& short_name = label.name();
+    const StringAtom& short_name = label.name_atom();
 
     if (label.dir() == build_settings_->root_target_label().dir() &&
-        short_name == "default")
+        label.name() == "default")
       default_target = target;
 
     // Count the number of targets with the given short name.
@@ -586,16 +624,14 @@ bool NinjaBuildWriter::WritePhonyAndAllRules(Err* err) {
   //
   // If at this point there is a collision (no phony rules have been
   // generated yet), two targets make the same output so throw an error.
-  for (const Target* target : all_targets_) {
-    for (const auto& output : target->computed_outputs()) {
-      // Need to normalize because many toolchain outputs will be preceded
-      // with "./".
-      std::string output_string(output.value());
-      NormalizePath(&output_string);
-      const StringAtom output_string_atom(output_string);
-
-      if (!written_rules.insert(output_string_atom).second) {
-        *err = GetDuplicateOutputError(all_targets_, output);
+  written_rules.reserve(output_names.size() + 3 * label_names.size());
+  for (size_t i = 0; i < all_targets_.size(); ++i) {
+    const std::vector<OutputFile>& outputs =
+        all_targets_[i]->computed_outputs();
+    for (size_t j = 0; j < outputs.size(); ++j) {
+      if (!written_rules.insert(output_names[output_names_begin[i] + j])
+               .second) {
+        *err = GetDuplicateOutputError(all_targets_, outputs[j]);
         return false;
       }
     }
@@ -639,29 +675,19 @@ bool NinjaBuildWriter::WritePhonyAndAllRules(Err* err) {
   }
 
   // Write the label variants of the target name.
-  for (const Target* target : default_toolchain_targets_) {
-    const Label& label = target->label();
+  for (size_t i = 0; i < default_toolchain_targets_.size(); ++i) {
+    const Target* target = default_toolchain_targets_[i];
+    const LabelNames& names = label_names[i];
 
     // Write the long name "foo/bar:baz" for the target "//foo/bar:baz".
-    std::string long_name = label.GetUserVisibleName(false);
-    base::TrimString(long_name, "/", &long_name);
-    const StringAtom long_name_atom(long_name);
-    if (written_rules.insert(long_name_atom).second)
-      WritePhonyRule(target, long_name_atom);
+    if (written_rules.insert(names.long_name).second)
+      WritePhonyRule(target, names.long_name);
 
     // Write the directory name with no target name if they match
     // (e.g. "//foo/bar:bar" -> "foo/bar").
-    if (FindLastDirComponent(label.dir()) == label.name()) {
-      std::string medium_name = DirectoryWithNoLastSlash(label.dir());
-      base::TrimString(medium_name, "/", &medium_name);
-      const StringAtom medium_name_atom(medium_name);
-
-      // That may have generated a name the same as the short name of the
-      // target which we already wrote.
-      if (medium_name != label.name() &&
-          written_rules.insert(medium_name_atom).second)
-        WritePhonyRule(target, medium_name_atom);
-    }
+    if (!names.medium_name.empty() &&
+        written_rules.insert(names.medium_name).second)
+      WritePhonyRule(target, names.medium_name);
   }
 
   // Write the autogenerated "all" rule.
@@ -698,18 +724,74 @@ bool NinjaBuildWriter::WritePhonyAndAllRules(Err* err) {
   return true;
 }
 
+void NinjaBuildWriter::ComputeOutputNames(
+    std::vector<StringAtom>* names,
+    std::vector<size_t>* names_begin) const {
+  names_begin->reserve(all_targets_.size() + 1);
+  size_t count = 0;
+  for (const Target* target : all_targets_) {
+    names_begin->push_back(count);
+    count += target->computed_outputs().size();
+  }
+  names_begin->push_back(count);
+  names->resize(count);
+
+  ParallelFor(all_targets_.size(), kMinTargetsPerThread,
+              [this, names, names_begin](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                  // Not indexed, since the last targets may have no
+                  // outputs and start at the end of the names.
+                  StringAtom* name = names->data() + (*names_begin)[i];
+                  for (const auto& output :
+                       all_targets_[i]->computed_outputs()) {
+                    // Need to normalize because many toolchain outputs will
+                    // be preceded with "./".
+                    std::string output_string(output.value());
+                    NormalizePath(&output_string);
+                    *name++ = StringAtom(output_string);
+                  }
+                }
+              });
+}
+
+std::vector<NinjaBuildWriter::LabelNames>
+NinjaBuildWriter::ComputeLabelNames() const {
+  std::vector<LabelNames> result(default_toolchain_targets_.size());
+  ParallelFor(
+      default_toolchain_targets_.size(), kMinTargetsPerThread,
+      [this, &result](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          const Label& label = default_toolchain_targets_[i]->label();
+
+          std::string long_name = label.GetUserVisibleName(false);
+          base::TrimString(long_name, "/", &long_name);
+          result[i].long_name = StringAtom(long_name);
+
+          if (FindLastDirComponent(label.dir()) == label.name()) {
+            std::string medium_name = DirectoryWithNoLastSlash(label.dir());
+            base::TrimString(medium_name, "/", &medium_name);
+            // That may have generated a name the same as the short name of
+            // the target, which is written separately.
+            if (medium_name != label.name())
+              result[i].medium_name = StringAtom(medium_name);
+          }
+        }
+      });
+  return result;
+}
+
 void NinjaBuildWriter::WritePhonyRule(const Target* target,
                                       std::string_view phony_name) {
   EscapeOptions ninja_escape;
   ninja_escape.mode = ESCAPE_NINJA;
 
-  // Escape for special chars Ninja will handle.
-  std::string escaped = EscapeString(phony_name, ninja_escape, nullptr);
-
   // If the target doesn't have a dependency_output(), we should
   // still emit the phony rule, but with no dependencies. This allows users to
   // continue to use the phony rule, but it will effectively be a no-op.
-  out_ << "build " << escaped << ": phony ";
+  out_ << "build ";
+  // Escape for special chars Ninja will handle.
+  EscapeStringToStream(out_, phony_name, ninja_escape);
+  out_ << ": phony ";
   if (target->has_dependency_output()) {
     path_output_.WriteFile(out_, target->dependency_output());
   }
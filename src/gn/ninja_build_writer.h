@@ -7,15 +7,19 @@
 
 #include <iosfwd>
 #include <map>
+#include <memory>
 #include <string_view>
 #include <unordered_map>
 #include <vector>
 
+#include "gn/output_sink.h"
 #include "gn/path_output.h"
+#include "gn/string_atom.h"
 
 class Builder;
 class BuildSettings;
 class Err;
+class InputSummaryWriter;
 class Settings;
 class Target;
 class Toolchain;
@@ -35,7 +39,7 @@ class NinjaBuildWriter {
                    const std::vector<const Target*>& all_targets,
                    const Toolchain* default_toolchain,
                    const std::vector<const Target*>& default_toolchain_targets,
-                   std::ostream& out,
+                   OutputSink out,
                    std::ostream& dep_out);
   ~NinjaBuildWriter();
 
@@ -85,6 +89,20 @@ class NinjaBuildWriter {
 
   void WritePhonyRule(const Target* target, std::string_view phony_name);
 
+  // The names of the phony rules that a target may get from its label.
+  struct LabelNames {
+    StringAtom long_name;    // "foo/bar:bar" for "//foo/bar:bar".
+    StringAtom medium_name;  // "foo/bar", or empty if it doesn't apply.
+  };
+
+  // Returns the normalized names of the outputs of all_targets_, as one
+  // vector where those of the target at index i start at |names_begin[i]|.
+  void ComputeOutputNames(std::vector<StringAtom>* names,
+                          std::vector<size_t>* names_begin) const;
+
+  // Returns the LabelNames of default_toolchain_targets_, in the same order.
+  std::vector<LabelNames> ComputeLabelNames() const;
+
   const BuildSettings* build_settings_;
 
   const std::unordered_map<const Settings*, const Toolchain*>& used_toolchains_;
@@ -92,10 +110,14 @@ class NinjaBuildWriter {
   const Toolchain* default_toolchain_;
   const std::vector<const Target*>& default_toolchain_targets_;
 
-  std::ostream& out_;
+  OutputSink out_;
   std::ostream& dep_out_;
   PathOutput path_output_;
 
+  // Set by WriteNinjaRules() if the inputs go in an input summary rather
+  // than in the depfile.
+  std::unique_ptr<InputSummaryWriter> input_summary_;
+
   NinjaBuildWriter(const NinjaBuildWriter&) = delete;
   NinjaBuildWriter& operator=(const NinjaBuildWriter&) = delete;
 };
@@ -2,11 +2,16 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <fstream>
+#include <memory>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include "base/command_line.h"
 #include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "gn/ninja_build_writer.h"
 #include "gn/pool.h"
 #include "gn/scheduler.h"
@@ -297,6 +302,84 @@ TEST_F(NinjaBuildWriterTest, SpaceInDepfile) {
             "build.ninja.stamp: ../../path\\ with\\ space/BUILD.gn");
 }
 
+TEST_F(NinjaBuildWriterTest, InputSummary) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  TestWithScope setup;
+  Err err;
+  setup.build_settings()->SetRootPath(temp_dir.GetPath());
+  setup.build_settings()->set_write_input_summary(true);
+  g_scheduler->AddGenDependency(
+      setup.build_settings()->GetFullPath(SourceFile("//foo/BUILD.gn")));
+
+  std::unordered_map<const Settings*, const Toolchain*> used_toolchains;
+  used_toolchains[setup.settings()] = setup.toolchain();
+  std::vector<const Target*> targets;
+  std::ostringstream ninja_out;
+  std::ostringstream depfile_out;
+  NinjaBuildWriter writer(setup.build_settings(), used_toolchains, targets,
+                          setup.toolchain(), targets, ninja_out, depfile_out);
+  ASSERT_TRUE(writer.Run(&err));
+
+  // Ninja always runs gn, which only touches the stamp if an input changed.
+  EXPECT_EQ(depfile_out.str(),
+            "build.ninja.stamp: build.ninja.inputs.checked_by_gn");
+  EXPECT_NE(std::string::npos,
+            ninja_out.str().find("  description = Regenerating ninja files\n"
+                                 "  restat = 1\n"));
+}
+
+// Enough targets for the names of the phony rules to be computed by several
+// threads, which must not change their order.
+TEST_F(NinjaBuildWriterTest, ManyTargets) {
+  TestWithScope setup;
+  Err err;
+
+  const int kTargetCount = 5000;
+  std::vector<std::unique_ptr<Target>> owned_targets;
+  std::vector<const Target*> targets;
+  std::vector<std::string> short_names;
+  for (int i = 0; i < kTargetCount; ++i) {
+    std::string name = "t" + std::to_string(i);
+    auto target = std::make_unique<Target>(
+        setup.settings(), Label(SourceDir("//a/" + name + "/"), name));
+    target->set_output_type(Target::ACTION);
+    target->action_values().set_script(SourceFile("//a/script.py"));
+    target->action_values().outputs() =
+        SubstitutionList::MakeForTest(("//out/Debug/gen/" + name).c_str());
+    target->SetToolchain(setup.toolchain());
+    ASSERT_TRUE(target->OnResolved(&err));
+    targets.push_back(target.get());
+    owned_targets.push_back(std::move(target));
+    short_names.push_back(name);
+  }
+
+  std::unordered_map<const Settings*, const Toolchain*> used_toolchains;
+  used_toolchains[setup.settings()] = setup.toolchain();
+  std::ostringstream ninja_out;
+  std::ostringstream depfile_out;
+  NinjaBuildWriter writer(setup.build_settings(), used_toolchains, targets,
+                          setup.toolchain(), targets, ninja_out, depfile_out);
+  ASSERT_TRUE(writer.Run(&err));
+
+  // The unique short names come first, sorted, then the label names of each
+  // target in order.
+  std::sort(short_names.begin(), short_names.end());
+  std::string expected;
+  for (const std::string& name : short_names) {
+    expected +=
+        "build " + name + ": phony phony/a/" + name + "/" + name + "\n";
+  }
+  for (int i = 0; i < kTargetCount; ++i) {
+    std::string name = "t" + std::to_string(i);
+    std::string phony = ": phony phony/a/" + name + "/" + name + "\n";
+    expected += "build a/" + name + "$:" + name + phony;
+    expected += "build a/" + name + phony;
+  }
+  std::string out_str = ninja_out.str();
+  EXPECT_NE(std::string::npos, out_str.find(expected));
+}
+
 TEST_F(NinjaBuildWriterTest, DuplicateOutputs) {
   TestWithScope setup;
   Err err;
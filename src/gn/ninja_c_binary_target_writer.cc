@@ -57,7 +57,7 @@ const char* GetPCHLangForToolType(const char* name) {
 }  // namespace
 
 NinjaCBinaryTargetWriter::NinjaCBinaryTargetWriter(const Target* target,
-                                                   std::ostream& out)
+                                                   OutputSink out)
     : NinjaBinaryTargetWriter(target, out),
       tool_(target->toolchain()->GetToolForTargetFinalOutputAsC(target)) {}
 
@@ -11,6 +11,7 @@
 #include "gn/config.h"
 #include "gn/ninja_group_target_writer.h"
 #include "gn/ninja_target_command_util.h"
+#include "gn/ninja_variable_bundles.h"
 #include "gn/pool.h"
 #include "gn/scheduler.h"
 #include "gn/target.h"
@@ -3675,3 +3676,57 @@ TEST_F(NinjaCBinaryTargetWriterTest,
     EXPECT_EQ(expected, out.str());
   }
 }
+
+TEST_F(NinjaCBinaryTargetWriterTest, HoistCompilerVars) {
+  Err err;
+  TestWithScope setup;
+
+  Config config(setup.settings(), Label(SourceDir("//foo/"), "config"));
+  config.visibility().SetPublic();
+  for (int i = 0; i < 10; i++) {
+    config.own_values().cflags().push_back("-fflag" + std::to_string(i));
+    config.own_values().defines().push_back("DEFINE" + std::to_string(i));
+  }
+  config.own_values().cflags_cc().push_back("-short");
+  ASSERT_TRUE(config.OnResolved(&err));
+
+  Target target(setup.settings(), Label(SourceDir("//foo/"), "bar"));
+  target.set_output_type(Target::SOURCE_SET);
+  target.visibility().SetPublic();
+  target.sources().push_back(SourceFile("//foo/input1.cc"));
+  target.source_types_used().Set(SourceFile::SOURCE_CPP);
+  target.configs().push_back(LabelConfigPair(&config));
+  target.SetToolchain(setup.toolchain());
+  ASSERT_TRUE(target.OnResolved(&err));
+
+  std::ostringstream inline_out;
+  NinjaCBinaryTargetWriter(&target, inline_out).Run();
+
+  setup.build_settings()->set_hoist_compiler_vars(true);
+  std::ostringstream hoisted_out;
+  NinjaCBinaryTargetWriter(&target, hoisted_out).Run();
+  std::ostringstream definitions;
+  setup.build_settings()->ninja_variable_bundles()->WriteDefinitions(
+      setup.toolchain()->label(), definitions);
+
+  std::string hoisted = hoisted_out.str();
+  EXPECT_NE(std::string::npos, hoisted.find("\ncflags = $cflags_"));
+  EXPECT_EQ(0u, hoisted.find("defines = $defines_"));
+  EXPECT_NE(std::string::npos, hoisted.find("\ncflags_cc = -short\n"));
+  EXPECT_LT(hoisted.size(), inline_out.str().size());
+
+  // Substituting the definitions gives back the original file.
+  std::istringstream definition_lines(definitions.str());
+  std::string line;
+  while (std::getline(definition_lines, line)) {
+    if (line.empty())
+      continue;
+    size_t equals = line.find(" =");
+    ASSERT_NE(std::string::npos, equals);
+    std::string reference = " $" + line.substr(0, equals) + "\n";
+    size_t found = hoisted.find(reference);
+    ASSERT_NE(std::string::npos, found) << line;
+    hoisted.replace(found, reference.size(), line.substr(equals + 2) + "\n");
+  }
+  EXPECT_EQ(inline_out.str(), hoisted);
+}
@@ -10,7 +10,7 @@
 // Writes a .ninja file for a copy target type.
 class NinjaCopyTargetWriter : public NinjaTargetWriter {
  public:
-  NinjaCopyTargetWriter(const Target* target, std::ostream& out);
+  NinjaCopyTargetWriter(const Target* target, OutputSink out);
   ~NinjaCopyTargetWriter() override;
 
   void Run() override;
@@ -69,7 +69,7 @@ bool EnsureAllToolsAvailable(const Target* target) {
 
 NinjaCreateBundleTargetWriter::NinjaCreateBundleTargetWriter(
     const Target* target,
-    std::ostream& out)
+    OutputSink out)
     : NinjaTargetWriter(target, out) {}
 
 NinjaCreateBundleTargetWriter::~NinjaCreateBundleTargetWriter() = default;
@@ -4,6 +4,7 @@
 
 #include "gn/ninja_generated_file_target_writer.h"
 
+#include "gn/metadata_walk.h"
 #include "gn/output_conversion.h"
 #include "gn/output_file.h"
 #include "gn/scheduler.h"
@@ -15,7 +16,7 @@
 
 NinjaGeneratedFileTargetWriter::NinjaGeneratedFileTargetWriter(
     const Target* target,
-    std::ostream& out)
+    OutputSink out)
     : NinjaTargetWriter(target, out) {}
 
 NinjaGeneratedFileTargetWriter::~NinjaGeneratedFileTargetWriter() = default;
@@ -77,9 +78,15 @@ void NinjaGeneratedFileTargetWriter::GenerateFile() {
     ScopedTrace metadata_walk_trace(TraceItem::TRACE_WALK_METADATA,
                                     target_->label());
     trace.SetToolchain(target_->settings()->toolchain_label());
+    MetadataStepCache* step_cache = nullptr;
+    if (MetadataWalkCache::active()) {
+      step_cache = MetadataWalkCache::active()->GetStepCache(
+          target_->data_keys(), target_->walk_keys(), target_->rebase());
+    }
     if (!target_->GetMetadata(target_->data_keys(), target_->walk_keys(),
                               target_->rebase(), /*deps_only = */ true,
-                              &contents.list_value(), &targets_walked, &err)) {
+                              &contents.list_value(), &targets_walked, &err,
+                              step_cache)) {
       g_scheduler->FailWithError(err);
       return;
     }
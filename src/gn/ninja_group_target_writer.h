@@ -10,7 +10,7 @@
 // Writes a .ninja file for a group target type.
 class NinjaGroupTargetWriter : public NinjaTargetWriter {
  public:
-  NinjaGroupTargetWriter(const Target* target, std::ostream& out);
+  NinjaGroupTargetWriter(const Target* target, OutputSink out);
   ~NinjaGroupTargetWriter() override;
 
   void Run() override;
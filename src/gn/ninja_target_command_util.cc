@@ -7,6 +7,7 @@
 #include <string.h>
 
 #include "gn/c_tool.h"
+#include "gn/config_flags_cache.h"
 #include "gn/substitution_writer.h"
 
 namespace {
@@ -56,6 +57,8 @@ void WriteOneFlag(RecursiveWriterConfig config,
   if (write_substitution)
     out << subst_enum->ninja_name << " =";
 
+  ConfigFlagsCache* flags_cache =
+      target->settings()->build_settings()->config_flags_cache();
   if (has_precompiled_headers) {
     const CTool* tool = target->toolchain()->GetToolAsC(tool_name);
     if (tool && tool->precompiled_header_type() == CTool::PCH_MSVC) {
@@ -66,16 +69,16 @@ void WriteOneFlag(RecursiveWriterConfig config,
       // Enables precompiled headers and names the .h file. It's a string
       // rather than a file name (so no need to rebase or use path_output).
       out << " /Yu" << target->config_values().precompiled_header();
-      RecursiveTargetConfigStringsToStream(config, target, getter,
-                                           flag_escape_options, out);
+      flags_cache->WriteStrings(subst_enum, config, target, getter,
+                                flag_escape_options, out);
     } else if (tool && tool->precompiled_header_type() == CTool::PCH_GCC) {
       // The targets to build the .gch files should omit the -include flag
       // below. To accomplish this, each substitution flag is overwritten in
       // the target rule and these values are repeated. The -include flag is
       // omitted in place of the required -x <header lang> flag for .gch
       // targets.
-      RecursiveTargetConfigStringsToStream(config, target, getter,
-                                           flag_escape_options, out);
+      flags_cache->WriteStrings(subst_enum, config, target, getter,
+                                flag_escape_options, out);
 
       // Compute the gch file (it will be language-specific).
       std::vector<OutputFile> outputs;
@@ -88,12 +91,12 @@ void WriteOneFlag(RecursiveWriterConfig config,
         out << " -include " << pch_file.substr(0, pch_file.length() - 4);
       }
     } else {
-      RecursiveTargetConfigStringsToStream(config, target, getter,
-                                           flag_escape_options, out);
+      flags_cache->WriteStrings(subst_enum, config, target, getter,
+                                flag_escape_options, out);
     }
   } else {
-    RecursiveTargetConfigStringsToStream(config, target, getter,
-                                         flag_escape_options, out);
+    flags_cache->WriteStrings(subst_enum, config, target, getter,
+                              flag_escape_options, out);
   }
 
   if (write_substitution)
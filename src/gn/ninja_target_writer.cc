@@ -5,15 +5,19 @@
 #include "gn/ninja_target_writer.h"
 
 #include <algorithm>
+#include <memory>
 #include <sstream>
+#include <utility>
 
 #include "base/files/file_util.h"
 #include "base/strings/string_util.h"
 #include "gn/builtin_tool.h"
 #include "gn/c_substitution_type.h"
+#include "gn/config_flags_cache.h"
 #include "gn/config_values_extractors.h"
 #include "gn/err.h"
 #include "gn/escape.h"
+#include "gn/file_write_batch.h"
 #include "gn/filesystem_utils.h"
 #include "gn/general_tool.h"
 #include "gn/ninja_action_target_writer.h"
@@ -25,6 +29,7 @@
 #include "gn/ninja_group_target_writer.h"
 #include "gn/ninja_target_command_util.h"
 #include "gn/ninja_utils.h"
+#include "gn/ninja_variable_bundles.h"
 #include "gn/output_file.h"
 #include "gn/rust_substitution_type.h"
 #include "gn/scheduler.h"
@@ -34,7 +39,7 @@
 #include "gn/target.h"
 #include "gn/trace.h"
 
-NinjaTargetWriter::NinjaTargetWriter(const Target* target, std::ostream& out)
+NinjaTargetWriter::NinjaTargetWriter(const Target* target, OutputSink out)
     : settings_(target->settings()),
       target_(target),
       out_(out),
@@ -112,8 +117,8 @@ std::string NinjaTargetWriter::RunAndWriteFile(
 
   // It's ridiculously faster to write to a string and then write that to
   // disk in one operation than to use an fstream here.
-  StringOutputBuffer storage;
-  std::ostream rules(&storage);
+  auto storage = std::make_unique<StringOutputBuffer>();
+  OutputSink rules(storage.get());
 
   // Call out to the correct sub-type of writer. Binary targets need to be
   // written to separate files for compiler flag scoping, but other target
@@ -172,20 +177,21 @@ std::string NinjaTargetWriter::RunAndWriteFile(
       CHECK(modulemap);
 
       // Write public module map
-      StringOutputBuffer public_storage;
-      std::ostream public_os(&public_storage);
-      writer.WritePublicModuleMap(public_os, modulemap->GetDir());
-      base::FilePath public_path =
-          settings->build_settings()->GetFullPath(*modulemap);
-      public_storage.WriteToFileIfChanged(public_path, nullptr);
+      auto public_storage = std::make_unique<StringOutputBuffer>();
+      writer.WritePublicModuleMap(public_storage->stream(),
+                                  modulemap->GetDir());
+      FileWriteBatch::WriteFileIfChanged(
+          settings->build_settings()->GetFullPath(*modulemap),
+          std::move(public_storage));
 
       // Write private module map adjacent to the public one
-      StringOutputBuffer private_storage;
-      std::ostream private_os(&private_storage);
-      writer.WritePrivateModuleMap(private_os, modulemap->GetDir());
-      base::FilePath private_path = settings->build_settings()->GetFullPath(
-          *target->private_modulemap_file());
-      private_storage.WriteToFileIfChanged(private_path, nullptr);
+      auto private_storage = std::make_unique<StringOutputBuffer>();
+      writer.WritePrivateModuleMap(private_storage->stream(),
+                                   modulemap->GetDir());
+      FileWriteBatch::WriteFileIfChanged(
+          settings->build_settings()->GetFullPath(
+              *target->private_modulemap_file()),
+          std::move(private_storage));
     }
     writer.Run();
   } else {
@@ -197,9 +203,9 @@ std::string NinjaTargetWriter::RunAndWriteFile(
   if (needs_file_write) {
     // Write the ninja file.
     SourceFile ninja_file = GetNinjaFileForTarget(target);
-    base::FilePath full_ninja_file =
-        settings->build_settings()->GetFullPath(ninja_file);
-    storage.WriteToFileIfChanged(full_ninja_file, nullptr);
+    FileWriteBatch::WriteFileIfChanged(
+        settings->build_settings()->GetFullPath(ninja_file),
+        std::move(storage));
 
     EscapeOptions options;
     options.mode = ESCAPE_NINJA;
@@ -214,7 +220,7 @@ std::string NinjaTargetWriter::RunAndWriteFile(
   }
 
   // No separate file required, just return the rules.
-  return storage.str();
+  return storage->str();
 }
 
 // static
@@ -326,15 +332,52 @@ void NinjaTargetWriter::WriteSharedVars(const SubstitutionBits& bits) {
 void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
                                            bool indent,
                                            bool respect_source_used) {
+  const BuildSettings* build_settings = settings_->build_settings();
+  if (!build_settings->hoist_compiler_vars() || indent) {
+    WriteCCompilerVarsTo(out_, bits, indent, respect_source_used);
+    return;
+  }
+
+  // Replace long values with references to variables of the toolchain file.
+  std::ostringstream vars;
+  WriteCCompilerVarsTo(vars, bits, indent, respect_source_used);
+  NinjaVariableBundles* bundles = build_settings->ninja_variable_bundles();
+  std::string_view text = vars.view();
+  while (!text.empty()) {
+    size_t line_end = text.find('\n');
+    std::string_view line = text.substr(0, line_end);
+    text = line_end == std::string_view::npos ? std::string_view()
+                                              : text.substr(line_end + 1);
+
+    size_t equals = line.find(" =");
+    if (equals == std::string_view::npos) {
+      out_ << line << std::endl;
+      continue;
+    }
+    bundles->WriteVariable(settings_->toolchain_label(),
+                           line.substr(0, equals), line.substr(equals + 2),
+                           out_);
+  }
+}
+
+void NinjaTargetWriter::WriteCCompilerVarsTo(std::ostream& out,
+                                             const SubstitutionBits& bits,
+                                             bool indent,
+                                             bool respect_source_used) {
+  // Most targets share their configs, so their flags are rendered once.
+  ConfigFlagsCache* flags_cache =
+      settings_->build_settings()->config_flags_cache();
+
   // Defines.
   if (bits.used.count(&CSubstitutionDefines)) {
     if (indent)
-      out_ << "  ";
-    out_ << CSubstitutionDefines.ninja_name << " =";
-    RecursiveTargetConfigToStream<std::string>(kRecursiveWriterSkipDuplicates,
-                                               target_, &ConfigValues::defines,
-                                               DefineWriter(), out_);
-    out_ << std::endl;
+      out << "  ";
+    out << CSubstitutionDefines.ninja_name << " =";
+    flags_cache->Write<std::string>(&CSubstitutionDefines, std::string_view(),
+                                    kRecursiveWriterSkipDuplicates, target_,
+                                    &ConfigValues::defines, DefineWriter(),
+                                    out);
+    out << std::endl;
   }
 
   // Framework search path.
@@ -342,31 +385,35 @@ void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
     const Tool* tool = target_->toolchain()->GetTool(CTool::kCToolLink);
 
     if (indent)
-      out_ << "  ";
-    out_ << CSubstitutionFrameworkDirs.ninja_name << " =";
+      out << "  ";
+    out << CSubstitutionFrameworkDirs.ninja_name << " =";
     PathOutput framework_dirs_output(
         path_output_.current_dir(),
         settings_->build_settings()->root_path_utf8(), ESCAPE_NINJA_COMMAND);
-    RecursiveTargetConfigToStream<SourceDir>(
+    flags_cache->Write<SourceDir>(
+        &CSubstitutionFrameworkDirs,
+        path_output_.current_dir().value() + '\0' +
+            tool->framework_dir_switch(),
         kRecursiveWriterSkipDuplicates, target_, &ConfigValues::framework_dirs,
         FrameworkDirsWriter(framework_dirs_output,
                             tool->framework_dir_switch()),
-        out_);
-    out_ << std::endl;
+        out);
+    out << std::endl;
   }
 
   // Include directories.
   if (bits.used.count(&CSubstitutionIncludeDirs)) {
     if (indent)
-      out_ << "  ";
-    out_ << CSubstitutionIncludeDirs.ninja_name << " =";
+      out << "  ";
+    out << CSubstitutionIncludeDirs.ninja_name << " =";
     PathOutput include_path_output(
         path_output_.current_dir(),
         settings_->build_settings()->root_path_utf8(), ESCAPE_NINJA_COMMAND);
-    RecursiveTargetConfigToStream<SourceDir>(
+    flags_cache->Write<SourceDir>(
+        &CSubstitutionIncludeDirs, path_output_.current_dir().value(),
         kRecursiveWriterSkipDuplicates, target_, &ConfigValues::include_dirs,
-        IncludeWriter(include_path_output), out_);
-    out_ << std::endl;
+        IncludeWriter(include_path_output), out);
+    out << std::endl;
   }
 
   bool has_precompiled_headers =
@@ -379,7 +426,7 @@ void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
           : bits.used.count(&CSubstitutionAsmFlags)) {
     WriteOneFlag(kRecursiveWriterKeepDuplicates, target_,
                  &CSubstitutionAsmFlags, false, Tool::kToolNone,
-                 &ConfigValues::asmflags, opts, path_output_, out_, true,
+                 &ConfigValues::asmflags, opts, path_output_, out, true,
                  indent);
   }
   if (respect_source_used
@@ -391,14 +438,14 @@ void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
           : bits.used.count(&CSubstitutionCFlags)) {
     WriteOneFlag(kRecursiveWriterKeepDuplicates, target_, &CSubstitutionCFlags,
                  false, Tool::kToolNone, &ConfigValues::cflags, opts,
-                 path_output_, out_, true, indent);
+                 path_output_, out, true, indent);
   }
   if (respect_source_used
           ? target_->source_types_used().Get(SourceFile::SOURCE_C)
           : bits.used.count(&CSubstitutionCFlagsC)) {
     WriteOneFlag(kRecursiveWriterKeepDuplicates, target_, &CSubstitutionCFlagsC,
                  has_precompiled_headers, CTool::kCToolCc,
-                 &ConfigValues::cflags_c, opts, path_output_, out_, true,
+                 &ConfigValues::cflags_c, opts, path_output_, out, true,
                  indent);
   }
   if (respect_source_used
@@ -408,7 +455,7 @@ void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
     WriteOneFlag(kRecursiveWriterKeepDuplicates, target_,
                  &CSubstitutionCFlagsCc, has_precompiled_headers,
                  CTool::kCToolCxx, &ConfigValues::cflags_cc, opts, path_output_,
-                 out_, true, indent);
+                 out, true, indent);
   }
   if (respect_source_used
           ? target_->source_types_used().Get(SourceFile::SOURCE_M)
@@ -416,7 +463,7 @@ void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
     WriteOneFlag(kRecursiveWriterKeepDuplicates, target_,
                  &CSubstitutionCFlagsObjC, has_precompiled_headers,
                  CTool::kCToolObjC, &ConfigValues::cflags_objc, opts,
-                 path_output_, out_, true, indent);
+                 path_output_, out, true, indent);
   }
   if (respect_source_used
           ? target_->source_types_used().Get(SourceFile::SOURCE_MM)
@@ -424,27 +471,27 @@ void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
     WriteOneFlag(kRecursiveWriterKeepDuplicates, target_,
                  &CSubstitutionCFlagsObjCc, has_precompiled_headers,
                  CTool::kCToolObjCxx, &ConfigValues::cflags_objcc, opts,
-                 path_output_, out_, true, indent);
+                 path_output_, out, true, indent);
   }
   if (target_->source_types_used().SwiftSourceUsed() || !respect_source_used) {
     if (bits.used.count(&CSubstitutionSwiftModuleName)) {
       if (indent)
-        out_ << "  ";
-      out_ << CSubstitutionSwiftModuleName.ninja_name << " = ";
-      EscapeStringToStream(out_, target_->swift_values().module_name(), opts);
-      out_ << std::endl;
+        out << "  ";
+      out << CSubstitutionSwiftModuleName.ninja_name << " = ";
+      EscapeStringToStream(out, target_->swift_values().module_name(), opts);
+      out << std::endl;
     }
 
     if (bits.used.count(&CSubstitutionSwiftBridgeHeader)) {
       if (indent)
-        out_ << "  ";
-      out_ << CSubstitutionSwiftBridgeHeader.ninja_name << " = ";
+        out << "  ";
+      out << CSubstitutionSwiftBridgeHeader.ninja_name << " = ";
       if (!target_->swift_values().bridge_header().is_null()) {
-        path_output_.WriteFile(out_, target_->swift_values().bridge_header());
+        path_output_.WriteFile(out, target_->swift_values().bridge_header());
       } else {
-        out_ << R"("")";
+        out << R"("")";
       }
-      out_ << std::endl;
+      out << std::endl;
     }
 
     if (bits.used.count(&CSubstitutionSwiftModuleDirs)) {
@@ -455,21 +502,21 @@ void NinjaTargetWriter::WriteCCompilerVars(const SubstitutionBits& bits,
         swiftmodule_dirs.push_back(dep->swift_values().module_output_dir());
 
       if (indent)
-        out_ << "  ";
-      out_ << CSubstitutionSwiftModuleDirs.ninja_name << " =";
+        out << "  ";
+      out << CSubstitutionSwiftModuleDirs.ninja_name << " =";
       PathOutput swiftmodule_path_output(
           path_output_.current_dir(),
           settings_->build_settings()->root_path_utf8(), ESCAPE_NINJA_COMMAND);
       IncludeWriter swiftmodule_path_writer(swiftmodule_path_output);
       for (const SourceDir& swiftmodule_dir : swiftmodule_dirs) {
-        swiftmodule_path_writer(swiftmodule_dir, out_);
+        swiftmodule_path_writer(swiftmodule_dir, out);
       }
-      out_ << std::endl;
+      out << std::endl;
     }
 
     WriteOneFlag(kRecursiveWriterKeepDuplicates, target_,
                  &CSubstitutionSwiftFlags, false, CTool::kCToolSwift,
-                 &ConfigValues::swiftflags, opts, path_output_, out_, true,
+                 &ConfigValues::swiftflags, opts, path_output_, out, true,
                  indent);
   }
 }
@@ -7,6 +7,7 @@
 
 #include <iosfwd>
 
+#include "gn/output_sink.h"
 #include "gn/path_output.h"
 #include "gn/resolved_target_data.h"
 #include "gn/substitution_type.h"
@@ -20,7 +21,7 @@ struct SubstitutionBits;
 // generated by the NinjaBuildWriter.
 class NinjaTargetWriter {
  public:
-  NinjaTargetWriter(const Target* target, std::ostream& out);
+  NinjaTargetWriter(const Target* target, OutputSink out);
   virtual ~NinjaTargetWriter();
 
   // Returns a ResolvedTargetData that can be used to retrieve information
@@ -81,6 +82,10 @@ class NinjaTargetWriter {
   void WriteCCompilerVars(const SubstitutionBits& bits,
                           bool indent,
                           bool respect_source_used);
+  void WriteCCompilerVarsTo(std::ostream& out,
+                            const SubstitutionBits& bits,
+                            bool indent,
+                            bool respect_source_used);
 
   // Writes out the substitution values that are shared between Rust tools
   // and action tools. Only the substitutions identified by the given bits will
@@ -116,7 +121,7 @@ class NinjaTargetWriter {
 
   const Settings* settings_;  // Non-owning.
   const Target* target_;      // Non-owning.
-  std::ostream& out_;
+  OutputSink out_;
   PathOutput path_output_;
 
   // Write a Ninja output file to out_, and also add it to |*ninja_outputs_|
@@ -14,6 +14,7 @@
 #include "gn/filesystem_utils.h"
 #include "gn/general_tool.h"
 #include "gn/ninja_utils.h"
+#include "gn/ninja_variable_bundles.h"
 #include "gn/pool.h"
 #include "gn/settings.h"
 #include "gn/substitution_writer.h"
@@ -52,6 +53,13 @@ void NinjaToolchainWriter::Run(
   }
   out_ << std::endl;
 
+  // The variables shared by the targets must be defined before the subninja
+  // statements that read them.
+  if (settings_->build_settings()->hoist_compiler_vars()) {
+    settings_->build_settings()->ninja_variable_bundles()->WriteDefinitions(
+        settings_->toolchain_label(), out_);
+  }
+
   for (const auto& pair : rules)
     out_ << pair.second;
 }
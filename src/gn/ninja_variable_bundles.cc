@@ -0,0 +1,87 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/ninja_variable_bundles.h"
+
+#include <stdint.h>
+
+#include <ostream>
+
+#include "base/strings/stringprintf.h"
+
+namespace {
+
+// 64-bit FNV-1a. The names of the bundles must be the same on every run and
+// platform, which std::hash doesn't guarantee.
+uint64_t HashValue(std::string_view value) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (char c : value) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+// Returns true if |value| reads other ninja variables. Those would be
+// expanded in the scope of the toolchain file rather than the target's.
+bool ReadsVariables(std::string_view value) {
+  for (size_t i = value.find('$'); i != std::string_view::npos;
+       i = value.find('$', i + 2)) {
+    if (i + 1 == value.size())
+      return true;
+    char next = value[i + 1];
+    if (next != '$' && next != ' ' && next != ':')
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+NinjaVariableBundles::NinjaVariableBundles() = default;
+
+NinjaVariableBundles::~NinjaVariableBundles() = default;
+
+void NinjaVariableBundles::WriteVariable(const Label& toolchain,
+                                         std::string_view name,
+                                         std::string_view value,
+                                         std::ostream& out) {
+  out << name << " =";
+  std::string bundle = GetBundle(toolchain, name, value);
+  if (bundle.empty())
+    out << value;
+  else
+    out << " $" << bundle;
+  out << std::endl;
+}
+
+void NinjaVariableBundles::WriteDefinitions(const Label& toolchain,
+                                            std::ostream& out) const {
+  std::lock_guard<std::mutex> lock(lock_);
+  auto found = bundles_.find(toolchain);
+  if (found == bundles_.end())
+    return;
+  for (const auto& [bundle, value] : found->second)
+    out << bundle << " =" << value << std::endl;
+  out << std::endl;
+}
+
+std::string NinjaVariableBundles::GetBundle(const Label& toolchain,
+                                            std::string_view name,
+                                            std::string_view value) {
+  if (value.size() < kMinValueSize || ReadsVariables(value))
+    return std::string();
+
+  std::string bundle(name);
+  bundle += base::StringPrintf(
+      "_%016llx", static_cast<unsigned long long>(HashValue(value)));
+
+  std::lock_guard<std::mutex> lock(lock_);
+  auto [it, inserted] = bundles_[toolchain].emplace(bundle, value);
+  if (!inserted && it->second != value) {
+    // A hash collision. Keep the first value and write this one inline.
+    return std::string();
+  }
+  return bundle;
+}
@@ -0,0 +1,67 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_NINJA_VARIABLE_BUNDLES_H_
+#define TOOLS_GN_NINJA_VARIABLE_BUNDLES_H_
+
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "gn/label.h"
+
+// Variable values shared by the ninja files of the targets of a toolchain,
+// used by "gn gen --hoist-compiler-vars".
+//
+// Most binary targets set their compiler variables (cflags, defines,
+// include_dirs...) to one of a few long values. Instead of repeating them in
+// every target's .ninja file, each distinct value is defined once as a
+// "bundle" variable in the toolchain's .ninja file, which includes the
+// target files with "subninja" so they can read it, and the target files
+// set their variables to a reference to the bundle. Ninja expands the
+// reference when it loads the file, so the commands are unchanged.
+//
+// Bundles are named after the variable and the hash of their value, so the
+// output doesn't depend on the order in which targets are written.
+// Thread-safe.
+class NinjaVariableBundles {
+ public:
+  // Values shorter than this are written inline.
+  static constexpr size_t kMinValueSize = 64;
+
+  NinjaVariableBundles();
+  ~NinjaVariableBundles();
+
+  // Writes the ninja variable |name| with the given value to |out|, as a
+  // line "<name> =<value>", using a bundle of |toolchain| if possible.
+  // |value| is the text following the "=" as it would be written in the
+  // file, so it's already escaped for ninja.
+  void WriteVariable(const Label& toolchain,
+                     std::string_view name,
+                     std::string_view value,
+                     std::ostream& out);
+
+  // Writes the definitions of the bundles used by the targets of
+  // |toolchain|, sorted by name.
+  void WriteDefinitions(const Label& toolchain, std::ostream& out) const;
+
+ private:
+  // Returns the name of the bundle holding |value| for |name|, or an empty
+  // string if it can't be shared.
+  std::string GetBundle(const Label& toolchain,
+                        std::string_view name,
+                        std::string_view value);
+
+  mutable std::mutex lock_;
+
+  // Values of the bundles of each toolchain, indexed by bundle name.
+  std::map<Label, std::map<std::string, std::string>> bundles_;
+
+  NinjaVariableBundles(const NinjaVariableBundles&) = delete;
+  NinjaVariableBundles& operator=(const NinjaVariableBundles&) = delete;
+};
+
+#endif  // TOOLS_GN_NINJA_VARIABLE_BUNDLES_H_
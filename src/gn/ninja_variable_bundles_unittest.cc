@@ -0,0 +1,66 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/ninja_variable_bundles.h"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#include "base/strings/string_split.h"
+#include "util/test/test.h"
+
+TEST(NinjaVariableBundles, WriteVariable) {
+  NinjaVariableBundles bundles;
+  Label toolchain(SourceDir("//tc/"), "default");
+  Label other_toolchain(SourceDir("//tc/"), "other");
+
+  std::string long_value =
+      " -D" + std::string(NinjaVariableBundles::kMinValueSize, 'x');
+  std::ostringstream out;
+  bundles.WriteVariable(toolchain, "defines", " -DSHORT", out);
+  bundles.WriteVariable(toolchain, "defines", long_value, out);
+  bundles.WriteVariable(toolchain, "cflags", long_value, out);
+  bundles.WriteVariable(other_toolchain, "cflags", long_value, out);
+  // Values that read other variables are never shared.
+  bundles.WriteVariable(toolchain, "cflags_c", long_value + " $target_out_dir",
+                        out);
+  // But escapes are fine.
+  bundles.WriteVariable(toolchain, "cflags_cc", long_value + " a$ b$$c", out);
+
+  std::string lines = out.str();
+  EXPECT_EQ(0u, lines.find("defines = -DSHORT\ndefines = $defines_"));
+  EXPECT_NE(std::string::npos, lines.find("\ncflags = $cflags_"));
+  EXPECT_NE(std::string::npos,
+            lines.find("\ncflags_c =" + long_value + " $target_out_dir\n"));
+  EXPECT_NE(std::string::npos, lines.find("\ncflags_cc = $cflags_cc_"));
+
+  std::ostringstream definitions;
+  bundles.WriteDefinitions(toolchain, definitions);
+  std::string defined = definitions.str();
+  // Sorted by name, followed by a blank line.
+  std::vector<std::string> names;
+  for (std::string_view line : base::SplitStringPiece(
+           defined, "\n", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY))
+    names.emplace_back(line.substr(0, line.find(' ')));
+  ASSERT_EQ(3u, names.size());
+  EXPECT_TRUE(std::is_sorted(names.begin(), names.end()));
+  EXPECT_EQ(1, std::count_if(names.begin(), names.end(),
+                             [](const std::string& name) {
+                               return name.starts_with("cflags_cc_");
+                             }));
+  EXPECT_NE(std::string::npos, defined.find(" =" + long_value + "\n"));
+  EXPECT_EQ("\n\n", defined.substr(defined.size() - 2));
+
+  // The same value in another toolchain has the same name.
+  std::ostringstream other_definitions;
+  bundles.WriteDefinitions(other_toolchain, other_definitions);
+  std::string other = other_definitions.str();
+  ASSERT_EQ(0u, other.find("cflags_"));
+  EXPECT_NE(std::string::npos, defined.find(other.substr(0, other.find('\n'))));
+
+  std::ostringstream no_definitions;
+  bundles.WriteDefinitions(Label(SourceDir("//tc/"), "none"), no_definitions);
+  EXPECT_EQ("", no_definitions.str());
+}
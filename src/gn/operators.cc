@@ -10,6 +10,7 @@
 
 #include "base/strings/string_number_conversions.h"
 #include "gn/err.h"
+#include "gn/lazy_import.h"
 #include "gn/parse_tree.h"
 #include "gn/scope.h"
 #include "gn/token.h"
@@ -247,13 +248,8 @@ Value GetValueOrFillError(const BinaryOpNode* op_node,
   Value value = node->Execute(scope, err);
   if (err->has_error())
     return Value();
-  if (value.type() == Value::NONE) {
-    *err = Err(op_node->op(), "Operator requires a value.",
-               "This thing on the " + std::string(name) +
-                   " does not evaluate to a value.");
-    err->AppendRange(node->GetRange());
+  if (!VerifyBinaryOperand(op_node, node, value, name, err))
     return Value();
-  }
   return value;
 }
 
@@ -511,6 +507,33 @@ void ExecuteMinusEquals(const BinaryOpNode* op_node,
   RemoveMatchesFromList(op_node, mutable_dest, right, err);
 }
 
+// Applies the assignment operator of |op_node| to an initialized destination.
+// "foo += bar" (same for "-=") is converted to "foo = foo + bar" here, but we
+// pass the original value of "foo" by pointer to avoid a copy.
+void ExecuteAssignment(Scope* scope,
+                       const BinaryOpNode* op_node,
+                       ValueDestination* dest,
+                       Value right,
+                       Err* err) {
+  const Token& op = op_node->op();
+  if (right.type() == Value::NONE) {
+    *err = Err(op, "Operator requires a rvalue.",
+               "This thing on the right does not evaluate to a value.");
+    err->AppendRange(op_node->right()->GetRange());
+    return;
+  }
+
+  if (op.type() == Token::EQUAL) {
+    ExecuteEquals(scope, op_node, dest, std::move(right), err);
+  } else if (op.type() == Token::PLUS_EQUALS) {
+    ExecutePlusEquals(scope, op_node, dest, std::move(right), err);
+  } else if (op.type() == Token::MINUS_EQUALS) {
+    ExecuteMinusEquals(op_node, dest, right, err);
+  } else {
+    NOTREACHED();
+  }
+}
+
 // Comparison -----------------------------------------------------------------
 
 Value ExecuteEqualsEquals(Scope* scope,
@@ -595,24 +618,16 @@ Value ExecuteOr(Scope* scope,
   Value left = GetValueOrFillError(op_node, left_node, "left", scope, err);
   if (err->has_error())
     return Value();
-  if (left.type() != Value::BOOLEAN) {
-    *err = Err(op_node->left(), "Left side of || operator is not a boolean.",
-               "Type is \"" + std::string(Value::DescribeType(left.type())) +
-                   "\" instead.");
+  if (!VerifyBooleanOperand(op_node, left, true, err))
     return Value();
-  }
   if (left.boolean_value())
     return Value(op_node, left.boolean_value());
 
   Value right = GetValueOrFillError(op_node, right_node, "right", scope, err);
   if (err->has_error())
     return Value();
-  if (right.type() != Value::BOOLEAN) {
-    *err = Err(op_node->right(), "Right side of || operator is not a boolean.",
-               "Type is \"" + std::string(Value::DescribeType(right.type())) +
-                   "\" instead.");
+  if (!VerifyBooleanOperand(op_node, right, false, err))
     return Value();
-  }
 
   return Value(op_node, left.boolean_value() || right.boolean_value());
 }
@@ -625,24 +640,16 @@ Value ExecuteAnd(Scope* scope,
   Value left = GetValueOrFillError(op_node, left_node, "left", scope, err);
   if (err->has_error())
     return Value();
-  if (left.type() != Value::BOOLEAN) {
-    *err = Err(op_node->left(), "Left side of && operator is not a boolean.",
-               "Type is \"" + std::string(Value::DescribeType(left.type())) +
-                   "\" instead.");
+  if (!VerifyBooleanOperand(op_node, left, true, err))
     return Value();
-  }
   if (!left.boolean_value())
     return Value(op_node, left.boolean_value());
 
   Value right = GetValueOrFillError(op_node, right_node, "right", scope, err);
   if (err->has_error())
     return Value();
-  if (right.type() != Value::BOOLEAN) {
-    *err = Err(op_node->right(), "Right side of && operator is not a boolean.",
-               "Type is \"" + std::string(Value::DescribeType(right.type())) +
-                   "\" instead.");
+  if (!VerifyBooleanOperand(op_node, right, false, err))
     return Value();
-  }
   return Value(op_node, left.boolean_value() && right.boolean_value());
 }
 
@@ -650,6 +657,93 @@ Value ExecuteAnd(Scope* scope,
 
 // ----------------------------------------------------------------------------
 
+bool VerifyBinaryOperand(const BinaryOpNode* op_node,
+                         const ParseNode* operand,
+                         const Value& value,
+                         const char* side,
+                         Err* err) {
+  if (value.type() == Value::NONE) {
+    *err = Err(op_node->op(), "Operator requires a value.",
+               "This thing on the " + std::string(side) +
+                   " does not evaluate to a value.");
+    err->AppendRange(operand->GetRange());
+    return false;
+  }
+  return true;
+}
+
+bool VerifyBooleanOperand(const BinaryOpNode* op_node,
+                          const Value& value,
+                          bool is_left,
+                          Err* err) {
+  if (value.type() == Value::BOOLEAN)
+    return true;
+  std::string op(op_node->op().value());
+  *err = Err(is_left ? op_node->left() : op_node->right(),
+             std::string(is_left ? "Left" : "Right") + " side of " + op +
+                 " operator is not a boolean.",
+             "Type is \"" + std::string(Value::DescribeType(value.type())) +
+                 "\" instead.");
+  return false;
+}
+
+void ExecuteIdentifierAssignment(Scope* scope,
+                                 const BinaryOpNode* op_node,
+                                 Value right,
+                                 Err* err) {
+  DCHECK(op_node->left()->AsIdentifier());
+  ValueDestination dest;
+  if (!dest.Init(scope, op_node->left(), op_node, err))
+    return;
+  ExecuteAssignment(scope, op_node, &dest, std::move(right), err);
+}
+
+void ExecuteLazyAssignment(Scope* scope, const LazyValue* value, Err* err) {
+  const BinaryOpNode* op_node = value->assignment();
+  ValueDestination dest;
+  if (!dest.Init(scope, op_node->left(), op_node, err))
+    return;
+
+  // Same check as ExecuteEquals(). A constant is never a scope.
+  const Value* old_value = dest.GetExistingValue();
+  if (old_value && old_value->type() == Value::LIST &&
+      !old_value->list_value().empty() && value->is_nonempty_list()) {
+    *err = MakeOverwriteError(op_node, *old_value);
+    return;
+  }
+  scope->SetLazyValue(op_node->left()->AsIdentifier()->value().value(), value);
+}
+
+Value ExecuteBinaryOperatorOnValues(Scope* scope,
+                                    const BinaryOpNode* op_node,
+                                    Value left,
+                                    Value right,
+                                    Err* err) {
+  const Token& op = op_node->op();
+
+  // +, -.
+  if (op.type() == Token::MINUS)
+    return ExecuteMinus(op_node, std::move(left), right, err);
+  if (op.type() == Token::PLUS)
+    return ExecutePlus(op_node, std::move(left), std::move(right), true, err);
+
+  // Comparisons.
+  if (op.type() == Token::EQUAL_EQUAL)
+    return ExecuteEqualsEquals(scope, op_node, left, right, err);
+  if (op.type() == Token::NOT_EQUAL)
+    return ExecuteNotEquals(scope, op_node, left, right, err);
+  if (op.type() == Token::GREATER_EQUAL)
+    return ExecuteGreaterEquals(scope, op_node, left, right, err);
+  if (op.type() == Token::LESS_EQUAL)
+    return ExecuteLessEquals(scope, op_node, left, right, err);
+  if (op.type() == Token::GREATER_THAN)
+    return ExecuteGreater(scope, op_node, left, right, err);
+  if (op.type() == Token::LESS_THAN)
+    return ExecuteLess(scope, op_node, left, right, err);
+
+  return Value();
+}
+
 Value ExecuteUnaryOperator(Scope* scope,
                            const UnaryOpNode* op_node,
                            const Value& expr,
@@ -685,24 +779,7 @@ Value ExecuteBinaryOperator(Scope* scope,
     Value right_value = right->Execute(scope, err);
     if (err->has_error())
       return Value();
-    if (right_value.type() == Value::NONE) {
-      *err = Err(op, "Operator requires a rvalue.",
-                 "This thing on the right does not evaluate to a value.");
-      err->AppendRange(right->GetRange());
-      return Value();
-    }
-
-    // "foo += bar" (same for "-=") is converted to "foo = foo + bar" here, but
-    // we pass the original value of "foo" by pointer to avoid a copy.
-    if (op.type() == Token::EQUAL) {
-      ExecuteEquals(scope, op_node, &dest, std::move(right_value), err);
-    } else if (op.type() == Token::PLUS_EQUALS) {
-      ExecutePlusEquals(scope, op_node, &dest, std::move(right_value), err);
-    } else if (op.type() == Token::MINUS_EQUALS) {
-      ExecuteMinusEquals(op_node, &dest, right_value, err);
-    } else {
-      NOTREACHED();
-    }
+    ExecuteAssignment(scope, op_node, &dest, std::move(right_value), err);
     return Value();
   }
 
@@ -721,27 +798,6 @@ Value ExecuteBinaryOperator(Scope* scope,
   if (err->has_error())
     return Value();
 
-  // +, -.
-  if (op.type() == Token::MINUS)
-    return ExecuteMinus(op_node, std::move(left_value), right_value, err);
-  if (op.type() == Token::PLUS) {
-    return ExecutePlus(op_node, std::move(left_value), std::move(right_value),
-                       true, err);
-  }
-
-  // Comparisons.
-  if (op.type() == Token::EQUAL_EQUAL)
-    return ExecuteEqualsEquals(scope, op_node, left_value, right_value, err);
-  if (op.type() == Token::NOT_EQUAL)
-    return ExecuteNotEquals(scope, op_node, left_value, right_value, err);
-  if (op.type() == Token::GREATER_EQUAL)
-    return ExecuteGreaterEquals(scope, op_node, left_value, right_value, err);
-  if (op.type() == Token::LESS_EQUAL)
-    return ExecuteLessEquals(scope, op_node, left_value, right_value, err);
-  if (op.type() == Token::GREATER_THAN)
-    return ExecuteGreater(scope, op_node, left_value, right_value, err);
-  if (op.type() == Token::LESS_THAN)
-    return ExecuteLess(scope, op_node, left_value, right_value, err);
-
-  return Value();
+  return ExecuteBinaryOperatorOnValues(scope, op_node, std::move(left_value),
+                                       std::move(right_value), err);
 }
@@ -7,6 +7,7 @@
 
 class BinaryOpNode;
 class Err;
+class LazyValue;
 class ParseNode;
 class Scope;
 class UnaryOpNode;
@@ -22,4 +23,42 @@ Value ExecuteBinaryOperator(Scope* scope,
                             const ParseNode* right,
                             Err* err);
 
+// The following pieces of ExecuteBinaryOperator are exposed for callers that
+// evaluate the operands themselves (see bytecode.h). They produce the same
+// values and errors as ExecuteBinaryOperator does for the same input.
+
+// Verifies that the evaluated operand |value| of |op_node| is not none.
+// |operand| is the node that produced the value and |side| is "left" or
+// "right".
+bool VerifyBinaryOperand(const BinaryOpNode* op_node,
+                         const ParseNode* operand,
+                         const Value& value,
+                         const char* side,
+                         Err* err);
+
+// Verifies that an evaluated operand of a || or && operator is a boolean.
+bool VerifyBooleanOperand(const BinaryOpNode* op_node,
+                          const Value& value,
+                          bool is_left,
+                          Err* err);
+
+// Executes an assignment (=, +=, -=) whose left-hand side is an identifier,
+// given the already evaluated right-hand side.
+void ExecuteIdentifierAssignment(Scope* scope,
+                                 const BinaryOpNode* op_node,
+                                 Value right,
+                                 Err* err);
+
+// Executes the deferred assignment of |value| (see lazy_import.h) to an
+// identifier. Fails like the equivalent "=" would, without evaluating it.
+void ExecuteLazyAssignment(Scope* scope, const LazyValue* value, Err* err);
+
+// Executes an arithmetic or comparison operator on already evaluated
+// operands. Not valid for assignments, || or &&.
+Value ExecuteBinaryOperatorOnValues(Scope* scope,
+                                    const BinaryOpNode* op_node,
+                                    Value left,
+                                    Value right,
+                                    Err* err);
+
 #endif  // TOOLS_GN_OPERATORS_H_
@@ -34,8 +34,29 @@ class OutputFile {
   SourceFile AsSourceFile(const BuildSettings* build_settings) const;
   SourceDir AsSourceDir(const BuildSettings* build_settings) const;
 
-  bool operator==(const OutputFile& other) const = default;
-  std::strong_ordering operator<=>(const OutputFile& other) const = default;
+  // Since values are interned, equality and hashing only look at the
+  // StringAtom pointers. Ordering still compares the strings so that sorted
+  // containers are deterministic.
+  bool operator==(const OutputFile& other) const {
+    return value_.SameAs(other.value_);
+  }
+  bool operator!=(const OutputFile& other) const { return !operator==(other); }
+  bool operator<(const OutputFile& other) const {
+    return value_ < other.value_;
+  }
+  // Needs to be overridden because == has custom logic.
+  std::strong_ordering operator<=>(const OutputFile& other) const {
+    if (*this == other)
+      return std::strong_ordering::equal;
+    return *this < other ? std::strong_ordering::less
+                         : std::strong_ordering::greater;
+  }
+
+  struct PtrHash {
+    size_t operator()(const OutputFile& f) const noexcept {
+      return StringAtom::PtrHash()(f.value_);
+    }
+  };
 
  private:
   StringAtom value_;
@@ -46,7 +67,7 @@ namespace std {
 template <>
 struct hash<OutputFile> {
   std::size_t operator()(const OutputFile& v) const {
-    return hash<std::string_view>()(v.value());
+    return OutputFile::PtrHash()(v);
   }
 };
 
@@ -0,0 +1,35 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/output_file.h"
+
+#include <functional>
+#include <set>
+#include <string>
+
+#include "util/test/test.h"
+
+TEST(OutputFile, Compare) {
+  // Equal values built from different buffers are the same atom.
+  std::string buffer("obj/foo.o");
+  OutputFile a(buffer);
+  OutputFile b(std::string_view("obj/foo.o"));
+  OutputFile c(std::string_view("obj/bar.o"));
+
+  EXPECT_TRUE(a == b);
+  EXPECT_FALSE(a != b);
+  EXPECT_TRUE(a != c);
+  EXPECT_EQ(std::hash<OutputFile>()(a), std::hash<OutputFile>()(b));
+
+  // Ordering is based on the string values.
+  EXPECT_TRUE(c < a);
+  EXPECT_FALSE(a < c);
+  EXPECT_FALSE(a < b);
+  EXPECT_TRUE((a <=> b) == std::strong_ordering::equal);
+  EXPECT_TRUE((c <=> a) == std::strong_ordering::less);
+
+  std::set<OutputFile> set = {a, c, b};
+  ASSERT_EQ(2u, set.size());
+  EXPECT_EQ("obj/bar.o", set.begin()->value());
+}
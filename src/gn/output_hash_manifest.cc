@@ -0,0 +1,148 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/output_hash_manifest.h"
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "gn/err.h"
+#include "gn/filesystem_utils.h"
+
+namespace {
+
+const char kHeader[] = "# gn output hashes v1\n";
+
+// Returns the next space-separated field of |line| and removes it.
+std::string_view TakeField(std::string_view* line) {
+  size_t space = line->find(' ');
+  std::string_view field = line->substr(0, space);
+  line->remove_prefix(space == std::string_view::npos ? line->size()
+                                                      : space + 1);
+  return field;
+}
+
+}  // namespace
+
+const char OutputHashManifest::kFileName[] = ".gn_hashes";
+
+OutputHashManifest* OutputHashManifest::active_ = nullptr;
+
+OutputHashManifest::OutputHashManifest(const base::FilePath& manifest_path)
+    : manifest_path_(manifest_path) {}
+
+OutputHashManifest::~OutputHashManifest() = default;
+
+void OutputHashManifest::Load() {
+  std::string contents;
+  if (!base::ReadFileToString(manifest_path_, &contents) ||
+      !contents.starts_with(kHeader))
+    return;
+
+  // Each line is "<hash> <size> <mtime> <path>". The path comes last since
+  // it may contain spaces.
+  std::string_view remaining(contents);
+  remaining.remove_prefix(sizeof(kHeader) - 1);
+  std::lock_guard<std::mutex> lock(lock_);
+  while (!remaining.empty()) {
+    size_t newline = remaining.find('\n');
+    if (newline == std::string_view::npos)
+      break;  // Truncated.
+    std::string_view line = remaining.substr(0, newline);
+    remaining.remove_prefix(newline + 1);
+
+    Entry entry;
+    if (!base::HexStringToUInt64(TakeField(&line), &entry.hash) ||
+        !base::StringToUint64(TakeField(&line), &entry.size) ||
+        !base::StringToUint64(TakeField(&line), &entry.mtime) ||
+        line.empty()) {
+      previous_.clear();
+      return;
+    }
+    previous_[std::string(line)] = entry;
+  }
+}
+
+bool OutputHashManifest::Save(Err* err) const {
+  std::vector<std::pair<std::string_view, const Entry*>> entries;
+  std::string contents(kHeader);
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    for (const auto& [path, entry] : current_)
+      entries.emplace_back(path, &entry);
+    std::sort(entries.begin(), entries.end());
+    for (const auto& [path, entry] : entries) {
+      contents += base::StringPrintf(
+          "%016llx %llu %llu ", static_cast<unsigned long long>(entry->hash),
+          static_cast<unsigned long long>(entry->size),
+          static_cast<unsigned long long>(entry->mtime));
+      contents.append(path);
+      contents.push_back('\n');
+    }
+  }
+
+  // Write to a temporary file and rename it so that an interrupted run
+  // never leaves a partial manifest behind.
+  base::FilePath temp_path(manifest_path_.value() + FILE_PATH_LITERAL(".tmp"));
+  if (!WriteFile(temp_path, contents, err))
+    return false;
+  if (!base::ReplaceFile(temp_path, manifest_path_, nullptr)) {
+    *err = Err(Location(), "Unable to write file.",
+               "I was writing \"" + FilePathToUTF8(manifest_path_) + "\".");
+    return false;
+  }
+  return true;
+}
+
+bool OutputHashManifest::IsUnchanged(const base::FilePath& file_path,
+                                     uint64_t hash,
+                                     size_t size) {
+  std::string key = FilePathToUTF8(file_path);
+  Entry recorded;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto found = current_.find(key);
+    if (found == current_.end()) {
+      found = previous_.find(key);
+      if (found == previous_.end())
+        return false;
+    }
+    recorded = found->second;
+  }
+  if (recorded.hash != hash || recorded.size != size)
+    return false;
+
+  base::File::Info info;
+  if (!base::GetFileInfo(file_path, &info) || info.is_directory ||
+      static_cast<uint64_t>(info.size) != recorded.size ||
+      info.last_modified != recorded.mtime)
+    return false;
+
+  // Save() only writes the entries of this run.
+  std::lock_guard<std::mutex> lock(lock_);
+  current_[std::move(key)] = recorded;
+  return true;
+}
+
+void OutputHashManifest::Record(const base::FilePath& file_path,
+                                uint64_t hash,
+                                size_t size) {
+  base::File::Info info;
+  if (!base::GetFileInfo(file_path, &info) ||
+      static_cast<uint64_t>(info.size) != size)
+    return;
+
+  Entry entry;
+  entry.hash = hash;
+  entry.size = size;
+  entry.mtime = info.last_modified;
+  std::string key = FilePathToUTF8(file_path);
+  std::lock_guard<std::mutex> lock(lock_);
+  current_[std::move(key)] = entry;
+}
@@ -0,0 +1,79 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_OUTPUT_HASH_MANIFEST_H_
+#define TOOLS_GN_OUTPUT_HASH_MANIFEST_H_
+
+#include <stdint.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "base/files/file_path.h"
+
+class Err;
+
+// Remembers the hash of the contents of the files written with
+// StringOutputBuffer::WriteToFileIfChanged(), so that the next run can tell
+// that a file doesn't need to be written by hashing the new contents in
+// memory rather than reading the old ones back from disk.
+//
+// Each entry also records the size and modification time of the file after
+// it was written or checked. If either changed since, the file was modified
+// by someone else and the entry is ignored, so the caller falls back to
+// comparing with the file on disk.
+//
+// The manifest is stored in the build directory (see "gn gen
+// --hash-manifest"). It only keeps the entries of the files that were
+// written or checked during the current run. Thread-safe.
+class OutputHashManifest {
+ public:
+  // Name of the manifest file in the build directory.
+  static const char kFileName[];
+
+  explicit OutputHashManifest(const base::FilePath& manifest_path);
+  ~OutputHashManifest();
+
+  // Reads the manifest. A missing or invalid manifest is the same as an
+  // empty one.
+  void Load();
+
+  // Replaces the manifest file with the entries recorded during this run.
+  bool Save(Err* err) const;
+
+  // Returns true if |file_path| is known to contain data of the given hash
+  // and size. If so, its entry is kept for the next run, as if recorded.
+  bool IsUnchanged(const base::FilePath& file_path,
+                   uint64_t hash,
+                   size_t size);
+
+  // Records that |file_path| now contains data of the given hash and size.
+  void Record(const base::FilePath& file_path, uint64_t hash, size_t size);
+
+  // The manifest used by StringOutputBuffer::WriteToFileIfChanged(), if any.
+  // Must not be changed while files are being written.
+  static OutputHashManifest* active() { return active_; }
+  static void set_active(OutputHashManifest* manifest) { active_ = manifest; }
+
+ private:
+  struct Entry {
+    uint64_t hash = 0;
+    uint64_t size = 0;
+    uint64_t mtime = 0;
+  };
+
+  base::FilePath manifest_path_;
+
+  mutable std::mutex lock_;
+  std::unordered_map<std::string, Entry> previous_;  // From Load().
+  std::unordered_map<std::string, Entry> current_;   // Recorded this run.
+
+  static OutputHashManifest* active_;
+
+  OutputHashManifest(const OutputHashManifest&) = delete;
+  OutputHashManifest& operator=(const OutputHashManifest&) = delete;
+};
+
+#endif  // TOOLS_GN_OUTPUT_HASH_MANIFEST_H_
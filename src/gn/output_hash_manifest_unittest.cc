@@ -0,0 +1,128 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/output_hash_manifest.h"
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "gn/err.h"
+#include "gn/filesystem_utils.h"
+#include "gn/string_output_buffer.h"
+#include "util/test/test.h"
+
+namespace {
+
+// Activates a manifest for the lifetime of the instance.
+class ScopedActiveManifest {
+ public:
+  explicit ScopedActiveManifest(OutputHashManifest* manifest) {
+    OutputHashManifest::set_active(manifest);
+  }
+  ~ScopedActiveManifest() { OutputHashManifest::set_active(nullptr); }
+};
+
+}  // namespace
+
+TEST(OutputHashManifest, SkipsUnchangedFiles) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath manifest_path =
+      temp_dir.GetPath().AppendASCII(OutputHashManifest::kFileName);
+  base::FilePath file_path = temp_dir.GetPath().AppendASCII("foo.ninja");
+
+  StringOutputBuffer buffer;
+  buffer.Append("build foo: touch\n");
+
+  // First run: nothing is known, so the file is written and recorded.
+  {
+    OutputHashManifest manifest(manifest_path);
+    manifest.Load();
+    ScopedActiveManifest active(&manifest);
+    StringOutputBuffer::IoStats before = StringOutputBuffer::GetIoStats();
+    Err err;
+    ASSERT_TRUE(buffer.WriteToFileIfChanged(file_path, &err));
+    StringOutputBuffer::IoStats after = StringOutputBuffer::GetIoStats();
+    EXPECT_EQ(1u, after.files_written - before.files_written);
+    EXPECT_EQ(0u, after.files_hash_matched - before.files_hash_matched);
+    ASSERT_TRUE(manifest.Save(&err));
+  }
+
+  // Second run: the file is known to be up to date without reading it.
+  {
+    OutputHashManifest manifest(manifest_path);
+    manifest.Load();
+    EXPECT_TRUE(manifest.IsUnchanged(file_path, buffer.ContentHash(),
+                                     buffer.size()));
+    EXPECT_FALSE(manifest.IsUnchanged(file_path, buffer.ContentHash() + 1,
+                                      buffer.size()));
+    ScopedActiveManifest active(&manifest);
+    StringOutputBuffer::IoStats before = StringOutputBuffer::GetIoStats();
+    Err err;
+    ASSERT_TRUE(buffer.WriteToFileIfChanged(file_path, &err));
+    StringOutputBuffer::IoStats after = StringOutputBuffer::GetIoStats();
+    EXPECT_EQ(0u, after.files_written - before.files_written);
+    EXPECT_EQ(0u, after.files_compared - before.files_compared);
+    EXPECT_EQ(1u, after.files_hash_matched - before.files_hash_matched);
+    ASSERT_TRUE(manifest.Save(&err));
+  }
+
+  // Third run: the entry was kept by the second one, which only checked it.
+  {
+    OutputHashManifest manifest(manifest_path);
+    manifest.Load();
+    ScopedActiveManifest active(&manifest);
+    StringOutputBuffer::IoStats before = StringOutputBuffer::GetIoStats();
+    Err err;
+    ASSERT_TRUE(buffer.WriteToFileIfChanged(file_path, &err));
+    StringOutputBuffer::IoStats after = StringOutputBuffer::GetIoStats();
+    EXPECT_EQ(0u, after.files_written - before.files_written);
+    EXPECT_EQ(0u, after.files_compared - before.files_compared);
+    EXPECT_EQ(1u, after.files_hash_matched - before.files_hash_matched);
+    ASSERT_TRUE(manifest.Save(&err));
+  }
+
+  // Modified by someone else: the entry is stale and the file is rewritten.
+  ASSERT_TRUE(WriteFile(file_path, "modified\n", nullptr));
+  {
+    OutputHashManifest manifest(manifest_path);
+    manifest.Load();
+    EXPECT_FALSE(manifest.IsUnchanged(file_path, buffer.ContentHash(),
+                                      buffer.size()));
+    ScopedActiveManifest active(&manifest);
+    StringOutputBuffer::IoStats before = StringOutputBuffer::GetIoStats();
+    Err err;
+    ASSERT_TRUE(buffer.WriteToFileIfChanged(file_path, &err));
+    StringOutputBuffer::IoStats after = StringOutputBuffer::GetIoStats();
+    EXPECT_EQ(1u, after.files_written - before.files_written);
+    EXPECT_EQ(0u, after.files_hash_matched - before.files_hash_matched);
+    EXPECT_TRUE(buffer.ContentsEqual(file_path));
+  }
+}
+
+TEST(OutputHashManifest, InvalidManifest) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath manifest_path =
+      temp_dir.GetPath().AppendASCII(OutputHashManifest::kFileName);
+  base::FilePath file_path = temp_dir.GetPath().AppendASCII("foo.ninja");
+
+  StringOutputBuffer buffer;
+  buffer.Append("foo\n");
+  ASSERT_TRUE(buffer.WriteToFile(file_path, nullptr));
+
+  // Missing manifest.
+  OutputHashManifest missing(manifest_path);
+  missing.Load();
+  EXPECT_FALSE(
+      missing.IsUnchanged(file_path, buffer.ContentHash(), buffer.size()));
+
+  // Garbage is ignored rather than trusted.
+  ASSERT_TRUE(WriteFile(manifest_path, "# gn output hashes v1\nfoo bar\n",
+                        nullptr));
+  OutputHashManifest invalid(manifest_path);
+  invalid.Load();
+  EXPECT_FALSE(
+      invalid.IsUnchanged(file_path, buffer.ContentHash(), buffer.size()));
+}
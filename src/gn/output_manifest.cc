@@ -0,0 +1,178 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/output_manifest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <string_view>
+
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "gn/err.h"
+#include "gn/filesystem_utils.h"
+#include "gn/parallel_for.h"
+
+namespace {
+
+const char kHeader[] = "# gn output manifest v2\n";
+
+// Separates the outputs of the run that saved the manifest from the older
+// ones.
+const char kOlderHeader[] = "# older\n";
+
+// Below this, deleting the files isn't worth a thread.
+constexpr size_t kMinDeletesPerThread = 64;
+
+// Appends |outputs|, which must be sorted, to |contents| without duplicates.
+// Each line only has the part of its output that differs from the previous
+// one.
+void AppendOutputs(const std::vector<std::string>& outputs,
+                   std::string* contents) {
+  const std::string* previous = nullptr;
+  for (const std::string& output : outputs) {
+    if (previous && *previous == output)
+      continue;
+    size_t prefix_length = 0;
+    if (previous) {
+      prefix_length =
+          std::mismatch(previous->begin(), previous->end(), output.begin(),
+                        output.end())
+              .first -
+          previous->begin();
+    }
+    contents->append(base::NumberToString(prefix_length));
+    contents->push_back(' ');
+    contents->append(output, prefix_length);
+    contents->push_back('\n');
+    previous = &output;
+  }
+}
+
+// Reads the lines of |remaining| written by AppendOutputs() into |outputs|,
+// up to the end or to the next header. Returns false if a line is invalid.
+bool ReadOutputs(std::string_view* remaining,
+                 std::vector<std::string>* outputs) {
+  // Each line is "<length> <suffix>": the output is the first <length>
+  // characters of the previous one followed by <suffix>.
+  while (!remaining->empty() && !remaining->starts_with('#')) {
+    size_t newline = remaining->find('\n');
+    size_t space = remaining->find(' ');
+    unsigned prefix_length;
+    if (newline == std::string_view::npos || space > newline ||
+        !base::StringToUint(remaining->substr(0, space), &prefix_length) ||
+        (outputs->empty() ? prefix_length != 0
+                          : prefix_length > outputs->back().size())) {
+      return false;
+    }
+    std::string output = outputs->empty()
+                             ? std::string()
+                             : outputs->back().substr(0, prefix_length);
+    output.append(remaining->substr(space + 1, newline - space - 1));
+    outputs->push_back(std::move(output));
+    remaining->remove_prefix(newline + 1);
+  }
+  return true;
+}
+
+// Returns true if |output| may be deleted from the build directory.
+bool IsInBuildDir(const std::string& output) {
+  return !output.empty() && !IsPathAbsolute(output) &&
+         !output.starts_with("../") && output != "..";
+}
+
+}  // namespace
+
+const char OutputManifest::kFileName[] = ".gn_outputs";
+
+OutputManifest::OutputManifest(const base::FilePath& build_dir)
+    : build_dir_(build_dir) {}
+
+OutputManifest::~OutputManifest() = default;
+
+bool OutputManifest::Load() {
+  outputs_.clear();
+  latest_outputs_.clear();
+  std::string contents;
+  if (!base::ReadFileToString(build_dir_.AppendASCII(kFileName), &contents) ||
+      !contents.starts_with(kHeader))
+    return false;
+
+  std::string_view remaining(contents);
+  remaining.remove_prefix(sizeof(kHeader) - 1);
+  bool valid = ReadOutputs(&remaining, &latest_outputs_) &&
+               remaining.starts_with(kOlderHeader);
+  std::vector<std::string> older;
+  if (valid) {
+    remaining.remove_prefix(sizeof(kOlderHeader) - 1);
+    valid = ReadOutputs(&remaining, &older) && remaining.empty();
+  }
+  if (!valid) {
+    latest_outputs_.clear();
+    return false;
+  }
+  std::merge(latest_outputs_.begin(), latest_outputs_.end(), older.begin(),
+             older.end(), std::back_inserter(outputs_));
+  return true;
+}
+
+size_t OutputManifest::DeleteStaleOutputs(
+    const std::vector<std::string>& current_outputs) const {
+  std::vector<const std::string*> stale;
+  auto current = current_outputs.begin();
+  for (const std::string& output : outputs_) {
+    current = std::lower_bound(current, current_outputs.end(), output);
+    if ((current == current_outputs.end() || *current != output) &&
+        IsInBuildDir(output))
+      stale.push_back(&output);
+  }
+
+  std::atomic<size_t> deleted = 0;
+  ParallelFor(stale.size(), kMinDeletesPerThread,
+              [this, &stale, &deleted](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                  base::FilePath path =
+                      build_dir_.Append(UTF8ToFilePath(*stale[i]));
+                  // Only files: deleting a directory would delete the files
+                  // in it, which may be outputs of the current build.
+                  base::File::Info info;
+                  if (base::GetFileInfo(path, &info) && !info.is_directory &&
+                      base::DeleteFile(path, false)) {
+                    ++deleted;
+                  }
+                }
+              });
+  return deleted;
+}
+
+bool OutputManifest::Save(const std::vector<std::string>& current_outputs,
+                          bool keep_loaded,
+                          Err* err) const {
+  std::vector<std::string> older;
+  if (keep_loaded) {
+    std::set_difference(outputs_.begin(), outputs_.end(),
+                        current_outputs.begin(), current_outputs.end(),
+                        std::back_inserter(older));
+  }
+
+  std::string contents(kHeader);
+  AppendOutputs(current_outputs, &contents);
+  contents.append(kOlderHeader);
+  AppendOutputs(older, &contents);
+
+  // Write to a temporary file and rename it so that an interrupted run
+  // never leaves a partial manifest behind.
+  base::FilePath manifest_path = build_dir_.AppendASCII(kFileName);
+  base::FilePath temp_path(manifest_path.value() + FILE_PATH_LITERAL(".tmp"));
+  if (!WriteFile(temp_path, contents, err))
+    return false;
+  if (!base::ReplaceFile(temp_path, manifest_path, nullptr)) {
+    *err = Err(Location(), "Unable to write file.",
+               "I was writing \"" + FilePathToUTF8(manifest_path) + "\".");
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,73 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_OUTPUT_MANIFEST_H_
+#define TOOLS_GN_OUTPUT_MANIFEST_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+
+class Err;
+
+// Lists the outputs of the build steps that the "gn gen" runs of a build
+// directory declared since it was last cleaned, so that "gn gen --clean-stale"
+// can delete the ones that the build no longer has without asking ninja.
+//
+// Once a build directory has a manifest, each "gn gen" adds its outputs to it,
+// so that the outputs that a later run removes are known. "gn gen
+// --clean-stale" deletes the files of the manifest that the current build
+// doesn't have, and then only keeps its outputs. The outputs of the latest run
+// are listed apart from the older ones, so that "gn clean_stale" can do the
+// same without loading the build.
+//
+// The outputs are relative to the build directory and sorted. Each line of
+// the manifest only has the part of its output that differs from the previous
+// one, which is most of the time the file name.
+class OutputManifest {
+ public:
+  // Name of the manifest file in the build directory.
+  static const char kFileName[];
+
+  explicit OutputManifest(const base::FilePath& build_dir);
+  ~OutputManifest();
+
+  // Reads the manifest. Returns false if it is missing or invalid, in which
+  // case the manifest is empty.
+  bool Load();
+
+  // All the outputs of the manifest.
+  const std::vector<std::string>& outputs() const { return outputs_; }
+
+  // The outputs of the run that saved the manifest.
+  const std::vector<std::string>& latest_outputs() const {
+    return latest_outputs_;
+  }
+
+  // Deletes the files of the manifest that are not in |current_outputs|,
+  // which must be sorted. Directories and paths outside of the build
+  // directory are never deleted. Returns the number of deleted files.
+  size_t DeleteStaleOutputs(
+      const std::vector<std::string>& current_outputs) const;
+
+  // Replaces the manifest file with |current_outputs|, which must be sorted,
+  // as the latest outputs, and with the other loaded outputs if
+  // |keep_loaded|.
+  bool Save(const std::vector<std::string>& current_outputs,
+            bool keep_loaded,
+            Err* err) const;
+
+ private:
+  base::FilePath build_dir_;
+  std::vector<std::string> outputs_;         // From Load().
+  std::vector<std::string> latest_outputs_;  // From Load().
+
+  OutputManifest(const OutputManifest&) = delete;
+  OutputManifest& operator=(const OutputManifest&) = delete;
+};
+
+#endif  // TOOLS_GN_OUTPUT_MANIFEST_H_
@@ -0,0 +1,78 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/output_manifest.h"
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "gn/err.h"
+#include "gn/filesystem_utils.h"
+#include "util/test/test.h"
+
+TEST(OutputManifest, SaveAndLoad) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+
+  OutputManifest manifest(temp_dir.GetPath());
+  EXPECT_FALSE(manifest.Load());
+
+  std::vector<std::string> outputs = {"gen/a b.h", "obj/foo/a.o",
+                                      "obj/foo/a.o", "obj/foo/b.o",
+                                      "obj/foobar.o"};
+  Err err;
+  ASSERT_TRUE(manifest.Save(outputs, false, &err));
+  ASSERT_TRUE(manifest.Load());
+  std::vector<std::string> expected = {"gen/a b.h", "obj/foo/a.o",
+                                       "obj/foo/b.o", "obj/foobar.o"};
+  EXPECT_EQ(expected, manifest.outputs());
+  EXPECT_EQ(expected, manifest.latest_outputs());
+
+  // Keeping the loaded outputs adds the new ones to them.
+  ASSERT_TRUE(manifest.Save({"obj/bar.o", "obj/foo/b.o"}, true, &err));
+  OutputManifest merged(temp_dir.GetPath());
+  ASSERT_TRUE(merged.Load());
+  expected = {"gen/a b.h", "obj/bar.o", "obj/foo/a.o", "obj/foo/b.o",
+              "obj/foobar.o"};
+  EXPECT_EQ(expected, merged.outputs());
+  expected = {"obj/bar.o", "obj/foo/b.o"};
+  EXPECT_EQ(expected, merged.latest_outputs());
+
+  // A corrupted manifest is empty.
+  ASSERT_TRUE(WriteFile(temp_dir.GetPath().AppendASCII(
+                            OutputManifest::kFileName),
+                        "# gn output manifest v2\n0 a\n# older\n9 b\n",
+                        &err));
+  EXPECT_FALSE(merged.Load());
+  EXPECT_TRUE(merged.outputs().empty());
+  EXPECT_TRUE(merged.latest_outputs().empty());
+}
+
+TEST(OutputManifest, DeleteStaleOutputs) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath build_dir = temp_dir.GetPath().AppendASCII("out");
+  ASSERT_TRUE(base::CreateDirectory(build_dir.AppendASCII("obj")));
+  ASSERT_TRUE(base::CreateDirectory(build_dir.AppendASCII("bundle")));
+  base::FilePath source = temp_dir.GetPath().AppendASCII("source.cc");
+  Err err;
+  for (const char* name : {"obj/kept.o", "obj/stale.o", "bundle/file"}) {
+    ASSERT_TRUE(WriteFile(build_dir.AppendASCII(name), "", &err));
+  }
+  ASSERT_TRUE(WriteFile(source, "", &err));
+
+  OutputManifest manifest(build_dir);
+  ASSERT_TRUE(manifest.Save({"../source.cc", "bundle", "obj/kept.o",
+                             "obj/missing.o", "obj/stale.o"},
+                            false, &err));
+  ASSERT_TRUE(manifest.Load());
+
+  // Only the stale file is deleted: not the directory, nor the file outside
+  // of the build directory.
+  EXPECT_EQ(1u, manifest.DeleteStaleOutputs({"obj/kept.o"}));
+  EXPECT_FALSE(base::PathExists(build_dir.AppendASCII("obj/stale.o")));
+  EXPECT_TRUE(base::PathExists(build_dir.AppendASCII("obj/kept.o")));
+  EXPECT_TRUE(base::PathExists(build_dir.AppendASCII("bundle/file")));
+  EXPECT_TRUE(base::PathExists(source));
+}
@@ -0,0 +1,108 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_OUTPUT_SINK_H_
+#define TOOLS_GN_OUTPUT_SINK_H_
+
+#include <charconv>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "gn/string_output_buffer.h"
+
+// Where the ninja writers write their output. It's a cheap handle that is
+// passed by value.
+//
+// Each << on a std::ostream makes a virtual call to its streambuf, after
+// constructing a sentry and checking the formatting state of the stream.
+// When the destination is a StringOutputBuffer, an OutputSink appends to it
+// with inlined code instead. Otherwise it writes to the std::ostream it was
+// created from, so code and tests writing to any stream keep working.
+//
+// It converts implicitly from and to std::ostream so that the functions
+// taking either one can be called with both. Writes through the sink and
+// through the stream are kept in order. Like a pointer, a const sink can be
+// written to.
+class OutputSink {
+ public:
+  // Writes to |buffer|.
+  OutputSink(StringOutputBuffer* buffer) : buffer_(buffer) {}
+
+  // Writes to |out|, or directly to its StringOutputBuffer if it's the
+  // stream() of one.
+  OutputSink(std::ostream& out)
+      : buffer_(StringOutputBuffer::FromStream(out)), stream_(&out) {}
+
+  // Returns a std::ostream writing to the same destination.
+  std::ostream& stream() const {
+    return stream_ ? *stream_ : buffer_->stream();
+  }
+  operator std::ostream&() const { return stream(); }
+
+  void Append(std::string_view str) const {
+    if (buffer_)
+      buffer_->Append(str);
+    else
+      stream_->write(str.data(), str.size());
+  }
+  void Append(char c) const {
+    if (buffer_)
+      buffer_->Append(c);
+    else
+      stream_->put(c);
+  }
+
+  const OutputSink& operator<<(std::string_view str) const {
+    Append(str);
+    return *this;
+  }
+  const OutputSink& operator<<(const std::string& str) const {
+    Append(std::string_view(str));
+    return *this;
+  }
+  const OutputSink& operator<<(const char* str) const {
+    Append(std::string_view(str));
+    return *this;
+  }
+  const OutputSink& operator<<(char c) const {
+    Append(c);
+    return *this;
+  }
+
+  // Integers are written in decimal like std::ostream does by default.
+  template <typename T,
+            typename = std::enable_if_t<std::is_integral_v<T> &&
+                                        !std::is_same_v<T, char> &&
+                                        !std::is_same_v<T, signed char> &&
+                                        !std::is_same_v<T, unsigned char>>>
+  const OutputSink& operator<<(T value) const {
+    if constexpr (std::is_same_v<T, bool>) {
+      Append(value ? '1' : '0');
+    } else {
+      char buf[24];
+      std::to_chars_result result =
+          std::to_chars(buf, buf + sizeof(buf), value);
+      Append(std::string_view(buf, result.ptr - buf));
+    }
+    return *this;
+  }
+
+  // For std::endl and std::flush.
+  const OutputSink& operator<<(
+      std::ostream& (*manipulator)(std::ostream&)) const {
+    if (buffer_ && manipulator == &std::endl<char, std::char_traits<char>>)
+      Append('\n');  // Flushing a StringOutputBuffer does nothing.
+    else
+      manipulator(stream());
+    return *this;
+  }
+
+ private:
+  StringOutputBuffer* buffer_ = nullptr;
+  std::ostream* stream_ = nullptr;
+};
+
+#endif  // TOOLS_GN_OUTPUT_SINK_H_
@@ -0,0 +1,56 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/output_sink.h"
+
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "util/test/test.h"
+
+namespace {
+
+void WriteSample(OutputSink out) {
+  out << "build" << ' ' << std::string("foo.o") << ":";
+  out << std::string_view(" cxx");
+  out << std::endl;
+  out << "  count = " << 42 << " " << -7 << " " << size_t{1234567890123}
+      << " " << true << std::endl;
+  // Through the stream, which must keep the order.
+  out.stream() << "  via_stream = " << 3.5;
+  out << '\n';
+}
+
+const char kExpectedSample[] =
+    "build foo.o: cxx\n"
+    "  count = 42 -7 1234567890123 1\n"
+    "  via_stream = 3.5\n";
+
+}  // namespace
+
+TEST(OutputSink, WritesToBuffer) {
+  StringOutputBuffer buffer;
+  WriteSample(&buffer);
+  EXPECT_EQ(kExpectedSample, buffer.str());
+}
+
+TEST(OutputSink, WritesToStream) {
+  std::ostringstream out;
+  WriteSample(out);
+  EXPECT_EQ(kExpectedSample, out.str());
+}
+
+TEST(OutputSink, FindsBufferOfStream) {
+  StringOutputBuffer buffer;
+  EXPECT_TRUE(StringOutputBuffer::FromStream(buffer.stream()) == &buffer);
+
+  std::ostringstream other;
+  EXPECT_TRUE(StringOutputBuffer::FromStream(other) == nullptr);
+
+  // Code that only has the std::ostream still writes to the buffer.
+  std::ostream& out = buffer.stream();
+  WriteSample(out);
+  EXPECT_EQ(kExpectedSample, buffer.str());
+}
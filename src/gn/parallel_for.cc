@@ -0,0 +1,85 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/parallel_for.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include "util/sys_info.h"
+#include "util/worker_pool.h"
+
+namespace {
+
+// The ranges of one ParallelFor() call.
+struct Ranges {
+  Ranges(size_t count,
+         size_t max_range_count,
+         const std::function<void(size_t begin, size_t end)>& work)
+      : count(count),
+        range_size((count + max_range_count - 1) / max_range_count),
+        range_count((count + range_size - 1) / range_size),
+        work(work) {}
+
+  const size_t count;
+  const size_t range_size;
+  const size_t range_count;  // No range is empty.
+  const std::function<void(size_t begin, size_t end)>& work;
+
+  std::atomic<size_t> next_range = 0;
+
+  std::mutex lock;
+  std::condition_variable all_done;
+  size_t done_count = 0;  // Protected by |lock|.
+};
+
+// Runs the ranges nobody took yet. The calling thread runs them too, so a
+// pool task that starts once all the ranges are taken does nothing. This also
+// makes calls from the worker threads themselves safe.
+void RunRanges(Ranges* ranges) {
+  for (size_t i = ranges->next_range++; i < ranges->range_count;
+       i = ranges->next_range++) {
+    size_t begin = i * ranges->range_size;
+    ranges->work(begin, std::min(begin + ranges->range_size, ranges->count));
+
+    std::lock_guard<std::mutex> lock(ranges->lock);
+    if (++ranges->done_count == ranges->range_count)
+      ranges->all_done.notify_all();
+  }
+}
+
+WorkerPool* GetWorkerPool() {
+  // Deliberately leaked, like the other process-wide state.
+  static WorkerPool* pool = new WorkerPool;
+  return pool;
+}
+
+}  // namespace
+
+void ParallelFor(size_t count,
+                 size_t min_range_size,
+                 const std::function<void(size_t begin, size_t end)>& work) {
+  size_t range_count = std::min<size_t>(
+      std::max(NumberOfProcessors(), 1),
+      std::max<size_t>(count / std::max<size_t>(min_range_size, 1), 1));
+  if (range_count <= 1) {
+    if (count)
+      work(0, count);
+    return;
+  }
+
+  // The tasks may outlive this call, until they find that no range is left.
+  auto ranges = std::make_shared<Ranges>(count, range_count, work);
+  WorkerPool* pool = GetWorkerPool();
+  for (size_t i = 1; i < ranges->range_count; ++i)
+    pool->PostTask([ranges]() { RunRanges(ranges.get()); });
+  RunRanges(ranges.get());
+
+  std::unique_lock<std::mutex> lock(ranges->lock);
+  ranges->all_done.wait(
+      lock, [&ranges]() { return ranges->done_count == ranges->range_count; });
+}
@@ -0,0 +1,25 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_PARALLEL_FOR_H_
+#define TOOLS_GN_PARALLEL_FOR_H_
+
+#include <stddef.h>
+
+#include <functional>
+
+// Calls |work| on consecutive ranges [begin, end) covering [0, count), from
+// the calling thread and the threads of a WorkerPool shared by all calls, and
+// returns once all of them are done. No range is smaller than
+// |min_range_size| so that small loops run inline on the calling thread.
+//
+// This is meant for the serial steps of "gn gen" that run after the
+// Scheduler is done, where the work items are independent but the results
+// have to be combined in a deterministic order: each range typically fills
+// its own part of a vector sized beforehand.
+void ParallelFor(size_t count,
+                 size_t min_range_size,
+                 const std::function<void(size_t begin, size_t end)>& work);
+
+#endif  // TOOLS_GN_PARALLEL_FOR_H_
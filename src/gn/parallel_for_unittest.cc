@@ -0,0 +1,28 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/parallel_for.h"
+
+#include <atomic>
+#include <vector>
+
+#include "util/test/test.h"
+
+TEST(ParallelFor, CoversAllItemsOnce) {
+  for (size_t count : {0, 1, 7, 100, 10007}) {
+    std::vector<int> seen(count);
+    std::atomic<size_t> ranges = 0;
+    ParallelFor(count, 10, [&seen, &ranges](size_t begin, size_t end) {
+      EXPECT_TRUE(begin < end);
+      for (size_t i = begin; i < end; ++i)
+        ++seen[i];
+      ++ranges;
+    });
+    for (size_t i = 0; i < count; ++i)
+      EXPECT_EQ(1, seen[i]) << "item " << i << " of " << count;
+    if (count < 20) {
+      EXPECT_EQ(count ? 1u : 0u, ranges.load());
+    }
+  }
+}
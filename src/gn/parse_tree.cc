@@ -15,7 +15,9 @@
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "gn/bytecode.h"
 #include "gn/functions.h"
+#include "gn/lazy_import.h"
 #include "gn/operators.h"
 #include "gn/scope.h"
 #include "gn/string_utils.h"
@@ -622,24 +624,11 @@ Value BlockNode::Execute(Scope* enclosing_scope, Err* err) const {
     execution_scope = enclosing_scope;
   }
 
-  for (size_t i = 0; i < statements_.size() && !err->has_error(); i++) {
-    // Check for trying to execute things with no side effects in a block.
-    //
-    // A BlockNode here means that somebody has a free-floating { }.
-    // Technically this can have side effects since it could generated targets,
-    // but we don't want to allow this since it creates ambiguity when
-    // immediately following a function call that takes no block. By not
-    // allowing free-floating blocks that aren't passed anywhere or assigned to
-    // anything, this ambiguity is resolved.
-    const ParseNode* cur = statements_[i].get();
-    if (cur->AsList() || cur->AsLiteral() || cur->AsUnaryOp() ||
-        cur->AsIdentifier() || cur->AsBlock()) {
-      *err = cur->MakeErrorDescribing(
-          "This statement has no effect.",
-          "Either delete it or do something with the result.");
-      return Value();
-    }
-    cur->Execute(execution_scope, err);
+  if (bytecode_) {
+    bytecode_->Execute(execution_scope, err);
+  } else {
+    for (size_t i = 0; i < statements_.size() && !err->has_error(); i++)
+      ExecuteStatement(statements_[i].get(), execution_scope, err);
   }
 
   if (result_mode_ == RETURNS_SCOPE) {
@@ -652,6 +641,36 @@ Value BlockNode::Execute(Scope* enclosing_scope, Err* err) const {
   return Value();
 }
 
+void BlockNode::set_bytecode(std::unique_ptr<BytecodeChunk> bytecode) {
+  bytecode_ = std::move(bytecode);
+}
+
+void BlockNode::set_lazy_import(std::unique_ptr<LazyImport> lazy_import) {
+  lazy_import_ = std::move(lazy_import);
+}
+
+// static
+void BlockNode::ExecuteStatement(const ParseNode* statement,
+                                 Scope* scope,
+                                 Err* err) {
+  // Check for trying to execute things with no side effects in a block.
+  //
+  // A BlockNode here means that somebody has a free-floating { }.
+  // Technically this can have side effects since it could generated
+  // targets, but we don't want to allow this since it creates ambiguity
+  // when immediately following a function call that takes no block. By
+  // not allowing free-floating blocks that aren't passed anywhere or
+  // assigned to anything, this ambiguity is resolved.
+  if (statement->AsList() || statement->AsLiteral() || statement->AsUnaryOp() ||
+      statement->AsIdentifier() || statement->AsBlock()) {
+    *err = statement->MakeErrorDescribing(
+        "This statement has no effect.",
+        "Either delete it or do something with the result.");
+    return;
+  }
+  statement->Execute(scope, err);
+}
+
 LocationRange BlockNode::GetRange() const {
   if (begin_token_.type() != Token::INVALID &&
       end_->value().type() != Token::INVALID) {
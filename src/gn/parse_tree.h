@@ -22,10 +22,12 @@ class AccessorNode;
 class BinaryOpNode;
 class BlockCommentNode;
 class BlockNode;
+class BytecodeChunk;
 class ConditionNode;
 class EndNode;
 class FunctionCallNode;
 class IdentifierNode;
+class LazyImport;
 class ListNode;
 class LiteralNode;
 class Scope;
@@ -343,6 +345,22 @@ class BlockNode : public ParseNode {
 
   ResultMode result_mode() const { return result_mode_; }
 
+  // Compiled form of the statements of this block, if any. When present,
+  // Execute() runs it instead of walking the statements.
+  const BytecodeChunk* bytecode() const { return bytecode_.get(); }
+  void set_bytecode(std::unique_ptr<BytecodeChunk> bytecode);
+
+  // How to execute this block as an imported file in lazy import mode, if it
+  // is the root of a file. See lazy_import.h.
+  const LazyImport* lazy_import() const { return lazy_import_.get(); }
+  void set_lazy_import(std::unique_ptr<LazyImport> lazy_import);
+
+  // Executes |statement| as one of the statements of a block. Fails if it's
+  // an expression whose result would be thrown away.
+  static void ExecuteStatement(const ParseNode* statement,
+                               Scope* scope,
+                               Err* err);
+
   const std::vector<std::unique_ptr<ParseNode>>& statements() const {
     return statements_;
   }
@@ -371,6 +389,9 @@ class BlockNode : public ParseNode {
 
   std::vector<std::unique_ptr<ParseNode>> statements_;
 
+  std::unique_ptr<BytecodeChunk> bytecode_;  // May be null.
+  std::unique_ptr<LazyImport> lazy_import_;  // May be null.
+
   BlockNode(const BlockNode&) = delete;
   BlockNode& operator=(const BlockNode&) = delete;
 };
@@ -391,6 +412,7 @@ class ConditionNode : public ParseNode {
   base::Value GetJSONNode() const override;
   static std::unique_ptr<ConditionNode> NewFromJSON(const base::Value& value);
 
+  const Token& if_token() const { return if_token_; }
   void set_if_token(const Token& token) { if_token_ = token; }
 
   const ParseNode* condition() const { return condition_.get(); }
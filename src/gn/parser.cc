@@ -637,6 +637,22 @@ std::unique_ptr<ParseNode> Parser::DotOperator(std::unique_ptr<ParseNode> left,
   return accessor;
 }
 
+bool Parser::IsLiteralListItem(Token::Type stop_before) const {
+  if (cur_ + 1 >= tokens_.size())
+    return false;
+  switch (cur_token().type()) {
+    case Token::INTEGER:
+    case Token::STRING:
+    case Token::TRUE_TOKEN:
+    case Token::FALSE_TOKEN:
+      break;
+    default:
+      return false;
+  }
+  Token::Type next = tokens_[cur_ + 1].type();
+  return next == Token::COMMA || next == stop_before;
+}
+
 // Does not Consume the start or end token.
 std::unique_ptr<ListNode> Parser::ParseList(const Token& start_token,
                                             Token::Type stop_before,
@@ -655,6 +671,15 @@ std::unique_ptr<ListNode> Parser::ParseList(const Token& start_token,
     }
     first_time = false;
 
+    if (IsLiteralListItem(stop_before)) {
+      // Fast path for the common case of a literal followed by a comma or
+      // the end of the list, which is all that generated source lists are
+      // made of. This is equivalent to the general case below.
+      list->append_item(Literal(Consume()));
+      just_got_comma = Match(Token::COMMA);
+      continue;
+    }
+
     // Why _OR? We're parsing things that are higher precedence than the ,
     // that separates the items of the list. , should appear lower than
     // boolean expressions (the lowest of which is OR), but above assignments.
@@ -74,6 +74,10 @@ class Parser {
                                       Token::Type stop_before,
                                       bool allow_trailing_comma);
 
+  // Returns true if the current token is a literal that makes up a whole
+  // item of a list ending with |stop_before|.
+  bool IsLiteralListItem(Token::Type stop_before) const;
+
   std::unique_ptr<ParseNode> ParseFile();
   std::unique_ptr<ParseNode> ParseStatement();
   // Expects to be passed the token corresponding to the '{' and that the
@@ -218,9 +218,24 @@ TEST(Parser, List) {
                         " LITERAL(3)\n"
                         " LITERAL(4)\n");
 
+  // Mixes literal items, which take a fast path, with expressions.
+  DoExpressionPrintTest("[\"a\", \"b\" + \"c\", true, false == 1, \"d\"]",
+                        "LIST\n"
+                        " LITERAL(\"a\")\n"
+                        " BINARY(+)\n"
+                        "  LITERAL(\"b\")\n"
+                        "  LITERAL(\"c\")\n"
+                        " LITERAL(true)\n"
+                        " BINARY(==)\n"
+                        "  LITERAL(false)\n"
+                        "  LITERAL(1)\n"
+                        " LITERAL(\"d\")\n");
+
   DoExpressionErrorTest("[a, 2+,]", 1, 7);
   DoExpressionErrorTest("[,]", 1, 2);
   DoExpressionErrorTest("[a,,]", 1, 4);
+  DoExpressionErrorTest("[1 2]", 1, 4);
+  DoExpressionErrorTest("[\"a\",,]", 1, 6);
 }
 
 TEST(Parser, Assignment) {
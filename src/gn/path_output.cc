@@ -18,15 +18,16 @@ PathOutput::PathOutput(const SourceDir& current_dir,
   if (!EndsWithSlash(inverse_current_dir_))
     inverse_current_dir_.push_back('/');
   options_.mode = escaping;
+  UpdateEscapedInverseCurrentDir();
 }
 
 PathOutput::~PathOutput() = default;
 
-void PathOutput::WriteFile(std::ostream& out, const SourceFile& file) const {
+void PathOutput::WriteFile(OutputSink out, const SourceFile& file) const {
   WritePathStr(out, file.value());
 }
 
-void PathOutput::WriteDir(std::ostream& out,
+void PathOutput::WriteDir(OutputSink out,
                           const SourceDir& dir,
                           DirSlashEnding slash_ending) const {
   if (dir.value() == "/") {
@@ -44,8 +45,8 @@ void PathOutput::WriteDir(std::ostream& out,
       if (inverse_current_dir_.empty()) {
         out << ".";
       } else {
-        out.write(inverse_current_dir_.c_str(),
-                  inverse_current_dir_.size() - 1);
+        out.Append(std::string_view(inverse_current_dir_.c_str(),
+                                    inverse_current_dir_.size() - 1));
       }
     } else {
       if (inverse_current_dir_.empty())
@@ -69,12 +70,12 @@ void PathOutput::WriteDir(std::ostream& out,
   }
 }
 
-void PathOutput::WriteFile(std::ostream& out, const OutputFile& file) const {
+void PathOutput::WriteFile(OutputSink out, const OutputFile& file) const {
   // Here we assume that the path is already preprocessed.
   EscapeStringToStream(out, file.value(), options_);
 }
 
-void PathOutput::WriteFiles(std::ostream& out,
+void PathOutput::WriteFiles(OutputSink out,
                             const std::vector<SourceFile>& files) const {
   for (const auto& file : files) {
     out << " ";
@@ -82,7 +83,7 @@ void PathOutput::WriteFiles(std::ostream& out,
   }
 }
 
-void PathOutput::WriteFiles(std::ostream& out,
+void PathOutput::WriteFiles(OutputSink out,
                             const std::vector<OutputFile>& files) const {
   for (const auto& file : files) {
     out << " ";
@@ -90,7 +91,7 @@ void PathOutput::WriteFiles(std::ostream& out,
   }
 }
 
-void PathOutput::WriteFiles(std::ostream& out,
+void PathOutput::WriteFiles(OutputSink out,
                             const UniqueVector<OutputFile>& files) const {
   for (const auto& file : files) {
     out << " ";
@@ -98,7 +99,7 @@ void PathOutput::WriteFiles(std::ostream& out,
   }
 }
 
-void PathOutput::WriteDir(std::ostream& out,
+void PathOutput::WriteDir(OutputSink out,
                           const OutputFile& file,
                           DirSlashEnding slash_ending) const {
   DCHECK(file.value().empty() || file.value()[file.value().size() - 1] == '/');
@@ -122,15 +123,18 @@ void PathOutput::WriteDir(std::ostream& out,
   }
 }
 
-void PathOutput::WriteFile(std::ostream& out,
+void PathOutput::WriteFile(OutputSink out,
                            const base::FilePath& file) const {
   // Assume native file paths are always absolute.
   EscapeStringToStream(out, FilePathToUTF8(file), options_);
 }
 
-void PathOutput::WriteSourceRelativeString(std::ostream& out,
+void PathOutput::WriteSourceRelativeString(OutputSink out,
                                            std::string_view str) const {
-  if (options_.mode == ESCAPE_NINJA_COMMAND) {
+  if (escaped_inverse_current_dir_) {
+    out << *escaped_inverse_current_dir_;
+    EscapeStringToStream(out, str, options_);
+  } else {
     // Shell escaping needs an intermediate string since it may end up
     // quoting the whole thing.
     std::string intermediate;
@@ -142,15 +146,28 @@ void PathOutput::WriteSourceRelativeString(std::ostream& out,
     EscapeStringToStream(
         out, std::string_view(intermediate.c_str(), intermediate.size()),
         options_);
+  }
+}
+
+void PathOutput::UpdateEscapedInverseCurrentDir() {
+  // Posix shell escaping is done one character at a time, but the Windows
+  // one may quote the whole string, so it needs the whole path.
+  bool windows_shell = false;
+  if (options_.mode == ESCAPE_NINJA_COMMAND) {
+    windows_shell = options_.platform == ESCAPE_PLATFORM_WIN;
+#if defined(OS_WIN)
+    windows_shell |= options_.platform == ESCAPE_PLATFORM_CURRENT;
+#endif
+  }
+  if (windows_shell) {
+    escaped_inverse_current_dir_.reset();
   } else {
-    // Ninja (and none) escaping can avoid the intermediate string and
-    // reprocessing of the inverse_current_dir_.
-    EscapeStringToStream(out, inverse_current_dir_, options_);
-    EscapeStringToStream(out, str, options_);
+    escaped_inverse_current_dir_ =
+        EscapeString(inverse_current_dir_, options_, nullptr);
   }
 }
 
-void PathOutput::WritePathStr(std::ostream& out, std::string_view str) const {
+void PathOutput::WritePathStr(OutputSink out, std::string_view str) const {
   DCHECK(str.size() > 0 && str[0] == '/');
 
   if (str.substr(0, current_dir_.value().size()) ==
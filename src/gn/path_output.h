@@ -6,6 +6,7 @@
 #define TOOLS_GN_PATH_OUTPUT_H_
 
 #include <iosfwd>
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -20,7 +21,7 @@ namespace base {
 class FilePath;
 }
 
-// Writes file names to streams assuming a certain input directory and
+// Writes file names to sinks assuming a certain input directory and
 // escaping rules. This gives us a central place for managing this state.
 class PathOutput {
  public:
@@ -45,44 +46,58 @@ class PathOutput {
 
   // Getter/setters for flags inside the escape options.
   bool inhibit_quoting() const { return options_.inhibit_quoting; }
-  void set_inhibit_quoting(bool iq) { options_.inhibit_quoting = iq; }
-  void set_escape_platform(EscapingPlatform p) { options_.platform = p; }
-
-  void WriteFile(std::ostream& out, const SourceFile& file) const;
-  void WriteFile(std::ostream& out, const OutputFile& file) const;
-  void WriteFile(std::ostream& out, const base::FilePath& file) const;
+  void set_inhibit_quoting(bool iq) {
+    options_.inhibit_quoting = iq;
+    UpdateEscapedInverseCurrentDir();
+  }
+  void set_escape_platform(EscapingPlatform p) {
+    options_.platform = p;
+    UpdateEscapedInverseCurrentDir();
+  }
+
+  void WriteFile(OutputSink out, const SourceFile& file) const;
+  void WriteFile(OutputSink out, const OutputFile& file) const;
+  void WriteFile(OutputSink out, const base::FilePath& file) const;
 
   // Writes the given SourceFiles/OutputFiles with spaces separating them. This
   // will also write an initial space before the first item.
-  void WriteFiles(std::ostream& out, const std::vector<SourceFile>& file) const;
-  void WriteFiles(std::ostream& out,
+  void WriteFiles(OutputSink out, const std::vector<SourceFile>& file) const;
+  void WriteFiles(OutputSink out,
                   const std::vector<OutputFile>& files) const;
-  void WriteFiles(std::ostream& out,
+  void WriteFiles(OutputSink out,
                   const UniqueVector<OutputFile>& files) const;
 
   // This variant assumes the dir ends in a trailing slash or is empty.
-  void WriteDir(std::ostream& out,
+  void WriteDir(OutputSink out,
                 const SourceDir& dir,
                 DirSlashEnding slash_ending) const;
 
-  void WriteDir(std::ostream& out,
+  void WriteDir(OutputSink out,
                 const OutputFile& file,
                 DirSlashEnding slash_ending) const;
 
   // Backend for WriteFile and WriteDir. This appends the given file or
   // directory string to the file.
-  void WritePathStr(std::ostream& out, std::string_view str) const;
+  void WritePathStr(OutputSink out, std::string_view str) const;
 
  private:
   // Takes the given string and writes it out, appending to the inverse
   // current dir. This assumes leading slashes have been trimmed.
-  void WriteSourceRelativeString(std::ostream& out, std::string_view str) const;
+  void WriteSourceRelativeString(OutputSink out, std::string_view str) const;
+
+  // Computes escaped_inverse_current_dir_ for the current options.
+  void UpdateEscapedInverseCurrentDir();
 
   SourceDir current_dir_;
 
   // Uses system slashes if convert_slashes_to_system_.
   std::string inverse_current_dir_;
 
+  // The inverse_current_dir_ escaped with options_, which is written before
+  // every source-relative path. Not set for Windows shell escaping, which
+  // must see the whole path since it may quote it.
+  std::optional<std::string> escaped_inverse_current_dir_;
+
   // Since the inverse_current_dir_ depends on some of these, we don't expose
   // this directly to modification.
   EscapeOptions options_;
@@ -143,6 +143,41 @@ TEST(PathOutput, NinjaForkEscaping) {
   }
 }
 
+#if !defined(OS_WIN)
+// The path from an out-of-tree build dir back to the source root is escaped
+// like the rest of the path, including after the escaping options change.
+TEST(PathOutput, EscapedSourceRoot) {
+  SourceDir build_dir("/out/Debug/");
+  std::string_view source_root("/source root");
+  PathOutput writer(build_dir, source_root, ESCAPE_NINJA);
+  {
+    std::ostringstream out;
+    writer.WriteFile(out, SourceFile("//foo:bar.cc"));
+    EXPECT_EQ("../../source$ root/foo$:bar.cc", out.str());
+  }
+
+  PathOutput command_writer(build_dir, source_root, ESCAPE_NINJA_COMMAND);
+  command_writer.set_escape_platform(ESCAPE_PLATFORM_POSIX);
+  {
+    std::ostringstream out;
+    command_writer.WriteFile(out, SourceFile("//foo.cc"));
+    EXPECT_EQ("../../source\\$ root/foo.cc", out.str());
+  }
+  command_writer.set_escape_platform(ESCAPE_PLATFORM_WIN);
+  {
+    std::ostringstream out;
+    command_writer.WriteFile(out, SourceFile("//foo.cc"));
+    EXPECT_EQ("\"../../source$ root/foo.cc\"", out.str());
+  }
+  command_writer.set_inhibit_quoting(true);
+  {
+    std::ostringstream out;
+    command_writer.WriteFile(out, SourceFile("//foo.cc"));
+    EXPECT_EQ("../../source$ root/foo.cc", out.str());
+  }
+}
+#endif
+
 TEST(PathOutput, InhibitQuoting) {
   SourceDir build_dir("//out/Debug/");
   std::string_view source_root("/source/root");
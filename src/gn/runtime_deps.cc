@@ -40,12 +40,13 @@ std::string SourceAsOutputFile(const std::string& str, const Target* source) {
 // data dep (true = data_dep). data deps add more stuff, so we will want to
 // revisit a target if it's a data dependency and we've previously only seen it
 // as a regular dep. `on_file` may be called more than once for the same output
-// file.
+// file. The files of each target come from `cache`.
 template <typename F>
 void RecursiveCollectRuntimeDeps(
     const Target* target,
     bool is_target_data_dep,
     F&& on_file,
+    RuntimeDepsCache* cache,
     std::unordered_map<const Target*, bool>* seen_targets) {
   auto [found_seen_target, inserted] =
       seen_targets->try_emplace(target, is_target_data_dep);
@@ -61,40 +62,28 @@ void RecursiveCollectRuntimeDeps(
     found_seen_target->second = is_target_data_dep;
   }
 
-  // Add the main output file for executables, shared libraries, and
-  // loadable modules.
-  if (target->output_type() == Target::EXECUTABLE ||
-      target->output_type() == Target::LOADABLE_MODULE ||
-      target->output_type() == Target::SHARED_LIBRARY) {
-    for (const auto& runtime_output : target->runtime_outputs())
-      on_file(runtime_output.value(), target);
-  }
-
-  // Add all data files.
-  for (const auto& file : target->data())
-    on_file(SourceAsOutputFile(file, target), target);
+  // The main output file for executables, shared libraries, and loadable
+  // modules, and all data files.
+  const RuntimeDepsCache::Files& files = cache->GetFiles(target);
+  for (const auto& file : files.own)
+    on_file(file.value(), target);
 
   // Actions/copy have all outputs considered when the're a data dep.
-  if (is_target_data_dep && (target->output_type() == Target::ACTION ||
-                             target->output_type() == Target::ACTION_FOREACH ||
-                             target->output_type() == Target::COPY_FILES)) {
-    std::vector<SourceFile> outputs;
-    target->action_values().GetOutputsAsSourceFiles(target, &outputs);
-    for (const auto& output_file : outputs)
-      on_file(SourceAsOutputFile(output_file.value(), target), target);
+  if (is_target_data_dep) {
+    for (const auto& file : files.data_dep_outputs)
+      on_file(file.value(), target);
   }
 
   // Data dependencies.
   for (const auto& dep_pair : target->data_deps()) {
-    RecursiveCollectRuntimeDeps(dep_pair.ptr, true, on_file, seen_targets);
+    RecursiveCollectRuntimeDeps(dep_pair.ptr, true, on_file, cache,
+                                seen_targets);
   }
 
   // Do not recurse into bundle targets. A bundle's dependencies should be
   // copied into the bundle itself for run-time access.
   if (target->output_type() == Target::CREATE_BUNDLE) {
-    SourceDir bundle_root_dir =
-        target->bundle_data().GetBundleRootDirOutputAsDir(target->settings());
-    on_file(SourceAsOutputFile(bundle_root_dir.value(), target), target);
+    on_file(files.bundle_root.value(), target);
     return;
   }
 
@@ -109,12 +98,15 @@ void RecursiveCollectRuntimeDeps(
       // unless it were listed in data deps.
       continue;
     }
-    RecursiveCollectRuntimeDeps(dep_pair.ptr, false, on_file, seen_targets);
+    RecursiveCollectRuntimeDeps(dep_pair.ptr, false, on_file, cache,
+                                seen_targets);
   }
 }
 
 // Streams the output file for all runtime deps of `target` to `out`.
-void StreamRuntimeDeps(const Target* target, std::ostream& out) {
+void StreamRuntimeDeps(const Target* target,
+                       RuntimeDepsCache* cache,
+                       std::ostream& out) {
   std::unordered_map<const Target*, bool> seen_targets;
 
   // The initial target is not considered a data dependency so that actions's
@@ -122,9 +114,9 @@ void StreamRuntimeDeps(const Target* target, std::ostream& out) {
   // considered data deps.
   auto on_file = [&out](std::string_view output_file,
                         const Target* target) -> void {
-    out << output_file << std::endl;
+    out << output_file << '\n';
   };
-  RecursiveCollectRuntimeDeps(target, false, on_file, &seen_targets);
+  RecursiveCollectRuntimeDeps(target, false, on_file, cache, &seen_targets);
 }
 
 bool CollectRuntimeDepsFromFlag(const BuildSettings* build_settings,
@@ -206,6 +198,7 @@ bool CollectRuntimeDepsFromFlag(const BuildSettings* build_settings,
 
 bool WriteRuntimeDepsFile(const OutputFile& output_file,
                           const Target* target,
+                          RuntimeDepsCache* cache,
                           Err* err) {
   SourceFile output_as_source =
       output_file.AsSourceFile(target->settings()->build_settings());
@@ -214,7 +207,7 @@ bool WriteRuntimeDepsFile(const OutputFile& output_file,
 
   StringOutputBuffer storage;
   std::ostream contents(&storage);
-  StreamRuntimeDeps(target, contents);
+  StreamRuntimeDeps(target, cache, contents);
 
   ScopedTrace trace(TraceItem::TRACE_FILE_WRITE, output_as_source.value());
   return storage.WriteToFileIfChanged(data_deps_file, err);
@@ -291,9 +284,60 @@ Multiple outputs
   the tool, the default will be the first output only.
 )";
 
-RuntimeDepsVector ComputeRuntimeDeps(const Target* target) {
+RuntimeDepsCache::RuntimeDepsCache() = default;
+
+RuntimeDepsCache::~RuntimeDepsCache() = default;
+
+const RuntimeDepsCache::Files& RuntimeDepsCache::GetFiles(
+    const Target* target) {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto found = files_.find(target);
+    if (found != files_.end())
+      return *found->second;
+  }
+
+  // Rebasing the files is the costly part, so it is done outside of the lock.
+  // Two threads may then compute the files of the same target, but they get
+  // the same result and the first one is kept.
+  auto files = std::make_unique<Files>();
+  if (target->output_type() == Target::EXECUTABLE ||
+      target->output_type() == Target::LOADABLE_MODULE ||
+      target->output_type() == Target::SHARED_LIBRARY) {
+    files->own = target->runtime_outputs();
+  }
+  for (const auto& file : target->data())
+    files->own.emplace_back(SourceAsOutputFile(file, target));
+
+  if (target->output_type() == Target::ACTION ||
+      target->output_type() == Target::ACTION_FOREACH ||
+      target->output_type() == Target::COPY_FILES) {
+    std::vector<SourceFile> outputs;
+    target->action_values().GetOutputsAsSourceFiles(target, &outputs);
+    for (const auto& output_file : outputs) {
+      files->data_dep_outputs.emplace_back(
+          SourceAsOutputFile(output_file.value(), target));
+    }
+  }
+
+  if (target->output_type() == Target::CREATE_BUNDLE) {
+    SourceDir bundle_root_dir =
+        target->bundle_data().GetBundleRootDirOutputAsDir(target->settings());
+    files->bundle_root =
+        OutputFile(SourceAsOutputFile(bundle_root_dir.value(), target));
+  }
+
+  std::lock_guard<std::mutex> lock(lock_);
+  return *files_.emplace(target, std::move(files)).first->second;
+}
+
+RuntimeDepsVector ComputeRuntimeDeps(const Target* target,
+                                     RuntimeDepsCache* cache) {
   RuntimeDepsVector result;
   std::unordered_map<const Target*, bool> seen_targets;
+  RuntimeDepsCache local_cache;
+  if (!cache)
+    cache = &local_cache;
 
   auto on_file = [&result](std::string_view output_file, const Target* target) {
     result.emplace_back(OutputFile(output_file), target);
@@ -301,7 +345,7 @@ RuntimeDepsVector ComputeRuntimeDeps(const Target* target) {
   // The initial target is not considered a data dependency so that actions's
   // outputs (if the current target is an action) are not automatically
   // considered data deps.
-  RecursiveCollectRuntimeDeps(target, false, on_file, &seen_targets);
+  RecursiveCollectRuntimeDeps(target, false, on_file, cache, &seen_targets);
   return result;
 }
 
@@ -314,11 +358,16 @@ bool WriteRuntimeDepsFilesIfNecessary(const BuildSettings* build_settings,
     err.PrintToStdout();
     return false;
   }
+
+  // The runtime deps files are written in parallel, and share the files of
+  // the targets they have in common.
+  RuntimeDepsCache cache;
   for (auto& entry : files_to_write) {
     g_scheduler->ScheduleWork(
-        [output_file = std::move(entry.first), target = entry.second]() {
+        [output_file = std::move(entry.first), target = entry.second,
+         cache = &cache]() {
           Err err;
-          if (!WriteRuntimeDepsFile(output_file, target, &err)) {
+          if (!WriteRuntimeDepsFile(output_file, target, cache, &err)) {
             g_scheduler->FailWithError(err);
           }
         });
@@ -327,9 +376,10 @@ bool WriteRuntimeDepsFilesIfNecessary(const BuildSettings* build_settings,
   // Files scheduled by write_runtime_deps.
   for (const Target* target : g_scheduler->GetWriteRuntimeDepsTargets()) {
     g_scheduler->ScheduleWork(
-        [output_file = target->write_runtime_deps_output(), target]() {
+        [output_file = target->write_runtime_deps_output(), target,
+         cache = &cache]() {
           Err err;
-          if (!WriteRuntimeDepsFile(output_file, target, &err)) {
+          if (!WriteRuntimeDepsFile(output_file, target, cache, &err)) {
             g_scheduler->FailWithError(err);
           }
         });
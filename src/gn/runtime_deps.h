@@ -5,22 +5,58 @@
 #ifndef TOOLS_GN_RUNTIME_DEPS_H
 #define TOOLS_GN_RUNTIME_DEPS_H
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "gn/output_file.h"
+
 class Builder;
 class BuildSettings;
 class Err;
-class OutputFile;
 class Target;
 
 extern const char kRuntimeDeps_Help[];
 
+// The files each target adds to the runtime deps of the targets depending on
+// it, relative to the build directory. The runtime deps of many targets mostly
+// visit the same targets, so computing them with the same cache only rebases
+// these files once per target. The targets must outlive the cache.
+// Thread-safe.
+class RuntimeDepsCache {
+ public:
+  struct Files {
+    // The runtime outputs of executables and libraries, then the data files.
+    std::vector<OutputFile> own;
+
+    // The outputs of actions and copies, only added when they are data deps.
+    std::vector<OutputFile> data_dep_outputs;
+
+    // The bundle directory of create_bundle targets, empty for other targets.
+    OutputFile bundle_root;
+  };
+
+  RuntimeDepsCache();
+  ~RuntimeDepsCache();
+
+  const Files& GetFiles(const Target* target);
+
+ private:
+  std::mutex lock_;
+  std::unordered_map<const Target*, std::unique_ptr<Files>> files_;
+
+  RuntimeDepsCache(const RuntimeDepsCache&) = delete;
+  RuntimeDepsCache& operator=(const RuntimeDepsCache&) = delete;
+};
+
 // Computes the runtime dependencies of the given target. The result is a list
 // of pairs listing the runtime dependency and the target that the runtime
-// dependency is from (for blaming).
+// dependency is from (for blaming). |cache| may be shared with other calls.
 std::vector<std::pair<OutputFile, const Target*>> ComputeRuntimeDeps(
-    const Target* target);
+    const Target* target,
+    RuntimeDepsCache* cache = nullptr);
 
 // Writes all runtime deps files requested on the command line, or does nothing
 // if no files were specified.
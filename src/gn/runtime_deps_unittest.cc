@@ -419,6 +419,45 @@ TEST_F(RuntimeDeps, Dupe) {
       << GetVectorDescription(result);
 }
 
+// Tests that targets sharing a cache get the same runtime deps as without it,
+// including for a dep which is a data dep of only one of them.
+TEST_F(RuntimeDeps, SharedCache) {
+  TestWithScope setup;
+  Err err;
+
+  Target action(setup.settings(), Label(SourceDir("//"), "action"));
+  InitTargetWithType(setup, &action, Target::ACTION);
+  action.action_values().outputs() =
+      SubstitutionList::MakeForTest("//action.output");
+  action.data().push_back("//action.dat");
+  ASSERT_TRUE(action.OnResolved(&err));
+
+  Target first(setup.settings(), Label(SourceDir("//"), "first"));
+  InitTargetWithType(setup, &first, Target::EXECUTABLE);
+  first.private_deps().push_back(LabelTargetPair(&action));
+  ASSERT_TRUE(first.OnResolved(&err));
+
+  Target second(setup.settings(), Label(SourceDir("//"), "second"));
+  InitTargetWithType(setup, &second, Target::EXECUTABLE);
+  second.data_deps().push_back(LabelTargetPair(&action));
+  ASSERT_TRUE(second.OnResolved(&err));
+
+  RuntimeDepsCache cache;
+  std::vector<std::pair<OutputFile, const Target*>> first_result =
+      ComputeRuntimeDeps(&first, &cache);
+  std::vector<std::pair<OutputFile, const Target*>> second_result =
+      ComputeRuntimeDeps(&second, &cache);
+  EXPECT_TRUE(first_result == ComputeRuntimeDeps(&first))
+      << GetVectorDescription(first_result);
+  EXPECT_TRUE(second_result == ComputeRuntimeDeps(&second))
+      << GetVectorDescription(second_result);
+
+  ASSERT_EQ(2u, first_result.size()) << GetVectorDescription(first_result);
+  EXPECT_TRUE(MakePair("../../action.dat", &action) == first_result[1]);
+  ASSERT_EQ(3u, second_result.size()) << GetVectorDescription(second_result);
+  EXPECT_TRUE(MakePair("../../action.output", &action) == second_result[2]);
+}
+
 // Tests that actions can't have output substitutions.
 TEST_F(RuntimeDeps, WriteRuntimeDepsVariable) {
   TestWithScope setup;
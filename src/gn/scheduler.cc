@@ -84,7 +84,9 @@ void Scheduler::ScheduleWork(std::function<void()> work) {
 
 void Scheduler::AddGenDependency(const base::FilePath& file) {
   std::lock_guard<std::mutex> lock(lock_);
-  gen_dependencies_.push_back(file);
+  // The same files are often read by many build files.
+  if (gen_dependency_set_.insert(file.value()).second)
+    gen_dependencies_.push_back(file);
 }
 
 std::vector<base::FilePath> Scheduler::GetGenDependencies() const {
@@ -127,7 +129,7 @@ bool Scheduler::IsFileGeneratedByWriteRuntimeDeps(
 
 void Scheduler::AddGeneratedFile(const SourceFile& entry) {
   std::lock_guard<std::mutex> lock(lock_);
-  generated_files_.insert(std::make_pair(entry, true));
+  generated_files_.insert(entry);
 }
 
 bool Scheduler::IsFileGeneratedByTarget(const SourceFile& file) const {
@@ -9,6 +9,7 @@
 #include <functional>
 #include <map>
 #include <mutex>
+#include <unordered_set>
 
 #include "base/atomic_ref_count.h"
 #include "base/files/file_path.h"
@@ -145,10 +146,11 @@ class Scheduler {
 
   // Protected by the lock. See the corresponding Add/Get functions above.
   std::vector<base::FilePath> gen_dependencies_;
+  std::unordered_set<base::FilePath::StringType> gen_dependency_set_;
   std::vector<SourceFile> written_files_;
   std::vector<const Target*> write_runtime_deps_targets_;
   std::multimap<SourceFile, const Target*> unknown_generated_inputs_;
-  std::map<SourceFile, bool> generated_files_;
+  std::unordered_set<SourceFile> generated_files_;
 
   Scheduler(const Scheduler&) = delete;
   Scheduler& operator=(const Scheduler&) = delete;
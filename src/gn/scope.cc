@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "base/logging.h"
+#include "gn/lazy_import.h"
 #include "gn/parse_tree.h"
 #include "gn/source_file.h"
 #include "gn/template.h"
@@ -69,6 +70,18 @@ Scope::Scope(const Scope* parent)
 
 Scope::~Scope() = default;
 
+const Value& Scope::Record::get() const {
+  return lazy ? lazy->Get() : value;
+}
+
+Value* Scope::Record::get_mutable() {
+  if (lazy) {
+    value = lazy->Get();
+    lazy = nullptr;
+  }
+  return &value;
+}
+
 void Scope::DetachFromContaining() {
   const_containing_ = nullptr;
   mutable_containing_ = nullptr;
@@ -102,7 +115,7 @@ const Value* Scope::GetValueWithScope(std::string_view ident,
     if (counts_as_used)
       found->second.used = true;
     *found_in_scope = this;
-    return &found->second.value;
+    return &found->second.get();
   }
 
   // Search in the parent scope.
@@ -123,7 +136,7 @@ Value* Scope::GetMutableValue(std::string_view ident,
   if (found != values_.end()) {
     if (counts_as_used)
       found->second.used = true;
-    return &found->second.value;
+    return found->second.get_mutable();
   }
 
   // Search in the parent mutable scope if requested, but not const one.
@@ -155,7 +168,7 @@ const Value* Scope::GetValueWithScope(std::string_view ident,
   RecordMap::const_iterator found = values_.find(ident);
   if (found != values_.end()) {
     *found_in_scope = this;
-    return &found->second.value;
+    return &found->second.get();
   }
   if (containing())
     return containing()->GetValueWithScope(ident, found_in_scope);
@@ -168,9 +181,25 @@ Value* Scope::SetValue(std::string_view ident,
   Record& r = values_[ident];  // Clears any existing value.
   r.value = std::move(v);
   r.value.set_origin(set_node);
+  r.lazy = nullptr;
   return &r.value;
 }
 
+void Scope::SetLazyValue(std::string_view ident, const LazyValue* value) {
+  Record& r = values_[ident];  // Clears any existing value.
+  r.value = Value();
+  r.lazy = value;
+}
+
+const Scope::Record* Scope::GetRecord(std::string_view ident) const {
+  RecordMap::const_iterator found = values_.find(ident);
+  if (found != values_.end())
+    return &found->second;
+  if (containing())
+    return containing()->GetRecord(ident);
+  return nullptr;
+}
+
 void Scope::RemoveIdentifier(std::string_view ident) {
   RecordMap::iterator found = values_.find(ident);
   if (found != values_.end())
@@ -290,15 +319,15 @@ bool Scope::CheckForUnusedVars(Err* err) const {
         }
       }
 
-      const BinaryOpNode* binary = pair.second.value.origin()->AsBinaryOp();
+      const Value& value = pair.second.get();
+      const BinaryOpNode* binary = value.origin()->AsBinaryOp();
       if (binary && binary->op().type() == Token::EQUAL) {
         // Make a nicer error message for normal var sets.
         *err =
             Err(binary->left()->GetRange(), "Assignment had no effect.", help);
       } else {
         // This will happen for internally-generated variables.
-        *err =
-            Err(pair.second.value.origin(), "Assignment had no effect.", help);
+        *err = Err(value.origin(), "Assignment had no effect.", help);
       }
       return false;
     }
@@ -308,7 +337,7 @@ bool Scope::CheckForUnusedVars(Err* err) const {
 
 void Scope::GetCurrentScopeValues(KeyValueMap* output) const {
   for (const auto& pair : values_)
-    (*output)[pair.first] = pair.second.value;
+    (*output)[pair.first] = pair.second.get();
 }
 
 bool Scope::CheckCurrentScopeValuesEqual(const Scope* other) const {
@@ -321,7 +350,7 @@ bool Scope::CheckCurrentScopeValuesEqual(const Scope* other) const {
   }
   for (const auto& pair : values_) {
     const Value* v = other->GetValue(pair.first);
-    if (!v || *v != pair.second.value) {
+    if (!v || *v != pair.second.get()) {
       return false;
     }
   }
@@ -344,17 +373,21 @@ bool Scope::NonRecursiveMergeTo(Scope* dest,
       continue;  // Skip this excluded value.
     }
 
-    const Value& new_value = pair.second.value;
     if (!options.clobber_existing) {
-      const Value* existing_value = dest->GetValue(current_name);
-      if (existing_value && new_value != *existing_value) {
+      // Lazy values that come from the same definition are known to be
+      // equal, avoid evaluating them.
+      const Record* existing = dest->GetRecord(current_name);
+      const Value* existing_value = nullptr;
+      if (existing && (!pair.second.lazy || existing->lazy != pair.second.lazy))
+        existing_value = &existing->get();
+      if (existing_value && pair.second.get() != *existing_value) {
         // Value present in both the source and the dest.
         std::string desc_string(desc_for_err);
         *err = Err(node_for_err, "Value collision.",
                    "This " + desc_string + " contains \"" +
                        std::string(current_name) + "\"");
         err->AppendSubErr(
-            Err(pair.second.value, "defined here.",
+            Err(pair.second.get(), "defined here.",
                 "Which would clobber the one in your current scope"));
         err->AppendSubErr(
             Err(*existing_value, "defined here.",
@@ -638,7 +671,7 @@ bool Scope::RecordMapValuesEqual(const RecordMap& a, const RecordMap& b) {
     const auto& found_b = b.find(pair.first);
     if (found_b == b.end())
       return false;  // Item in 'a' but not 'b'.
-    if (pair.second.value != found_b->second.value)
+    if (pair.second.get() != found_b->second.get())
       return false;  // Values for variable in 'a' and 'b' are different.
   }
   return true;
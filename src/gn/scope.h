@@ -24,6 +24,7 @@
 #include "gn/value.h"
 
 class Item;
+class LazyValue;
 class ParseNode;
 class Settings;
 class Template;
@@ -199,6 +200,11 @@ class Scope {
   // is made for storage).
   Value* SetValue(std::string_view ident, Value v, const ParseNode* set_node);
 
+  // Sets the value of |ident| to the result of |value|, which is only
+  // evaluated when the value is first read. See LazyImport. |value| must
+  // outlive this scope.
+  void SetLazyValue(std::string_view ident, const LazyValue* value);
+
   // Removes the value with the given identifier if it exists on the current
   // scope. This does not search recursive scopes. Does nothing if not found.
   void RemoveIdentifier(std::string_view ident);
@@ -239,7 +245,7 @@ class Scope {
   // std::pair<std::string_view, const Value*>.
   auto GetCurrentScopeValues() const {
     return values_ | std::views::transform([](const auto& pair) {
-             return std::make_pair(pair.first, &pair.second.value);
+             return std::make_pair(pair.first, &pair.second.get());
            });
   }
 
@@ -361,12 +367,26 @@ class Scope {
     Record() : used(false) {}
     explicit Record(const Value& v) : used(false), value(v) {}
 
+    // Returns the value, evaluating |lazy| if needed.
+    const Value& get() const;
+
+    // Returns the value for modification. A lazy value is copied into
+    // |value| first.
+    Value* get_mutable();
+
     bool used;  // Set to true when the variable is used.
     Value value;
+
+    // When set, |value| is unused and the value is the result of |lazy|.
+    const LazyValue* lazy = nullptr;
   };
 
   using RecordMap = std::unordered_map<std::string_view, Record>;
 
+  // Returns the record for |ident| in this scope or the containing ones,
+  // without evaluating it.
+  const Record* GetRecord(std::string_view ident) const;
+
   void AddProvider(ProgrammaticProvider* p);
   void RemoveProvider(ProgrammaticProvider* p);
 
@@ -503,6 +503,10 @@ bool Setup::DoSetupWithErr(const std::string& build_dir,
                            const base::CommandLine& cmdline,
                            Err* err) {
   scheduler_.set_verbose_logging(cmdline.HasSwitch(switches::kVerbose));
+  scheduler_.input_file_manager()->set_compile_to_bytecode(
+      cmdline.HasSwitch(switches::kBytecode));
+  scheduler_.input_file_manager()->set_prepare_lazy_imports(
+      cmdline.HasSwitch(switches::kLazyImports));
   if (cmdline.HasSwitch(switches::kTime) ||
       cmdline.HasSwitch(switches::kTracelog))
     EnableTracing();
@@ -801,6 +805,35 @@ bool Setup::FillSourceDir(const base::CommandLine& cmdline, Err* err) {
   return true;
 }
 
+// static
+base::FilePath Setup::ResolveBuildDir(const std::string& build_dir,
+                                      const base::CommandLine& cmdline) {
+  base::FilePath root_path = cmdline.GetSwitchValuePath(switches::kRoot);
+  if (root_path.empty()) {
+    base::FilePath cur_dir;
+    base::GetCurrentDirectory(&cur_dir);
+    base::FilePath dotfile = FindDotFile(cur_dir);
+    if (dotfile.empty())
+      return base::FilePath();
+    root_path = dotfile.DirName();
+  }
+  root_path = base::MakeAbsoluteFilePath(root_path);
+  if (root_path.empty())
+    return base::FilePath();
+
+  BuildSettings build_settings;
+  build_settings.SetRootPath(root_path);
+  Err err;
+  SourceDir resolved =
+      SourceDirForCurrentDirectory(root_path).ResolveRelativeDir(
+          Value(nullptr, build_dir), &err, build_settings.root_path_utf8());
+  if (err.has_error())
+    return base::FilePath();
+  base::FilePath path = build_settings.GetFullPath(resolved);
+  base::FilePath realpath = base::MakeAbsoluteFilePath(path);
+  return realpath.empty() ? path : realpath;
+}
+
 bool Setup::FillBuildDir(const std::string& build_dir,
                          bool require_exists,
                          Err* err) {
@@ -134,6 +134,14 @@ class Setup {
   // arguments.
   static const char kBuildArgFileName[];
 
+  // Returns the full path of the build directory |build_dir| resolved like
+  // DoSetup() does with the --root of |cmdline|, without loading anything:
+  // a source-absolute "//out/foo" is relative to the source root, and other
+  // paths to the current directory. The path is made real if it exists.
+  // Returns an empty path if the source root can't be found.
+  static base::FilePath ResolveBuildDir(const std::string& build_dir,
+                                        const base::CommandLine& cmdline);
+
  private:
   // Performs the two sets of operations to run the generation before and after
   // the message loop is run.
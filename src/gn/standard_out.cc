@@ -272,6 +272,9 @@ class QuietModeBuffer {
 // Non-null while buffering standard output. Deliberately leaked on shutdown.
 QuietModeBuffer* quiet_mode_buffer = nullptr;
 
+// Non-null while capturing the output, see SetOutputCapture().
+std::string* output_capture = nullptr;
+
 }  // namespace
 
 bool IsColorEnabled() {
@@ -282,12 +285,20 @@ bool IsColorEnabled() {
 void OutputString(std::string_view output,
                   TextDecoration dec,
                   HtmlEscaping escaping) {
+  if (output_capture) {
+    output_capture->append(output);
+    return;
+  }
   WriteOutputString(output, dec, escaping);
 }
 
 void OutputLogString(std::string_view output,
                      TextDecoration dec,
                      HtmlEscaping escaping) {
+  if (output_capture) {
+    output_capture->append(output);
+    return;
+  }
   if (quiet_mode_buffer) {
     quiet_mode_buffer->Append(output, dec, escaping);
     return;
@@ -295,6 +306,10 @@ void OutputLogString(std::string_view output,
   WriteOutputString(output, dec, escaping);
 }
 
+void SetOutputCapture(std::string* capture) {
+  output_capture = capture;
+}
+
 void BufferLogOutput() {
   if (quiet_mode_buffer) {
     DCHECK(false);  // Expecting to only be called once.
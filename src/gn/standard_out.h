@@ -38,6 +38,11 @@ void OutputLogString(std::string_view output,
                      TextDecoration dec = DECORATION_NONE,
                      HtmlEscaping = DEFAULT_ESCAPING);
 
+// While |capture| is non-null, OutputString() and OutputLogString() append
+// their output to it without decorations instead of printing it. Not
+// threadsafe: only capture output produced by the calling thread.
+void SetOutputCapture(std::string* capture);
+
 // Enable or flush to stdout the for quiet mode from OutputLogString().
 // BufferLogOutput() is not threadsafe and is expected to be called from early
 // process init before we've created any worker thread.
@@ -5,9 +5,9 @@
 #include "gn/string_atom.h"
 
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
-#include <set>
 #include <string>
 #include <vector>
 
@@ -20,21 +20,26 @@ namespace {
 // StringAtomSet implements the global shared state, which is:
 //
 //    - a group of std::string instances with a persistent address, allocated
-//      through a fast slab allocator.
+//      through a fast slab allocator. Each thread allocates from its own
+//      slabs, so allocation never needs to be synchronized.
 //
 //    - a set of string pointers, corresponding to the known strings in the
-//      group.
+//      group. The set is split into kShardCount shards selected by the high
+//      bits of the string hash, each one protected by its own mutex. Threads
+//      that insert unrelated strings almost never contend on the same lock.
 //
-//    - a mutex to ensure correct thread-safety.
+//    - a find() method that takes an std::string_view argument and its hash,
+//      and uses them to find a matching entry in the right shard. If none is
+//      available, a new std::string is allocated from the calling thread's
+//      slab and its address inserted into the shard before being returned.
 //
-//    - a find() method that takes an std::string_view argument, and uses it
-//      to find a matching entry in the string tree. If none is available,
-//      a new std::string is allocated and its address inserted into the tree
-//      before being returned.
-//
-// Because the mutex is a large bottleneck, each thread implements
+// Because even an uncontended mutex is costly, each thread implements
 // its own local string pointer cache, and will only call StringAtomSet::find()
-// in case of a lookup miss. This is critical for good performance.
+// in case of a lookup miss. This is critical for good performance. The
+// cache computes the hash once and passes it down to the shared set.
+//
+// Each thread also keeps a few counters that are only written by their
+// owner and are read by StringAtom::GetStats().
 //
 
 static const std::string kEmptyString;
@@ -105,6 +110,63 @@ struct KeySet : public HashTableBase<KeyNode> {
   }
 };
 
+static constexpr unsigned int kStringsPerSlab = 128;
+
+// Each slab is allocated independently, has a fixed address and stores
+// kStringsPerSlab items of type StringStorage. The latter has the same
+// size and alignment as std::string, but doesn't need default-initialization.
+// This is used to slightly speed up Slab allocation and string
+// initialization. The drawback is that on process exit, allocated strings
+// are leaked (but GN already leaks several hundred MiBs of memory anyway).
+
+// A C++ union that can store an std::string but without default
+// initialization and destruction.
+union StringStorage {
+  StringStorage() {}
+  ~StringStorage() {}
+  char dummy;
+  std::string str;
+};
+
+// A fixed array of StringStorage items. Can be allocated cheaply.
+class Slab {
+ public:
+  bool full() const { return count_ == kStringsPerSlab; }
+
+  // Init the next string in the slab with |str|.
+  // Return its location as well.
+  std::string* add(std::string_view str) {
+    std::string* result = &items_[count_++].str;
+    new (result) std::string(str);
+    return result;
+  }
+
+  void destroy() {
+    for (size_t i = 0; i < count_; ++i) {
+      items_[i].str.~basic_string();
+    }
+  }
+
+ private:
+  StringStorage items_[kStringsPerSlab];
+  unsigned int count_ = 0;
+};
+
+// Counters owned by a single thread. Only the owner writes to them, so
+// they are updated with relaxed loads and stores instead of atomic
+// read-modify-write operations, which would be much slower.
+struct ThreadCounters {
+  std::atomic<uint64_t> lookups{0};
+  std::atomic<uint64_t> local_hits{0};
+  std::atomic<uint64_t> inserts{0};
+  std::atomic<uint64_t> bytes{0};
+
+  static void Add(std::atomic<uint64_t>* counter, uint64_t n) {
+    counter->store(counter->load(std::memory_order_relaxed) + n,
+                   std::memory_order_relaxed);
+  }
+};
+
 class StringAtomSet {
  public:
   StringAtomSet() {
@@ -114,85 +176,99 @@ class StringAtomSet {
     //
     // This allows the StringAtom() default initializer to use the same
     // address directly, avoiding a table lookup.
-    size_t hash = set_.Hash("");
-    auto* node = set_.Lookup(hash, "");
-    set_.Insert(node, hash, &kEmptyString);
+    size_t hash = KeySet::Hash("");
+    KeySet& set = shards_[ShardIndex(hash)].set;
+    auto* node = set.Lookup(hash, "");
+    set.Insert(node, hash, &kEmptyString);
   }
 
 #ifdef ASAN_ENABLED
   ~StringAtomSet() {
-    if (!slabs_.empty()) {
-      Slab* last_slab = slabs_.back();
-      for (Slab* slab : slabs_) {
-        slab->destroy(slab == last_slab ? slab_index_ : kStringsPerSlab);
-        delete slab;
-      }
+    for (Slab* slab : slabs_) {
+      slab->destroy();
+      delete slab;
     }
   }
 #endif
 
-  // Find the unique constant string pointer for |key|.
-  const std::string* find(std::string_view key) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    size_t hash = set_.Hash(key);
-    auto* node = set_.Lookup(hash, key);
-    if (node->key)
+  // Find the unique constant string pointer for |key|, whose hash is
+  // |hash|. In case of a miss, the new string is allocated from |*slab|,
+  // which belongs to the calling thread and is replaced when full.
+  // |*inserted| is set to true iff a new string was added.
+  const std::string* find(size_t hash,
+                          std::string_view key,
+                          Slab** slab,
+                          bool* inserted) {
+    Shard& shard = shards_[ShardIndex(hash)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto* node = shard.set.Lookup(hash, key);
+    if (node->key) {
+      *inserted = false;
       return node->key;
+    }
 
     // Allocate new string, insert its address in the set.
-    if (slab_index_ >= kStringsPerSlab) {
-      slabs_.push_back(new Slab());
-      slab_index_ = 0;
-    }
-    std::string* result = slabs_.back()->init(slab_index_++, key);
-    set_.Insert(node, hash, result);
+    if (!*slab || (*slab)->full())
+      *slab = NewSlab();
+    std::string* result = (*slab)->add(key);
+    shard.set.Insert(node, hash, result);
+    *inserted = true;
     return result;
   }
 
- private:
-  static constexpr unsigned int kStringsPerSlab = 128;
-
-  // Each slab is allocated independently, has a fixed address and stores
-  // kStringsPerSlab items of type StringStorage. The latter has the same
-  // size and alignment as std::string, but doesn't need default-initialization.
-  // This is used to slightly speed up Slab allocation and string
-  // initialization. The drawback is that on process exit, allocated strings
-  // are leaked (but GN already leaks several hundred MiBs of memory anyway).
-
-  // A C++ union that can store an std::string but without default
-  // initialization and destruction.
-  union StringStorage {
-    StringStorage() {}
-    ~StringStorage() {}
-    char dummy;
-    std::string str;
-  };
+  // Returns new counters for the calling thread. They are owned by this
+  // instance so they outlive the thread and can be reported at exit.
+  ThreadCounters* NewThreadCounters() {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    counters_.push_back(std::make_unique<ThreadCounters>());
+    return counters_.back().get();
+  }
 
-  // A fixed array of StringStorage items. Can be allocated cheaply.
-  class Slab {
-   public:
-    // Init the n-th string in the slab with |str|.
-    // Return its location as well.
-    std::string* init(size_t index, std::string_view str) {
-      std::string* result = &items_[index].str;
-      new (result) std::string(str);
-      return result;
+  StringAtom::Stats GetStats() {
+    StringAtom::Stats stats;
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    for (const auto& counters : counters_) {
+      StringAtom::ThreadStats thread;
+      thread.lookups = counters->lookups.load(std::memory_order_relaxed);
+      thread.local_hits = counters->local_hits.load(std::memory_order_relaxed);
+      thread.inserts = counters->inserts.load(std::memory_order_relaxed);
+      stats.count += thread.inserts;
+      stats.bytes += counters->bytes.load(std::memory_order_relaxed);
+      stats.threads.push_back(thread);
     }
+    return stats;
+  }
 
-    void destroy(size_t max_index) {
-      for (size_t i = 0; i < max_index; ++i) {
-        items_[i].str.~basic_string();
-      }
-    }
+ private:
+  static constexpr unsigned int kShardBits = 6;
+  static constexpr unsigned int kShardCount = 1u << kShardBits;
 
-   private:
-    StringStorage items_[kStringsPerSlab];
+  // The low bits of the hash are used by the KeySet to select a bucket, so
+  // use the high ones to select a shard.
+  static size_t ShardIndex(size_t hash) {
+    return hash >> (sizeof(size_t) * 8 - kShardBits);
+  }
+
+  // Aligned to avoid false sharing between the mutexes of adjacent shards.
+  struct alignas(64) Shard {
+    std::mutex mutex;
+    KeySet set;
   };
 
-  std::mutex mutex_;
-  KeySet set_;
+  Slab* NewSlab() {
+    Slab* slab = new Slab();
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    slabs_.push_back(slab);
+    return slab;
+  }
+
+  std::array<Shard, kShardCount> shards_;
+
+  // Protects |slabs_| and |counters_|, which are only modified when a
+  // thread allocates a new slab or interns its first string.
+  std::mutex registry_mutex_;
   std::vector<Slab*> slabs_;
-  unsigned int slab_index_ = kStringsPerSlab;
+  std::vector<std::unique_ptr<ThreadCounters>> counters_;
 };
 
 StringAtomSet& GetStringAtomSet() {
@@ -204,21 +280,37 @@ StringAtomSet& GetStringAtomSet() {
 // without taking any mutex in most cases.
 class ThreadLocalCache {
  public:
+  ThreadLocalCache() : counters_(GetStringAtomSet().NewThreadCounters()) {}
+
   // Find the unique constant string pointer for |key| in this cache,
   // and fallback to the global one in case of a miss.
   KeyType find(std::string_view key) {
+    ThreadCounters::Add(&counters_->lookups, 1);
     size_t hash = local_set_.Hash(key);
     auto* node = local_set_.Lookup(hash, key);
-    if (node->key)
+    if (node->key) {
+      ThreadCounters::Add(&counters_->local_hits, 1);
       return node->key;
+    }
 
-    KeyType result = GetStringAtomSet().find(key);
+    bool inserted;
+    KeyType result = GetStringAtomSet().find(hash, key, &slab_, &inserted);
+    if (inserted) {
+      ThreadCounters::Add(&counters_->inserts, 1);
+      ThreadCounters::Add(&counters_->bytes, key.size());
+    }
     local_set_.Insert(node, hash, result);
     return result;
   }
 
  private:
   KeySet local_set_;
+
+  // The slab new strings are allocated from. Its ownership is shared with
+  // the StringAtomSet, which keeps it alive after this thread exits.
+  Slab* slab_ = nullptr;
+
+  ThreadCounters* counters_;
 };
 
 #if !defined(OS_ZOS)
@@ -241,3 +333,8 @@ StringAtom::StringAtom(std::string_view str) noexcept
     : value_(*s_local_cache->find(str)) {
 }
 #endif
+
+// static
+StringAtom::Stats StringAtom::GetStats() {
+  return GetStringAtomSet().GetStats();
+}
@@ -5,9 +5,12 @@
 #ifndef TOOLS_GN_STRING_ATOM_H_
 #define TOOLS_GN_STRING_ATOM_H_
 
+#include <stdint.h>
+
 #include <functional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 // A StringAtom models a pointer to a globally unique constant string.
 //
@@ -150,6 +153,31 @@ class StringAtom {
     }
   };
 
+  // Counters for the threads that created StringAtom instances.
+  struct ThreadStats {
+    // Number of StringAtom(std::string_view) calls.
+    uint64_t lookups = 0;
+
+    // Number of lookups served by the thread's local cache, without
+    // touching the global table.
+    uint64_t local_hits = 0;
+
+    // Number of strings this thread added to the global table.
+    uint64_t inserts = 0;
+  };
+
+  struct Stats {
+    // Number and total size of the unique strings in the global table.
+    size_t count = 0;
+    size_t bytes = 0;
+
+    std::vector<ThreadStats> threads;
+  };
+
+  // Returns a snapshot of the global table statistics. Counters of threads
+  // that are still running may be slightly out of date.
+  static Stats GetStats();
+
  protected:
   const std::string& value_;
 };
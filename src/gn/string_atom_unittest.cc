@@ -10,6 +10,7 @@
 #include <array>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 TEST(StringAtomTest, EmptyString) {
@@ -146,3 +147,54 @@ TEST(StringAtom, AllocMoreThanASingleSlabOfKeys) {
     ASSERT_EQ(keys[nn].str(), string_for(nn));
   }
 }
+
+TEST(StringAtom, ConcurrentInterning) {
+  // Threads interning the same strings must all get the same pointers.
+  const size_t kThreadCount = 8;
+  const size_t kKeyCount = 4096;
+  std::vector<std::vector<const std::string*>> results(kThreadCount);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreadCount; ++t) {
+    threads.emplace_back([t, &results]() {
+      for (size_t nn = 0; nn < kKeyCount; ++nn) {
+        // Each thread walks the keys in a different order.
+        size_t index = (nn * 7 + t * 613) % kKeyCount;
+        results[t].push_back(
+            &StringAtom("concurrent_" + std::to_string(index)).str());
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  for (size_t t = 0; t < kThreadCount; ++t) {
+    for (size_t nn = 0; nn < kKeyCount; ++nn) {
+      size_t index = (nn * 7 + t * 613) % kKeyCount;
+      const std::string* expected =
+          &StringAtom("concurrent_" + std::to_string(index)).str();
+      ASSERT_EQ(expected, results[t][nn]);
+    }
+  }
+}
+
+TEST(StringAtom, Stats) {
+  StringAtom::Stats before = StringAtom::GetStats();
+
+  // A new thread gets its own counters.
+  std::thread thread([]() {
+    StringAtom("stats_test_new_string_1");
+    StringAtom("stats_test_new_string_22");
+    StringAtom("stats_test_new_string_1");
+  });
+  thread.join();
+
+  StringAtom::Stats after = StringAtom::GetStats();
+  EXPECT_EQ(before.count + 2, after.count);
+  EXPECT_EQ(before.bytes + 47, after.bytes);
+  ASSERT_EQ(before.threads.size() + 1, after.threads.size());
+
+  const StringAtom::ThreadStats& stats = after.threads.back();
+  EXPECT_EQ(3u, stats.lookups);
+  EXPECT_EQ(1u, stats.local_hits);
+  EXPECT_EQ(2u, stats.inserts);
+}
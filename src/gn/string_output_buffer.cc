@@ -9,9 +9,64 @@
 #include "gn/err.h"
 #include "gn/file_writer.h"
 #include "gn/filesystem_utils.h"
+#include "gn/output_hash_manifest.h"
 
+#include <atomic>
 #include <fstream>
 
+namespace {
+
+std::atomic<uint64_t> g_files_written;
+std::atomic<uint64_t> g_bytes_written;
+std::atomic<uint64_t> g_files_compared;
+std::atomic<uint64_t> g_bytes_compared;
+std::atomic<uint64_t> g_files_hashed;
+std::atomic<uint64_t> g_bytes_hashed;
+std::atomic<uint64_t> g_files_hash_matched;
+std::atomic<uint64_t> g_directories_made;
+
+// XXH64, see https://github.com/Cyan4973/xxHash.
+constexpr uint64_t kPrime1 = 11400714785074694791ull;
+constexpr uint64_t kPrime2 = 14029467366897019727ull;
+constexpr uint64_t kPrime3 = 1609587929392839161ull;
+constexpr uint64_t kPrime4 = 9650029242287828579ull;
+constexpr uint64_t kPrime5 = 2870177450012600261ull;
+
+// Index of the std::ios_base::pword() slot that points from the stream() of
+// a StringOutputBuffer to the instance.
+int GetStreamIndex() {
+  static const int index = std::ios_base::xalloc();
+  return index;
+}
+
+inline uint64_t RotateLeft(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t Read64(const char* data) {
+  uint64_t result;
+  memcpy(&result, data, sizeof(result));
+  return result;
+}
+
+inline uint32_t Read32(const char* data) {
+  uint32_t result;
+  memcpy(&result, data, sizeof(result));
+  return result;
+}
+
+inline uint64_t Round(uint64_t acc, uint64_t input) {
+  acc += input * kPrime2;
+  return RotateLeft(acc, 31) * kPrime1;
+}
+
+inline uint64_t MergeRound(uint64_t acc, uint64_t value) {
+  acc ^= Round(0, value);
+  return acc * kPrime1 + kPrime4;
+}
+
+}  // namespace
+
 std::string StringOutputBuffer::str() const {
   std::string result;
   size_t data_size = size();
@@ -23,17 +78,15 @@ std::string StringOutputBuffer::str() const {
   return result;
 }
 
-void StringOutputBuffer::Append(const char* str, size_t len) {
-  Append(std::string_view(str, len));
+void StringOutputBuffer::AddPage() {
+  pages_.push_back(std::make_unique<Page>());
+  pos_ = 0;
 }
 
-void StringOutputBuffer::Append(std::string_view str) {
+void StringOutputBuffer::AppendToNewPages(std::string_view str) {
   while (str.size() > 0) {
-    if (page_free_size() == 0) {
-      // Allocate a new page.
-      pages_.push_back(std::make_unique<Page>());
-      pos_ = 0;
-    }
+    if (page_free_size() == 0)
+      AddPage();
     size_t size = std::min(page_free_size(), str.size());
     memcpy(pages_.back()->data() + pos_, str.data(), size);
     pos_ += size;
@@ -41,14 +94,17 @@ void StringOutputBuffer::Append(std::string_view str) {
   }
 }
 
-void StringOutputBuffer::Append(char c) {
-  if (page_free_size() == 0) {
-    // Allocate a new page.
-    pages_.push_back(std::make_unique<Page>());
-    pos_ = 0;
+std::ostream& StringOutputBuffer::stream() {
+  if (!stream_) {
+    stream_ = std::make_unique<std::ostream>(this);
+    stream_->pword(GetStreamIndex()) = this;
   }
-  pages_.back()->data()[pos_] = c;
-  pos_ += 1;
+  return *stream_;
+}
+
+// static
+StringOutputBuffer* StringOutputBuffer::FromStream(std::ostream& out) {
+  return static_cast<StringOutputBuffer*>(out.pword(GetStreamIndex()));
 }
 
 bool StringOutputBuffer::ContentsEqual(const base::FilePath& file_path) const {
@@ -65,6 +121,7 @@ bool StringOutputBuffer::ContentsEqual(const base::FilePath& file_path) const {
   std::ifstream file(file_path.As8Bit().c_str(), std::ios::binary);
   if (!file.is_open())
     return false;
+  ++g_files_compared;
 
   size_t page_count = pages_.size();
   Page file_page;
@@ -74,6 +131,7 @@ bool StringOutputBuffer::ContentsEqual(const base::FilePath& file_path) const {
     if (!file.good())
       return false;
 
+    g_bytes_compared += wanted_size;
     if (memcmp(file_page.data(), pages_[nn]->data(), wanted_size) != 0)
       return false;
   }
@@ -83,15 +141,31 @@ bool StringOutputBuffer::ContentsEqual(const base::FilePath& file_path) const {
 // Write the contents of this instance to a file at |file_path|.
 bool StringOutputBuffer::WriteToFile(const base::FilePath& file_path,
                                      Err* err) const {
-  // Create the directory if necessary.
-  if (!base::CreateDirectory(file_path.DirName())) {
-    if (err) {
-      *err =
-          Err(Location(), "Unable to create directory.",
-              "I was using \"" + FilePathToUTF8(file_path.DirName()) + "\".");
-    }
-    return false;
+  return WriteToFileImpl(file_path, true, err);
+}
+
+bool StringOutputBuffer::WriteToFileIfChanged(const base::FilePath& file_path,
+                                              Err* err) const {
+  return WriteToFileIfChangedImpl(file_path, true, err);
+}
+
+// static
+bool StringOutputBuffer::MakeDirectory(const base::FilePath& dir, Err* err) {
+  ++g_directories_made;
+  if (base::CreateDirectory(dir))
+    return true;
+  if (err) {
+    *err = Err(Location(), "Unable to create directory.",
+               "I was using \"" + FilePathToUTF8(dir) + "\".");
   }
+  return false;
+}
+
+bool StringOutputBuffer::WriteToFileImpl(const base::FilePath& file_path,
+                                         bool create_directory,
+                                         Err* err) const {
+  if (create_directory && !MakeDirectory(file_path.DirName(), err))
+    return false;
 
   size_t data_size = size();
   size_t page_count = pages_.size();
@@ -108,6 +182,10 @@ bool StringOutputBuffer::WriteToFile(const base::FilePath& file_path,
   }
   if (!writer.Close())
     success = false;
+  if (success) {
+    ++g_files_written;
+    g_bytes_written += data_size;
+  }
 
   if (!success && err) {
     *err = Err(Location(), "Unable to write file.",
@@ -116,10 +194,122 @@ bool StringOutputBuffer::WriteToFile(const base::FilePath& file_path,
   return success;
 }
 
-bool StringOutputBuffer::WriteToFileIfChanged(const base::FilePath& file_path,
-                                              Err* err) const {
-  if (ContentsEqual(file_path))
+bool StringOutputBuffer::WriteToFileIfChangedImpl(
+    const base::FilePath& file_path,
+    bool create_directory,
+    Err* err) const {
+  if (WrittenFiles* written_files = WrittenFiles::active())
+    written_files->Add(file_path);
+
+  OutputHashManifest* manifest = OutputHashManifest::active();
+  if (!manifest) {
+    if (ContentsEqual(file_path))
+      return true;
+    return WriteToFileImpl(file_path, create_directory, err);
+  }
+
+  uint64_t hash = ContentHash();
+  ++g_files_hashed;
+  g_bytes_hashed += size();
+  if (manifest->IsUnchanged(file_path, hash, size())) {
+    ++g_files_hash_matched;
     return true;
+  }
+
+  // The manifest doesn't know the file or it was modified since, so compare
+  // with the file on disk as usual.
+  if (!ContentsEqual(file_path) &&
+      !WriteToFileImpl(file_path, create_directory, err))
+    return false;
+  manifest->Record(file_path, hash, size());
+  return true;
+}
+
+StringOutputBuffer::WrittenFiles* StringOutputBuffer::WrittenFiles::active_ =
+    nullptr;
+
+void StringOutputBuffer::WrittenFiles::Add(const base::FilePath& file_path) {
+  std::lock_guard<std::mutex> lock(lock_);
+  paths_.push_back(file_path);
+}
+
+std::vector<base::FilePath> StringOutputBuffer::WrittenFiles::TakePaths() {
+  std::lock_guard<std::mutex> lock(lock_);
+  return std::move(paths_);
+}
+
+uint64_t StringOutputBuffer::ContentHash() const {
+  constexpr size_t kStripeSize = 32;
+  static_assert(kPageSize % kStripeSize == 0,
+                "Only the last page may end with a partial stripe");
+
+  const uint64_t data_size = size();
+  uint64_t v1 = kPrime1 + kPrime2;
+  uint64_t v2 = kPrime2;
+  uint64_t v3 = 0;
+  uint64_t v4 = 0 - kPrime1;
+  const char* tail = nullptr;
+  size_t tail_size = 0;
+  for (size_t nn = 0; nn < pages_.size(); ++nn) {
+    const char* data = pages_[nn]->data();
+    size_t wanted_size = std::min(data_size - nn * kPageSize, kPageSize);
+    const char* end = data + wanted_size - wanted_size % kStripeSize;
+    for (; data < end; data += kStripeSize) {
+      v1 = Round(v1, Read64(data));
+      v2 = Round(v2, Read64(data + 8));
+      v3 = Round(v3, Read64(data + 16));
+      v4 = Round(v4, Read64(data + 24));
+    }
+    tail = data;
+    tail_size = wanted_size % kStripeSize;
+  }
+
+  uint64_t hash;
+  if (data_size >= kStripeSize) {
+    hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) +
+           RotateLeft(v4, 18);
+    hash = MergeRound(hash, v1);
+    hash = MergeRound(hash, v2);
+    hash = MergeRound(hash, v3);
+    hash = MergeRound(hash, v4);
+  } else {
+    hash = kPrime5;
+  }
+  hash += data_size;
+
+  for (; tail_size >= 8; tail += 8, tail_size -= 8) {
+    hash ^= Round(0, Read64(tail));
+    hash = RotateLeft(hash, 27) * kPrime1 + kPrime4;
+  }
+  if (tail_size >= 4) {
+    hash ^= static_cast<uint64_t>(Read32(tail)) * kPrime1;
+    hash = RotateLeft(hash, 23) * kPrime2 + kPrime3;
+    tail += 4;
+    tail_size -= 4;
+  }
+  for (; tail_size > 0; ++tail, --tail_size) {
+    hash ^= static_cast<unsigned char>(*tail) * kPrime5;
+    hash = RotateLeft(hash, 11) * kPrime1;
+  }
+
+  hash ^= hash >> 33;
+  hash *= kPrime2;
+  hash ^= hash >> 29;
+  hash *= kPrime3;
+  hash ^= hash >> 32;
+  return hash;
+}
 
-  return WriteToFile(file_path, err);
+// static
+StringOutputBuffer::IoStats StringOutputBuffer::GetIoStats() {
+  IoStats stats;
+  stats.files_written = g_files_written;
+  stats.bytes_written = g_bytes_written;
+  stats.files_compared = g_files_compared;
+  stats.bytes_compared = g_bytes_compared;
+  stats.files_hashed = g_files_hashed;
+  stats.bytes_hashed = g_bytes_hashed;
+  stats.files_hash_matched = g_files_hash_matched;
+  stats.directories_made = g_directories_made;
+  return stats;
 }
@@ -5,16 +5,20 @@
 #ifndef TOOLS_GN_STRING_OUTPUT_BUFFER_H_
 #define TOOLS_GN_STRING_OUTPUT_BUFFER_H_
 
+#include <stdint.h>
+
+#include <string.h>
+
 #include <array>
 #include <memory>
+#include <mutex>
+#include <ostream>
 #include <streambuf>
 #include <string>
 #include <string_view>
 #include <vector>
 
-namespace base {
-class FilePath;
-}  // namespace base
+#include "base/files/file_path.h"
 
 class Err;
 
@@ -35,6 +39,8 @@ class Err;
 //      std::ostream out(&storage);
 //      out << "Hello world!";
 //
+//      Writing through an OutputSink is faster, see output_sink.h.
+//
 //   4) Use ContentsEqual() to compare the instance's content with that of a
 //      given file.
 //
@@ -50,10 +56,24 @@ class StringOutputBuffer : public std::streambuf {
   // Return the number of characters stored in this instance.
   size_t size() const { return (pages_.size() - 1u) * kPageSize + pos_; }
 
-  // Append string to this instance.
-  void Append(const char* str, size_t len);
-  void Append(std::string_view str);
-  void Append(char c);
+  // Append string to this instance. These are inlined since the ninja
+  // writers call them for every token they write (see OutputSink).
+  void Append(const char* str, size_t len) {
+    Append(std::string_view(str, len));
+  }
+  void Append(std::string_view str) {
+    if (str.size() < page_free_size()) {
+      memcpy(pages_.back()->data() + pos_, str.data(), str.size());
+      pos_ += str.size();
+    } else {
+      AppendToNewPages(str);
+    }
+  }
+  void Append(char c) {
+    if (page_free_size() == 0)
+      AddPage();
+    pages_.back()->data()[pos_++] = c;
+  }
 
   StringOutputBuffer& operator<<(std::string_view str) {
     Append(str);
@@ -67,9 +87,52 @@ class StringOutputBuffer : public std::streambuf {
   bool WriteToFile(const base::FilePath& file_path, Err* err) const;
 
   // Write the contents of this instance to a file at |file_path| unless the
-  // file already exists and the contents are equal.
+  // file already exists and the contents are equal. If an OutputHashManifest
+  // is active, it's used to avoid reading the file back when possible.
   bool WriteToFileIfChanged(const base::FilePath& file_path, Err* err) const;
 
+  // Return a 64-bit hash of the content of this instance (XXH64), which is
+  // stable across runs.
+  uint64_t ContentHash() const;
+
+  // Collects the files given to WriteToFileIfChanged() while it's active,
+  // whether they were written or found unchanged. Thread-safe.
+  class WrittenFiles {
+   public:
+    void Add(const base::FilePath& file_path);
+    std::vector<base::FilePath> TakePaths();
+
+    // Must not be changed while files are being written.
+    static WrittenFiles* active() { return active_; }
+    static void set_active(WrittenFiles* files) { active_ = files; }
+
+   private:
+    std::mutex lock_;
+    std::vector<base::FilePath> paths_;
+
+    static WrittenFiles* active_;
+  };
+
+  // Counters of the file operations done by all instances, for --time.
+  struct IoStats {
+    uint64_t files_written = 0;
+    uint64_t bytes_written = 0;
+    uint64_t files_compared = 0;  // Read back by ContentsEqual().
+    uint64_t bytes_compared = 0;
+    uint64_t files_hashed = 0;  // Hashed to check the OutputHashManifest.
+    uint64_t bytes_hashed = 0;
+    uint64_t files_hash_matched = 0;  // Found unchanged by their hash.
+    uint64_t directories_made = 0;  // Created, or found to exist.
+  };
+  static IoStats GetIoStats();
+
+  // Return an std::ostream writing to this instance, created on first use.
+  // Mixing writes to it and to the instance keeps them in order.
+  std::ostream& stream();
+
+  // Return the instance whose stream() is |out|, or null if there is none.
+  static StringOutputBuffer* FromStream(std::ostream& out);
+
   static size_t GetPageSizeForTesting() { return kPageSize; }
 
  protected:
@@ -86,14 +149,36 @@ class StringOutputBuffer : public std::streambuf {
   }
 
  private:
+  friend class FileWriteBatch;
+
+  // Create |dir| and its parents if they don't exist.
+  static bool MakeDirectory(const base::FilePath& dir, Err* err);
+
+  // Implement WriteToFile() and WriteToFileIfChanged(). The directory of the
+  // file is only created if |create_directory| is true.
+  bool WriteToFileImpl(const base::FilePath& file_path,
+                       bool create_directory,
+                       Err* err) const;
+  bool WriteToFileIfChangedImpl(const base::FilePath& file_path,
+                                bool create_directory,
+                                Err* err) const;
+
   // Return the number of free bytes in the current page.
   size_t page_free_size() const { return kPageSize - pos_; }
 
+  // Allocate a new page and make it the current one.
+  void AddPage();
+
+  // Append |str|, which doesn't fit in the current page.
+  void AppendToNewPages(std::string_view str);
+
   static constexpr size_t kPageSize = 65536;
   using Page = std::array<char, kPageSize>;
 
   size_t pos_ = kPageSize;
   std::vector<std::unique_ptr<Page>> pages_;
+
+  std::unique_ptr<std::ostream> stream_;
 };
 
 #endif  // TOOLS_GN_STRING_OUTPUT_BUFFER_H_
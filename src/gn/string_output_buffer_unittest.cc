@@ -132,3 +132,21 @@ TEST(StringOutputBuffer, WriteToFile) {
   ASSERT_TRUE(base::GetFileInfo(file_path, &file_info));
   ASSERT_TRUE(buffer.ContentsEqual(file_path));
 }
+
+TEST(StringOutputBuffer, ContentHash) {
+  // Reference values of XXH64 with a seed of 0.
+  EXPECT_EQ(0xef46db3751d8e999ull, StringOutputBuffer().ContentHash());
+
+  StringOutputBuffer short_buffer;
+  short_buffer.Append("abc");
+  EXPECT_EQ(0x44bc2cf5ad770999ull, short_buffer.ContentHash());
+
+  // Spans several pages, the last one ending with a partial stripe.
+  StringOutputBuffer buffer;
+  buffer.Append(CreateTestString(100000));
+  EXPECT_EQ(0xda0045847132975full, buffer.ContentHash());
+
+  StringOutputBuffer other_buffer;
+  other_buffer.Append(CreateTestString(65536 + 45, 1));
+  EXPECT_EQ(0x740aaf44cbf3811aull, other_buffer.ContentHash());
+}
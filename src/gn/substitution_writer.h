@@ -5,10 +5,10 @@
 #ifndef TOOLS_GN_SUBSTITUTION_WRITER_H_
 #define TOOLS_GN_SUBSTITUTION_WRITER_H_
 
-#include <iosfwd>
 #include <string>
 #include <vector>
 
+#include "gn/output_sink.h"
 #include "gn/substitution_type.h"
 
 struct EscapeOptions;
@@ -58,11 +58,11 @@ class SubstitutionWriter {
     OUTPUT_RELATIVE,  // Dirs will be relative to a given directory.
   };
 
-  // Writes the pattern to the given stream with no special handling, and with
+  // Writes the pattern to the given sink with no special handling, and with
   // Ninja variables replacing the patterns.
   static void WriteWithNinjaVariables(const SubstitutionPattern& pattern,
                                       const EscapeOptions& escape_options,
-                                      std::ostream& out);
+                                      OutputSink out);
 
   // NOP substitutions ---------------------------------------------------------
 
@@ -157,7 +157,7 @@ class SubstitutionWriter {
       const SourceFile& source,
       const std::vector<const Substitution*>& types,
       const EscapeOptions& escape_options,
-      std::ostream& out);
+      OutputSink out);
 
   // Extracts the given type of substitution related to a source file from the
   // given source file. If output_style is OUTPUT_RELATIVE, relative_to
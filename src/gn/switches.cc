@@ -38,6 +38,25 @@ Examples
   gn desc out/Default --args="some_list=[1, false, \"foo\"]"
 )";
 
+const char kBytecode[] = "bytecode";
+const char kBytecode_HelpShort[] =
+    "--bytecode: Execute build files with the bytecode VM.";
+const char kBytecode_Help[] =
+    R"(--bytecode: Execute build files with the bytecode VM.
+
+  Normally GN executes build files by walking their parse trees. With this
+  flag, each file is compiled to a compact bytecode after it is parsed (with
+  literals folded and built-in functions resolved) and executed by a small
+  virtual machine instead.
+
+  Both engines produce identical results and errors. This flag is intended
+  for comparing their output and speed, typically together with --time.
+
+Examples
+
+  gn gen out/Default --bytecode --time
+)";
+
 #define COLOR_HELP_LONG                                                       \
   "--[no]color: Forces colored output on or off.\n"                           \
   "\n"                                                                        \
@@ -123,6 +142,28 @@ const char kFormatWidth_Help[] =
   command. This takes a strictly positive integer decimal value.
 )";
 
+const char kLazyImports[] = "lazy-imports";
+const char kLazyImports_HelpShort[] =
+    "--lazy-imports: Defer evaluating constants defined by imports.";
+const char kLazyImports_Help[] =
+    R"(--lazy-imports: Defer evaluating constants defined by imports.
+
+  Large .gni files often define many variables that are constant lists or
+  strings, of which a given build file only reads a few. With this flag,
+  top-level assignments of constants in imported files (literals without
+  string expansions, and lists of them) are only evaluated when the variable
+  is first read, and the result is shared by every file that imports it, in
+  every toolchain.
+
+  Other statements, such as template definitions, conditions and function
+  calls, are executed as usual. The results are identical with and without
+  this flag.
+
+Examples
+
+  gn gen out/Default --lazy-imports --time
+)";
+
 const char kMarkdown[] = "markdown";
 const char kMarkdown_HelpShort[] =
     "--markdown: Write help output in the Markdown format.";
@@ -369,12 +410,14 @@ const SwitchInfoMap& GetSwitches() {
   static SwitchInfoMap info_map;
   if (info_map.empty()) {
     INSERT_VARIABLE(Args)
+    INSERT_VARIABLE(Bytecode)
     INSERT_VARIABLE(Color)
     INSERT_VARIABLE(Dotfile)
     INSERT_VARIABLE(EnumerateFilesWithGit)
     INSERT_VARIABLE(ErrorLimit)
     INSERT_VARIABLE(FailOnUnusedArgs)
     INSERT_VARIABLE(FormatWidth)
+    INSERT_VARIABLE(LazyImports)
     INSERT_VARIABLE(Markdown)
     INSERT_VARIABLE(NinjaExecutable)
     INSERT_VARIABLE(NoColor)
@@ -30,6 +30,10 @@ extern const char kArgs[];
 extern const char kArgs_HelpShort[];
 extern const char kArgs_Help[];
 
+extern const char kBytecode[];
+extern const char kBytecode_HelpShort[];
+extern const char kBytecode_Help[];
+
 extern const char kColor[];
 extern const char kColor_HelpShort[];
 extern const char kColor_Help[];
@@ -54,6 +58,10 @@ extern const char kFormatWidth[];
 extern const char kFormatWidth_HelpShort[];
 extern const char kFormatWidth_Help[];
 
+extern const char kLazyImports[];
+extern const char kLazyImports_HelpShort[];
+extern const char kLazyImports_Help[];
+
 extern const char kMarkdown[];
 extern const char kMarkdown_HelpShort[];
 extern const char kMarkdown_Help[];
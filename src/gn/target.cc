@@ -16,6 +16,7 @@
 #include "gn/deps_iterator.h"
 #include "gn/filesystem_utils.h"
 #include "gn/functions.h"
+#include "gn/metadata_walk.h"
 #include "gn/rust_tool.h"
 #include "gn/scheduler.h"
 #include "gn/substitution_writer.h"
@@ -684,7 +685,7 @@ bool Target::ShouldGenerate() const {
     // By default, generate all targets that belong to the default toolchain.
     return settings()->is_default();
   }
-  return LabelPattern::VectorMatches(root_patterns, label());
+  return settings()->build_settings()->root_pattern_set().Matches(label());
 }
 
 DepsIteratorRange Target::GetDeps(DepsIterationType type) const {
@@ -1283,9 +1284,48 @@ bool Target::GetMetadata(const std::vector<std::string>& keys_to_extract,
                          bool deps_only,
                          std::vector<Value>* result,
                          TargetSet* targets_walked,
-                         Err* err) const {
+                         Err* err,
+                         MetadataStepCache* step_cache) const {
+  // The top-level target of a walk is specific to it, so its step is never
+  // cached.
+  MetadataWalkStep own_step;
+  const MetadataWalkStep* step = &own_step;
+  if (step_cache && !deps_only) {
+    step = &step_cache->GetStep(this);
+  } else {
+    GetMetadataStep(keys_to_extract, keys_to_walk, rebase_dir, deps_only,
+                    &own_step);
+  }
+
+  for (const Target* next : step->next) {
+    // If we haven't walked this dep yet, go down into it.
+    if (targets_walked->add(next)) {
+      if (!next->GetMetadata(keys_to_extract, keys_to_walk, rebase_dir, false,
+                             result, targets_walked, err, step_cache))
+        return false;
+    }
+  }
+  if (step->err.has_error()) {
+    *err = step->err;
+    return false;
+  }
+
+  if (step == &own_step) {
+    result->insert(result->end(),
+                   std::make_move_iterator(own_step.values.begin()),
+                   std::make_move_iterator(own_step.values.end()));
+  } else {
+    result->insert(result->end(), step->values.begin(), step->values.end());
+  }
+  return true;
+}
+
+void Target::GetMetadataStep(const std::vector<std::string>& keys_to_extract,
+                             const std::vector<std::string>& keys_to_walk,
+                             const SourceDir& rebase_dir,
+                             bool deps_only,
+                             MetadataWalkStep* step) const {
   std::vector<Value> next_walk_keys;
-  std::vector<Value> current_result;
   // If deps_only, this is the top-level target and thus we don't want to
   // collect its metadata, only that of its deps and data_deps.
   if (deps_only) {
@@ -1300,8 +1340,8 @@ bool Target::GetMetadata(const std::vector<std::string>& keys_to_extract,
     // See https://crbug.com/1273069.
     if (!metadata().WalkStep(settings()->build_settings(), keys_to_extract,
                              keys_to_walk, rebase_dir, &next_walk_keys,
-                             &current_result, err))
-      return false;
+                             &step->values, &step->err))
+      return;
   }
 
   // Gather walk keys and find the appropriate target. Targets identified in
@@ -1316,22 +1356,10 @@ bool Target::GetMetadata(const std::vector<std::string>& keys_to_extract,
     // from each explicitly listed dep prior to this, followed by all data in
     // walk order of the remaining deps.
     if (next.string_value().empty()) {
-      for (const auto& dep : all_deps) {
-        // If we haven't walked this dep yet, go down into it.
-        if (targets_walked->add(dep.ptr)) {
-          if (!dep.ptr->GetMetadata(keys_to_extract, keys_to_walk, rebase_dir,
-                                    false, result, targets_walked, err))
-            return false;
-        }
-      }
-      for (const auto& dep : validations_) {
-        // If we haven't walked this dep yet, go down into it.
-        if (targets_walked->add(dep.ptr)) {
-          if (!dep.ptr->GetMetadata(keys_to_extract, keys_to_walk, rebase_dir,
-                                    false, result, targets_walked, err))
-            return false;
-        }
-      }
+      for (const auto& dep : all_deps)
+        step->next.push_back(dep.ptr);
+      for (const auto& dep : validations_)
+        step->next.push_back(dep.ptr);
 
       // Any other walk keys are superfluous, as they can only be a subset of
       // all deps.
@@ -1342,10 +1370,11 @@ bool Target::GetMetadata(const std::vector<std::string>& keys_to_extract,
     // Canonicalize the label if possible.
     Label next_label = Label::Resolve(
         current_dir, settings()->build_settings()->root_path_utf8(),
-        settings()->toolchain_label(), next, err);
+        settings()->toolchain_label(), next, &step->err);
     if (next_label.is_null()) {
-      *err = Err(next.origin(), std::string("Failed to canonicalize ") +
-                                    next.string_value() + std::string("."));
+      step->err = Err(next.origin(), std::string("Failed to canonicalize ") +
+                                         next.string_value() +
+                                         std::string("."));
     }
     std::string canonicalize_next_label = next_label.GetUserVisibleName(true);
 
@@ -1353,12 +1382,7 @@ bool Target::GetMetadata(const std::vector<std::string>& keys_to_extract,
     for (const auto& dep : all_deps) {
       // Match against the label with the toolchain.
       if (dep.label.GetUserVisibleName(true) == canonicalize_next_label) {
-        // If we haven't walked this dep yet, go down into it.
-        if (targets_walked->add(dep.ptr)) {
-          if (!dep.ptr->GetMetadata(keys_to_extract, keys_to_walk, rebase_dir,
-                                    false, result, targets_walked, err))
-            return false;
-        }
+        step->next.push_back(dep.ptr);
         // We found it, so we can exit this search now.
         found_next = true;
         break;
@@ -1368,12 +1392,7 @@ bool Target::GetMetadata(const std::vector<std::string>& keys_to_extract,
       for (const auto& dep : validations_) {
         // Match against the label with the toolchain.
         if (dep.label.GetUserVisibleName(true) == canonicalize_next_label) {
-          // If we haven't walked this dep yet, go down into it.
-          if (targets_walked->add(dep.ptr)) {
-            if (!dep.ptr->GetMetadata(keys_to_extract, keys_to_walk, rebase_dir,
-                                      false, result, targets_walked, err))
-              return false;
-          }
+          step->next.push_back(dep.ptr);
           // We found it, so we can exit this search now.
           found_next = true;
           break;
@@ -1381,20 +1400,19 @@ bool Target::GetMetadata(const std::vector<std::string>& keys_to_extract,
       }
     }
     // If we didn't find the specified dep in the target, that's an error.
-    // Propagate it back to the user.
+    // Propagate it back to the user once the deps before it are walked.
     if (!found_next) {
-      *err = Err(next.origin(),
-                 std::string("I was expecting ") + canonicalize_next_label +
-                     std::string(" to be a dependency of ") +
-                     label().GetUserVisibleName(true) +
-                     ". Make sure it's included in the deps or data_deps, and "
-                     "that you've specified the appropriate toolchain.");
-      return false;
+      step->err = Err(next.origin(),
+                      std::string("I was expecting ") +
+                          canonicalize_next_label +
+                          std::string(" to be a dependency of ") +
+                          label().GetUserVisibleName(true) +
+                          ". Make sure it's included in the deps or "
+                          "data_deps, and that you've specified the "
+                          "appropriate toolchain.");
+      return;
     }
   }
-  result->insert(result->end(), std::make_move_iterator(current_result.begin()),
-                 std::make_move_iterator(current_result.end()));
-  return true;
 }
 
 void Target::set_module_type(ModuleType type) {
@@ -30,9 +30,11 @@
 #include "gn/unique_vector.h"
 
 class DepsIteratorRange;
+class MetadataStepCache;
 class Settings;
 class Target;
 class Toolchain;
+struct MetadataWalkStep;
 
 using TargetSet = PointerSet<const Target>;
 
@@ -206,13 +208,25 @@ class Target : public Item {
 
   // Get metadata from this target and its dependencies. This is intended to
   // be called after the target is resolved.
+  //
+  // The steps of the walk are taken from |step_cache| if not null, which
+  // must have been created for the same keys and rebase directory.
   bool GetMetadata(const std::vector<std::string>& keys_to_extract,
                    const std::vector<std::string>& keys_to_walk,
                    const SourceDir& rebase_dir,
                    bool deps_only,
                    std::vector<Value>* result,
                    TargetSet* targets_walked,
-                   Err* err) const;
+                   Err* err,
+                   MetadataStepCache* step_cache = nullptr) const;
+
+  // Computes the step of a metadata walk for this target alone: the values it
+  // contributes, and the deps to walk before them. See GetMetadata().
+  void GetMetadataStep(const std::vector<std::string>& keys_to_extract,
+                       const std::vector<std::string>& keys_to_walk,
+                       const SourceDir& rebase_dir,
+                       bool deps_only,
+                       MetadataWalkStep* step) const;
 
   // GeneratedFile-related methods.
   bool GenerateFile(Err* err) const;
@@ -0,0 +1,207 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/target_graph_index.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "gn/config.h"
+#include "gn/config_values_extractors.h"
+#include "gn/parallel_for.h"
+#include "gn/settings.h"
+#include "gn/source_file.h"
+#include "gn/target.h"
+
+using commands::HowTargetContainsFile;
+using commands::TargetContainingFile;
+
+namespace {
+
+// Below this, building a part of the index is not worth another thread.
+constexpr size_t kMinTargetsPerThread = 256;
+
+// The files of one target, with how it contains them.
+struct TargetFiles {
+  std::vector<std::pair<std::string, HowTargetContainsFile>> files;
+  std::vector<std::string> data_dirs;
+};
+
+// Lists the files of |target| in the order commands::TargetContainsFile()
+// checks them, so the first entry for a file is the way it is reported.
+void CollectTargetFiles(const Target* target, TargetFiles* result) {
+  for (const auto& file : target->sources())
+    result->files.emplace_back(file.value(), HowTargetContainsFile::kSources);
+  for (const auto& file : target->public_headers())
+    result->files.emplace_back(file.value(), HowTargetContainsFile::kPublic);
+  for (ConfigValuesIterator iter(target); !iter.done(); iter.Next()) {
+    for (const auto& file : iter.cur().inputs())
+      result->files.emplace_back(file.value(), HowTargetContainsFile::kInputs);
+  }
+  for (const auto& file : target->data()) {
+    if (!file.empty() && file.back() == '/')
+      result->data_dirs.push_back(file);
+    else
+      result->files.emplace_back(file, HowTargetContainsFile::kData);
+  }
+
+  const std::string& script = target->action_values().script().value();
+  if (!script.empty())
+    result->files.emplace_back(script, HowTargetContainsFile::kScript);
+
+  std::vector<SourceFile> output_sources;
+  target->action_values().GetOutputsAsSourceFiles(target, &output_sources);
+  for (const auto& file : output_sources)
+    result->files.emplace_back(file.value(), HowTargetContainsFile::kOutput);
+  for (const auto& output : target->computed_outputs()) {
+    result->files.emplace_back(
+        output.AsSourceFile(target->settings()->build_settings()).value(),
+        HowTargetContainsFile::kOutput);
+  }
+}
+
+}  // namespace
+
+TargetGraphIndex::TargetGraphIndex(std::vector<const Target*> targets)
+    : targets_(std::move(targets)) {
+  target_indices_.reserve(targets_.size());
+  for (size_t i = 0; i < targets_.size(); i++)
+    target_indices_.emplace(targets_[i], i);
+}
+
+TargetGraphIndex::~TargetGraphIndex() = default;
+
+const std::vector<TargetGraphIndex::Ref>& TargetGraphIndex::GetRefs(
+    const Target* target) const {
+  static const std::vector<Ref> kNoRefs;
+  std::call_once(refs_once_, [this]() { BuildRefs(); });
+  auto found = target_indices_.find(target);
+  if (found == target_indices_.end())
+    return kNoRefs;
+  return refs_[found->second];
+}
+
+const std::vector<const Target*>& TargetGraphIndex::GetConfigRefs(
+    const Config* config) const {
+  static const std::vector<const Target*> kNoRefs;
+  std::call_once(config_refs_once_, [this]() { BuildConfigRefs(); });
+  auto found = config_refs_.find(config);
+  if (found == config_refs_.end())
+    return kNoRefs;
+  return found->second;
+}
+
+void TargetGraphIndex::GetTargetsContainingFile(
+    const SourceFile& file,
+    std::vector<TargetContainingFile>* matches) const {
+  std::call_once(files_once_, [this]() { BuildFiles(); });
+
+  std::vector<FileMatch> found;
+  const std::string& value = file.value();
+  auto found_file = files_.find(value);
+  if (found_file != files_.end())
+    found = found_file->second;
+
+  // Data directories contain everything below them.
+  for (size_t slash = value.find('/'); slash != std::string::npos;
+       slash = value.find('/', slash + 1)) {
+    auto found_dir = data_dirs_.find(value.substr(0, slash + 1));
+    if (found_dir == data_dirs_.end())
+      continue;
+    for (size_t index : found_dir->second)
+      found.emplace_back(index, HowTargetContainsFile::kData);
+  }
+
+  // A target can contain the file in several ways. The enum is in the order
+  // they are checked in, so the first way is the smallest.
+  std::sort(found.begin(), found.end());
+  for (size_t i = 0; i < found.size(); i++) {
+    if (i == 0 || found[i].first != found[i - 1].first)
+      matches->emplace_back(targets_[found[i].first], found[i].second);
+  }
+}
+
+// static
+const TargetGraphIndex& TargetGraphIndex::GetShared(
+    const std::vector<const Target*>& targets) {
+  static std::mutex lock;
+  static const TargetGraphIndex* shared = nullptr;
+
+  std::lock_guard<std::mutex> guard(lock);
+  if (!shared || shared->targets() != targets) {
+    // Any previous index is leaked since it may still be in use.
+    shared = new TargetGraphIndex(targets);
+  }
+  return *shared;
+}
+
+void TargetGraphIndex::BuildRefs() const {
+  // The deps of each target are collected in parallel, then added to the refs
+  // of each dep in the order of the targets.
+  std::vector<std::vector<std::pair<size_t, DepKind>>> deps(targets_.size());
+  ParallelFor(targets_.size(), kMinTargetsPerThread,
+              [this, &deps](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                  const Target* target = targets_[i];
+                  auto add = [this, &deps, i](const LabelTargetVector& list,
+                                              DepKind kind) {
+                    for (const auto& pair : list) {
+                      auto found = target_indices_.find(pair.ptr);
+                      if (found != target_indices_.end())
+                        deps[i].emplace_back(found->second, kind);
+                    }
+                  };
+                  add(target->public_deps(), DepKind::kPublic);
+                  add(target->private_deps(), DepKind::kPrivate);
+                  add(target->data_deps(), DepKind::kData);
+                  add(target->validations(), DepKind::kValidation);
+                }
+              });
+
+  refs_.resize(targets_.size());
+  for (size_t i = 0; i < targets_.size(); i++) {
+    for (const auto& [dep, kind] : deps[i])
+      refs_[dep].push_back(Ref{targets_[i], kind});
+  }
+}
+
+void TargetGraphIndex::BuildConfigRefs() const {
+  // Both lists are usually short, so they are scanned serially: the lookups
+  // in the map dominate anyway.
+  for (const Target* target : targets_) {
+    for (const auto& pair : target->configs()) {
+      std::vector<const Target*>& refs = config_refs_[pair.ptr];
+      if (refs.empty() || refs.back() != target)
+        refs.push_back(target);
+    }
+    for (const auto& pair : target->public_configs()) {
+      std::vector<const Target*>& refs = config_refs_[pair.ptr];
+      if (refs.empty() || refs.back() != target)
+        refs.push_back(target);
+    }
+  }
+}
+
+void TargetGraphIndex::BuildFiles() const {
+  std::vector<TargetFiles> target_files(targets_.size());
+  ParallelFor(targets_.size(), kMinTargetsPerThread,
+              [this, &target_files](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                  CollectTargetFiles(targets_[i], &target_files[i]);
+              });
+
+  for (size_t i = 0; i < targets_.size(); i++) {
+    for (auto& [file, how] : target_files[i].files) {
+      std::vector<FileMatch>& matches = files_[file];
+      // Only the first way a target contains a file is kept.
+      if (matches.empty() || matches.back().first != i)
+        matches.emplace_back(i, how);
+    }
+    for (std::string& dir : target_files[i].data_dirs) {
+      std::vector<size_t>& matches = data_dirs_[dir];
+      if (matches.empty() || matches.back() != i)
+        matches.push_back(i);
+    }
+  }
+}
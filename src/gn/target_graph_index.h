@@ -0,0 +1,92 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TOOLS_GN_TARGET_GRAPH_INDEX_H_
+#define TOOLS_GN_TARGET_GRAPH_INDEX_H_
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gn/commands.h"
+
+class Config;
+class SourceFile;
+class Target;
+
+// Reverse lookups over the resolved targets of a build, for the commands that
+// query the graph ("gn refs", "gn path", "gn outputs"). Each part of the
+// index is built the first time it is needed, in parallel over the targets,
+// and then shared by all the queries on the same targets.
+//
+// The results are listed in the order of the targets given to the index, so
+// they don't depend on how the index was built. Thread-safe.
+class TargetGraphIndex {
+ public:
+  // How a target references another one.
+  enum class DepKind {
+    kPublic,
+    kPrivate,
+    kData,
+    kValidation,
+  };
+
+  struct Ref {
+    const Target* target;
+    DepKind kind;
+  };
+
+  explicit TargetGraphIndex(std::vector<const Target*> targets);
+  ~TargetGraphIndex();
+
+  const std::vector<const Target*>& targets() const { return targets_; }
+
+  // Returns the targets that depend on |target|, once for each of their deps
+  // on it, in the order of their public deps, private deps, data deps and
+  // validations.
+  const std::vector<Ref>& GetRefs(const Target* target) const;
+
+  // Returns the targets listing |config| in their configs or public configs.
+  const std::vector<const Target*>& GetConfigRefs(const Config* config) const;
+
+  // Appends the targets that contain |file|, with the first way they do as
+  // documented for commands::GetTargetsContainingFile().
+  void GetTargetsContainingFile(
+      const SourceFile& file,
+      std::vector<commands::TargetContainingFile>* matches) const;
+
+  // Returns an index of |targets|, reusing the last one returned if it was
+  // for the same targets. The index lives until the process exits.
+  static const TargetGraphIndex& GetShared(
+      const std::vector<const Target*>& targets);
+
+ private:
+  using FileMatch = std::pair<size_t, commands::HowTargetContainsFile>;
+
+  void BuildRefs() const;
+  void BuildConfigRefs() const;
+  void BuildFiles() const;
+
+  const std::vector<const Target*> targets_;
+  std::unordered_map<const Target*, size_t> target_indices_;
+
+  mutable std::once_flag refs_once_;
+  mutable std::vector<std::vector<Ref>> refs_;
+
+  mutable std::once_flag config_refs_once_;
+  mutable std::unordered_map<const Config*, std::vector<const Target*>>
+      config_refs_;
+
+  // The files of each target by value, and the directories listed in their
+  // data (ending with a slash), which contain all the files below them.
+  mutable std::once_flag files_once_;
+  mutable std::unordered_map<std::string, std::vector<FileMatch>> files_;
+  mutable std::unordered_map<std::string, std::vector<size_t>> data_dirs_;
+
+  TargetGraphIndex(const TargetGraphIndex&) = delete;
+  TargetGraphIndex& operator=(const TargetGraphIndex&) = delete;
+};
+
+#endif  // TOOLS_GN_TARGET_GRAPH_INDEX_H_
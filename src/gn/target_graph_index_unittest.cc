@@ -0,0 +1,95 @@
+// Copyright 2026 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gn/target_graph_index.h"
+
+#include "gn/config.h"
+#include "gn/source_file.h"
+#include "gn/target.h"
+#include "gn/test_with_scope.h"
+#include "util/test/test.h"
+
+using commands::HowTargetContainsFile;
+using commands::TargetContainingFile;
+
+TEST(TargetGraphIndex, Refs) {
+  TestWithScope setup;
+
+  TestTarget a(setup, "//foo:a", Target::EXECUTABLE);
+  TestTarget b(setup, "//foo:b", Target::STATIC_LIBRARY);
+  TestTarget c(setup, "//foo:c", Target::SOURCE_SET);
+  a.public_deps().push_back(LabelTargetPair(&c));
+  a.validations().push_back(LabelTargetPair(&c));
+  b.data_deps().push_back(LabelTargetPair(&c));
+  b.private_deps().push_back(LabelTargetPair(&a));
+
+  Config config(setup.settings(), Label(SourceDir("//foo/"), "config"));
+  a.configs().push_back(LabelConfigPair(&config));
+  c.public_configs().push_back(LabelConfigPair(&config));
+  c.configs().push_back(LabelConfigPair(&config));
+
+  TargetGraphIndex index({&a, &b, &c});
+
+  const std::vector<TargetGraphIndex::Ref>& c_refs = index.GetRefs(&c);
+  ASSERT_EQ(3u, c_refs.size());
+  EXPECT_EQ(&a, c_refs[0].target);
+  EXPECT_EQ(TargetGraphIndex::DepKind::kPublic, c_refs[0].kind);
+  EXPECT_EQ(&a, c_refs[1].target);
+  EXPECT_EQ(TargetGraphIndex::DepKind::kValidation, c_refs[1].kind);
+  EXPECT_EQ(&b, c_refs[2].target);
+  EXPECT_EQ(TargetGraphIndex::DepKind::kData, c_refs[2].kind);
+
+  ASSERT_EQ(1u, index.GetRefs(&a).size());
+  EXPECT_EQ(&b, index.GetRefs(&a)[0].target);
+  EXPECT_EQ(TargetGraphIndex::DepKind::kPrivate, index.GetRefs(&a)[0].kind);
+  EXPECT_TRUE(index.GetRefs(&b).empty());
+
+  // Each target is listed once per config.
+  const std::vector<const Target*>& config_refs = index.GetConfigRefs(&config);
+  ASSERT_EQ(2u, config_refs.size());
+  EXPECT_EQ(&a, config_refs[0]);
+  EXPECT_EQ(&c, config_refs[1]);
+
+  // The index is shared for the same targets.
+  const TargetGraphIndex& shared = TargetGraphIndex::GetShared({&a, &b, &c});
+  EXPECT_EQ(&shared, &TargetGraphIndex::GetShared({&a, &b, &c}));
+  EXPECT_NE(&shared, &TargetGraphIndex::GetShared({&a, &b}));
+}
+
+TEST(TargetGraphIndex, TargetsContainingFile) {
+  TestWithScope setup;
+
+  TestTarget a(setup, "//foo:a", Target::SOURCE_SET);
+  a.sources().push_back(SourceFile("//foo/a.cc"));
+  a.public_headers().push_back(SourceFile("//foo/a.cc"));
+  a.data().push_back("//foo/data/");
+
+  TestTarget b(setup, "//foo:b", Target::SOURCE_SET);
+  b.public_headers().push_back(SourceFile("//foo/b.h"));
+  b.data().push_back("//foo/a.cc");
+  b.data().push_back("//foo/data/file.txt");
+
+  TargetGraphIndex index({&a, &b});
+
+  // The first way a target contains a file is reported, in target order.
+  std::vector<TargetContainingFile> matches;
+  index.GetTargetsContainingFile(SourceFile("//foo/a.cc"), &matches);
+  ASSERT_EQ(2u, matches.size());
+  EXPECT_EQ(&a, matches[0].first);
+  EXPECT_EQ(HowTargetContainsFile::kSources, matches[0].second);
+  EXPECT_EQ(&b, matches[1].first);
+  EXPECT_EQ(HowTargetContainsFile::kData, matches[1].second);
+
+  // Data directories contain the files below them.
+  matches.clear();
+  index.GetTargetsContainingFile(SourceFile("//foo/data/file.txt"), &matches);
+  ASSERT_EQ(2u, matches.size());
+  EXPECT_EQ(&a, matches[0].first);
+  EXPECT_EQ(HowTargetContainsFile::kData, matches[0].second);
+  EXPECT_EQ(&b, matches[1].first);
+
+  matches.clear();
+  index.GetTargetsContainingFile(SourceFile("//foo/other.cc"), &matches);
+  EXPECT_TRUE(matches.empty());
+}
@@ -4,9 +4,12 @@
 
 #include "gn/tokenizer.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "base/strings/string_util.h"
 #include "gn/input_file.h"
+#include "gn/parallel_for.h"
 
 namespace {
 
@@ -74,24 +77,108 @@ Tokenizer::Tokenizer(const InputFile* input_file,
     : input_file_(input_file),
       input_(input_file->contents()),
       err_(err),
-      whitespace_transform_(whitespace_transform) {}
+      whitespace_transform_(whitespace_transform),
+      end_(input_.size()) {}
 
 Tokenizer::~Tokenizer() = default;
 
+void Tokenizer::SetRange(size_t begin, size_t end, int line_number) {
+  DCHECK(begin == 0 || input_[begin - 1] == '\n');
+  cur_ = begin;
+  end_ = end;
+  line_number_ = line_number;
+  column_number_ = 1;
+}
+
 // static
 std::vector<Token> Tokenizer::Tokenize(
     const InputFile* input_file,
     Err* err,
     WhitespaceTransform whitespace_transform) {
+  if (input_file->contents().size() >= kParallelThreshold) {
+    return TokenizeInParallel(input_file, err, whitespace_transform,
+                              kParallelThreshold / 4);
+  }
   Tokenizer t(input_file, err, whitespace_transform);
   return t.Run();
 }
 
+// static
+std::vector<Token> Tokenizer::TokenizeInParallel(
+    const InputFile* input_file,
+    Err* err,
+    WhitespaceTransform whitespace_transform,
+    size_t chunk_size) {
+  std::string_view input = input_file->contents();
+  DCHECK_GT(chunk_size, 0u);
+
+  // Find the chunk boundaries, and the line number each chunk starts at.
+  struct Chunk {
+    size_t begin;
+    size_t end;
+    int line_number;
+    std::vector<Token> tokens;
+    Err err;
+  };
+  std::vector<Chunk> chunks;
+  size_t begin = 0;
+  int line_number = 1;
+  while (begin < input.size()) {
+    size_t end = begin + chunk_size;
+    for (; end < input.size(); ++end) {
+      if (input[end - 1] != '\n')
+        continue;
+      // Only split before a line whose first token isn't a comment.
+      size_t first = end;
+      while (first < input.size() && input[first] == ' ')
+        ++first;
+      if (first < input.size() && input[first] != '#' &&
+          !base::IsAsciiWhitespace(input[first]))
+        break;
+    }
+    end = std::min(end, input.size());
+    chunks.push_back({begin, end, line_number, {}, Err()});
+    line_number += static_cast<int>(
+        std::count(input.begin() + begin, input.begin() + end, '\n'));
+    begin = end;
+  }
+
+  if (chunks.size() <= 1) {
+    Tokenizer t(input_file, err, whitespace_transform);
+    return t.Run();
+  }
+
+  ParallelFor(chunks.size(), 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      Chunk& chunk = chunks[i];
+      Tokenizer t(input_file, &chunk.err, whitespace_transform);
+      t.SetRange(chunk.begin, chunk.end, chunk.line_number);
+      chunk.tokens = t.Run();
+    }
+  });
+
+  size_t token_count = 0;
+  for (const Chunk& chunk : chunks) {
+    if (chunk.err.has_error()) {
+      // Errors are rare, report exactly the one a sequential run would.
+      Tokenizer t(input_file, err, whitespace_transform);
+      return t.Run();
+    }
+    token_count += chunk.tokens.size();
+  }
+
+  std::vector<Token> tokens;
+  tokens.reserve(token_count);
+  for (const Chunk& chunk : chunks)
+    tokens.insert(tokens.end(), chunk.tokens.begin(), chunk.tokens.end());
+  return tokens;
+}
+
 std::vector<Token> Tokenizer::Run() {
   DCHECK(tokens_.empty());
   while (!done()) {
     AdvanceToNextToken();
-    if (done())
+    if (done() || cur_ >= end_)
       break;
     Location location = GetCurrentLocation();
 
@@ -26,12 +26,28 @@ enum class WhitespaceTransform {
 
 class Tokenizer {
  public:
+  // Inputs at least this large are tokenized with TokenizeInParallel().
+  static constexpr size_t kParallelThreshold = 2 * 1024 * 1024;
+
   static std::vector<Token> Tokenize(
       const InputFile* input_file,
       Err* err,
       WhitespaceTransform whitespace_transform =
           WhitespaceTransform::kMaintainOriginalInput);
 
+  // Splits the input into chunks of about |chunk_size| bytes and tokenizes
+  // them on several threads. The result is identical to a sequential
+  // tokenization, including errors.
+  //
+  // Tokens never span a newline, so chunks are split at the beginning of
+  // lines. To keep the classification of comments (which depends on the
+  // previous token) identical, a chunk never starts with a comment.
+  static std::vector<Token> TokenizeInParallel(
+      const InputFile* input_file,
+      Err* err,
+      WhitespaceTransform whitespace_transform,
+      size_t chunk_size);
+
   // Counts lines in the given buffer (the first line is "1") and returns
   // the byte offset of the beginning of that line, or (size_t)-1 if there
   // aren't that many lines in the file. Note that this will return the byte
@@ -58,6 +74,10 @@ class Tokenizer {
             WhitespaceTransform whitespace_transform);
   ~Tokenizer();
 
+  // Limits the tokenizer to the tokens that begin in [begin, end). |begin|
+  // must be the beginning of line |line_number|.
+  void SetRange(size_t begin, size_t end, int line_number);
+
   std::vector<Token> Run();
 
   void AdvanceToNextToken();
@@ -97,6 +117,7 @@ class Tokenizer {
   Err* err_;
   WhitespaceTransform whitespace_transform_;
   size_t cur_ = 0;  // Byte offset into input buffer.
+  size_t end_;      // No token begins at or after this offset.
 
   int line_number_ = 1;
   int column_number_ = 1;
@@ -35,6 +35,43 @@ bool CheckTokenizer(const char* input, const TokenExpectation (&expect)[len]) {
   return true;
 }
 
+// Checks that tokenizing |input| in tiny chunks gives the same tokens, or
+// the same error, as a sequential tokenization.
+void CheckParallelTokenizer(const char* input) {
+  InputFile input_file(SourceFile("/test"));
+  input_file.SetContents(input);
+
+  Err err;
+  std::vector<Token> expected = Tokenizer::Tokenize(&input_file, &err);
+  for (size_t chunk_size : {1, 2, 7, 16}) {
+    Err parallel_err;
+    std::vector<Token> results = Tokenizer::TokenizeInParallel(
+        &input_file, &parallel_err, WhitespaceTransform::kMaintainOriginalInput,
+        chunk_size);
+    ASSERT_EQ(err.has_error(), parallel_err.has_error()) << input;
+    if (err.has_error()) {
+      EXPECT_EQ(err.message(), parallel_err.message()) << input;
+      EXPECT_EQ(err.location().line_number(),
+                parallel_err.location().line_number())
+          << input;
+      EXPECT_EQ(err.location().column_number(),
+                parallel_err.location().column_number())
+          << input;
+    }
+    ASSERT_EQ(expected.size(), results.size()) << input;
+    for (size_t i = 0; i < expected.size(); i++) {
+      EXPECT_EQ(expected[i].type(), results[i].type()) << input;
+      EXPECT_EQ(expected[i].value(), results[i].value()) << input;
+      EXPECT_EQ(expected[i].location().line_number(),
+                results[i].location().line_number())
+          << input;
+      EXPECT_EQ(expected[i].location().column_number(),
+                results[i].location().column_number())
+          << input;
+    }
+  }
+}
+
 }  // namespace
 
 TEST(Tokenizer, Empty) {
@@ -246,3 +283,28 @@ TEST(Tokenizer, WhitespaceTransformToSpace) {
   EXPECT_EQ(results[3].type(), Token::LEFT_BRACE);
   EXPECT_EQ(results[3].value(), "{");
 }
+
+TEST(Tokenizer, Parallel) {
+  CheckParallelTokenizer("");
+  CheckParallelTokenizer("\n\n  \n");
+  CheckParallelTokenizer(
+      "# Copyright\n"
+      "\n"
+      "sources = [\n"
+      "  \"a.cc\",  # Suffix.\n"
+      "           # Continued suffix.\n"
+      "\n"
+      "  # Line comment.\n"
+      "  \"b.cc\",\n"
+      "  # Block comment.\n"
+      "\n"
+      "  \"c \\\"quoted\\\".cc\",\n"
+      "]\n"
+      "if (a >= -1 && b) {\n"
+      "  foo(bar)\n"
+      "}\n");
+
+  // Errors are reported at the same location.
+  CheckParallelTokenizer("a = [\n  \"b\",\n  \"c\n  \"d\",\n]\n");
+  CheckParallelTokenizer("a = 1\nb = 2\nc = 3;\nd = 4\n");
+}
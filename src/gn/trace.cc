@@ -18,8 +18,11 @@
 #include "base/json/string_escape.h"
 #include "base/logging.h"
 #include "base/strings/stringprintf.h"
+#include "gn/config_flags_cache.h"
 #include "gn/filesystem_utils.h"
 #include "gn/label.h"
+#include "gn/string_atom.h"
+#include "gn/string_output_buffer.h"
 
 namespace {
 
@@ -118,6 +121,60 @@ void SummarizeScriptExecs(std::vector<const TraceItem*>& execs,
   SummarizeCoalesced(execs, out);
 }
 
+void SummarizeStringAtoms(std::ostream& out) {
+  StringAtom::Stats stats = StringAtom::GetStats();
+  out << "String atoms: (count, total size in KiB)\n";
+  out << base::StringPrintf(" %8zu  %.1f\n", stats.count,
+                            stats.bytes / 1024.0);
+
+  out << "String atom lookups per thread: "
+         "(lookups, local cache hit rate, inserts)\n";
+  for (const auto& thread : stats.threads) {
+    if (!thread.lookups)
+      continue;
+    out << base::StringPrintf(
+        " %10llu  %5.1f%%  %llu\n",
+        static_cast<unsigned long long>(thread.lookups),
+        100.0 * thread.local_hits / thread.lookups,
+        static_cast<unsigned long long>(thread.inserts));
+  }
+}
+
+void SummarizeConfigFlagsCache(std::ostream& out) {
+  ConfigFlagsCache::Stats stats = ConfigFlagsCache::GetStats();
+  if (!stats.lookups)
+    return;
+  out << "Config flags cache: (lookups, hit rate, entries, size in KiB)\n";
+  out << base::StringPrintf(" %10llu  %5.1f%%  %zu  %.1f\n",
+                            static_cast<unsigned long long>(stats.lookups),
+                            100.0 * stats.hits / stats.lookups, stats.entries,
+                            stats.bytes / 1024.0);
+  out << std::endl;
+}
+
+void SummarizeOutputFiles(std::ostream& out) {
+  StringOutputBuffer::IoStats stats = StringOutputBuffer::GetIoStats();
+  if (!stats.files_written && !stats.files_compared && !stats.files_hashed)
+    return;
+  out << "Output files: (operation, files, KiB)\n";
+  auto write_line = [&out](const char* operation, uint64_t files,
+                           uint64_t bytes) {
+    out << base::StringPrintf(" %-17s %8llu  %10.1f\n", operation,
+                              static_cast<unsigned long long>(files),
+                              bytes / 1024.0);
+  };
+  write_line("written", stats.files_written, stats.bytes_written);
+  write_line("read back", stats.files_compared, stats.bytes_compared);
+  write_line("hashed", stats.files_hashed, stats.bytes_hashed);
+  out << base::StringPrintf(
+      " %-17s %8llu\n", "unchanged by hash",
+      static_cast<unsigned long long>(stats.files_hash_matched));
+  out << base::StringPrintf(
+      " %-17s %8llu\n", "directories made",
+      static_cast<unsigned long long>(stats.directories_made));
+  out << std::endl;
+}
+
 }  // namespace
 
 TraceItem::TraceItem(Type type,
@@ -231,6 +288,11 @@ std::string SummarizeTraces() {
   out << std::endl;
   SummarizeScriptExecs(script_execs, out);
   out << std::endl;
+  SummarizeStringAtoms(out);
+  out << std::endl;
+  SummarizeConfigFlagsCache(out);
+
+  SummarizeOutputFiles(out);
 
   // Generally there will only be one header check, but it's theoretically
   // possible for more than one to run if more than one build is going in
@@ -5,7 +5,10 @@
 #include "gn/visibility.h"
 
 #include <memory>
+#include <mutex>
 #include <string_view>
+#include <unordered_map>
+#include <utility>
 
 #include "base/strings/string_util.h"
 #include "base/values.h"
@@ -13,11 +16,76 @@
 #include "gn/filesystem_utils.h"
 #include "gn/item.h"
 #include "gn/label.h"
+#include "gn/label_pattern_set.h"
 #include "gn/scope.h"
 #include "gn/value.h"
 #include "gn/variables.h"
 
-Visibility::Visibility() = default;
+namespace {
+
+struct PatternsHash {
+  size_t operator()(const std::vector<LabelPattern>& patterns) const {
+    size_t result = patterns.size();
+    for (const LabelPattern& pattern : patterns)
+      result = result * 131 + pattern.hash();
+    return result;
+  }
+};
+
+}  // namespace
+
+// Visibility is checked for every dependency and config of every target, and
+// most items get their list from a few templates. So lists are interned as
+// written (which keeps them in order for "gn desc"), and each one is compiled
+// once into a LabelPatternSet. Matching a label then takes a few hash lookups
+// and never locks, since the set isn't modified once built.
+class Visibility::Rules {
+ public:
+  explicit Rules(std::vector<LabelPattern> patterns)
+      : patterns_(std::move(patterns)) {
+    for (const LabelPattern& pattern : patterns_) {
+      if (pattern.toolchain().is_null() &&
+          pattern.type() == LabelPattern::RECURSIVE_DIRECTORY &&
+          pattern.dir().value().empty())
+        is_public_ = true;
+      compiled_patterns_.Add(pattern);
+    }
+  }
+
+  const std::vector<LabelPattern>& patterns() const { return patterns_; }
+
+  bool Matches(const Label& label) const {
+    return is_public_ || compiled_patterns_.Matches(label);
+  }
+
+ private:
+  const std::vector<LabelPattern> patterns_;
+  bool is_public_ = false;
+  LabelPatternSet compiled_patterns_;
+
+  Rules(const Rules&) = delete;
+  Rules& operator=(const Rules&) = delete;
+};
+
+// static
+const Visibility::Rules* Visibility::Intern(
+    std::vector<LabelPattern> patterns) {
+  static std::mutex lock;
+  static auto* all_rules = new std::unordered_map<std::vector<LabelPattern>,
+                                                  std::unique_ptr<Rules>,
+                                                  PatternsHash>();
+
+  std::lock_guard<std::mutex> guard(lock);
+  std::unique_ptr<Rules>& rules = (*all_rules)[patterns];
+  if (!rules)
+    rules = std::make_unique<Rules>(std::move(patterns));
+  return rules.get();
+}
+
+Visibility::Visibility() {
+  static const Rules* empty_rules = Intern(std::vector<LabelPattern>());
+  rules_ = empty_rules;
+}
 
 Visibility::~Visibility() = default;
 
@@ -25,42 +93,43 @@ bool Visibility::Set(const SourceDir& current_dir,
                      std::string_view source_root,
                      const Value& value,
                      Err* err) {
-  patterns_.clear();
-
   if (!value.VerifyTypeIs(Value::LIST, err)) {
     CHECK(err->has_error());
     return false;
   }
 
+  std::vector<LabelPattern> patterns;
   for (const auto& item : value.list_value()) {
-    patterns_.push_back(
+    patterns.push_back(
         LabelPattern::GetPattern(current_dir, source_root, item, err));
     if (err->has_error())
       return false;
   }
+  rules_ = Intern(std::move(patterns));
   return true;
 }
 
 void Visibility::SetPublic() {
-  patterns_.clear();
-  patterns_.push_back(LabelPattern(LabelPattern::RECURSIVE_DIRECTORY,
-                                   SourceDir(), std::string(), Label()));
+  static const Rules* public_rules =
+      Intern({LabelPattern(LabelPattern::RECURSIVE_DIRECTORY, SourceDir(),
+                           std::string(), Label())});
+  rules_ = public_rules;
 }
 
 void Visibility::SetPrivate(const SourceDir& current_dir) {
-  patterns_.clear();
-  patterns_.push_back(LabelPattern(LabelPattern::DIRECTORY, current_dir,
-                                   std::string(), Label()));
+  rules_ = Intern({LabelPattern(LabelPattern::DIRECTORY, current_dir,
+                                std::string(), Label())});
 }
 
 bool Visibility::CanSeeMe(const Label& label) const {
-  return LabelPattern::VectorMatches(patterns_, label);
+  return rules_->Matches(label);
 }
 
 std::string Visibility::Describe(int indent, bool include_brackets) const {
   std::string outer_indent_string(indent, ' ');
 
-  if (patterns_.empty())
+  const std::vector<LabelPattern>& patterns = rules_->patterns();
+  if (patterns.empty())
     return outer_indent_string + "[] (no visibility)\n";
 
   std::string result;
@@ -72,7 +141,7 @@ std::string Visibility::Describe(int indent, bool include_brackets) const {
     inner_indent_string += "  ";
   }
 
-  for (const auto& pattern : patterns_)
+  for (const auto& pattern : patterns)
     result += inner_indent_string + pattern.Describe() + "\n";
 
   if (include_brackets)
@@ -82,11 +151,15 @@ std::string Visibility::Describe(int indent, bool include_brackets) const {
 
 std::unique_ptr<base::Value> Visibility::AsValue() const {
   auto res = std::make_unique<base::ListValue>();
-  for (const auto& pattern : patterns_)
+  for (const auto& pattern : rules_->patterns())
     res->AppendString(pattern.Describe());
   return res;
 }
 
+const std::vector<LabelPattern>& Visibility::patterns() const {
+  return rules_->patterns();
+}
+
 // static
 bool Visibility::CheckItemVisibility(const Item* from,
                                      const Item* to,
@@ -54,6 +54,9 @@ class Visibility {
   // Returns value representation of this visibility
   std::unique_ptr<base::Value> AsValue() const;
 
+  // The patterns of the list. Items with the same list share them.
+  const std::vector<LabelPattern>& patterns() const;
+
   // Helper function to check visibility between the given two items. If
   // to is invisible to from, returns false and sets the error.
   static bool CheckItemVisibility(const Item* from, const Item* to, Err* err);
@@ -63,7 +66,14 @@ class Visibility {
   static bool FillItemVisibility(Item* item, Scope* scope, Err* err);
 
  private:
-  std::vector<LabelPattern> patterns_;
+  // An interned visibility list, along with the results of matching it.
+  class Rules;
+
+  // Returns the rules for |patterns|, which are the same for equal lists.
+  static const Rules* Intern(std::vector<LabelPattern> patterns);
+
+  // Never null. Not owned, interned rules live until the process exits.
+  const Rules* rules_;
 
   Visibility(const Visibility&) = delete;
   Visibility& operator=(const Visibility&) = delete;
@@ -69,3 +69,37 @@ TEST(Visibility, AboveSourceDir) {
   EXPECT_TRUE(vis.CanSeeMe(Label(SourceDir("/foo/bar/"), "bar")));
   EXPECT_FALSE(vis.CanSeeMe(Label(SourceDir("/nowhere/"), "foo")));
 }
+
+TEST(Visibility, SharedRules) {
+  Value list(nullptr, Value::LIST);
+  list.list_value().push_back(Value(nullptr, "//rec/*"));
+  list.list_value().push_back(Value(nullptr, "//my:name"));
+  list.list_value().push_back(Value(nullptr, "//tc:*(//toolchain:other)"));
+
+  Err err;
+  Visibility a;
+  Visibility b;
+  ASSERT_TRUE(a.Set(SourceDir("//"), std::string_view(), list, &err));
+  ASSERT_TRUE(b.Set(SourceDir("//"), std::string_view(), list, &err));
+  EXPECT_EQ(&a.patterns(), &b.patterns());
+  EXPECT_EQ(3u, a.patterns().size());
+
+  Visibility private_vis;
+  private_vis.SetPrivate(SourceDir("//rec/"));
+  EXPECT_NE(&a.patterns(), &private_vis.patterns());
+
+  // The shared rules give the same results every time, and the patterns with
+  // a name or a toolchain only match the labels that have them.
+  Label other_tc(SourceDir("//tc/"), "x", SourceDir("//toolchain/"), "other");
+  Label default_tc(SourceDir("//tc/"), "x", SourceDir("//toolchain/"),
+                   "default");
+  for (int i = 0; i < 2; i++) {
+    EXPECT_TRUE(a.CanSeeMe(Label(SourceDir("//rec/a/"), "anything")));
+    EXPECT_FALSE(b.CanSeeMe(Label(SourceDir("//my/"), "notname")));
+    EXPECT_TRUE(b.CanSeeMe(Label(SourceDir("//my/"), "name")));
+    EXPECT_TRUE(a.CanSeeMe(other_tc));
+    EXPECT_FALSE(a.CanSeeMe(default_tc));
+    EXPECT_TRUE(private_vis.CanSeeMe(Label(SourceDir("//rec/"), "x")));
+    EXPECT_FALSE(private_vis.CanSeeMe(Label(SourceDir("//rec/a/"), "x")));
+  }
+}